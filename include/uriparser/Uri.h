@@ -202,6 +202,41 @@ typedef struct URI_TYPE(QueryListStruct) {
 
 
 
+/**
+ * Base %URI prepared by uriCreatePrecompiledBaseA so that
+ * uriRemovePrecompiledBaseToStringA can relativize many URIs against it
+ * quickly. It refers to, but does not own, the base %URI it was
+ * created from; that %URI must stay alive and unchanged while in use.
+ *
+ * @see uriCreatePrecompiledBaseA
+ * @since 0.9.5
+ */
+typedef struct URI_TYPE(PrecompiledBaseStruct) URI_TYPE(PrecompiledBase);
+
+
+
+/**
+ * Walks the path segments of a %URI in either direction without
+ * depending on how they are stored, e.g. works for a path kept unsplit
+ * by uriParseSingleUriLazyExMmA as well. All members are private.
+ *
+ * @see uriPathIteratorBeginA
+ * @see uriPathIteratorBeginReverseA
+ * @since 0.9.5
+ */
+typedef struct URI_TYPE(PathIteratorStruct) {
+	const URI_TYPE(PathSegment) * head; /**< Private */
+	const URI_TYPE(PathSegment) * node; /**< Private */
+	const URI_CHAR * first; /**< Private */
+	const URI_CHAR * read; /**< Private */
+	const URI_CHAR * afterLast; /**< Private */
+	URI_TYPE(TextRange) segment; /**< Private */
+	UriBool lazy; /**< Private */
+	UriBool done; /**< Private */
+} URI_TYPE(PathIterator); /**< @copydoc UriPathIteratorStructA */
+
+
+
 /**
  * Parses a RFC 3986 %URI.
  * Uses default libc-based memory manager.
@@ -317,6 +352,260 @@ URI_PUBLIC int URI_FUNC(ParseSingleUriExMm)(URI_TYPE(Uri) * uri,
 
 
 
+/**
+ * Parses a single RFC 3986 %URI like uriParseSingleUriExMmA but
+ * without splitting the path into segments. The path is validated as
+ * usual, yet kept as a single node at <c>pathHead</c> (and
+ * <c>pathTail</c>) whose text covers the whole path, slashes included.
+ * This saves one allocation per path segment for callers that only
+ * look at other components.
+ *
+ * uriToStringA and uriFreeUriMembersMmA handle such a %URI as is and
+ * uriNormalizeSyntaxExMmA splits the path by itself; before passing the
+ * %URI to any other function reading the path, call
+ * uriMaterializePathMmA.
+ *
+ * @param uri         <b>OUT</b>: Output %URI, must not be NULL
+ * @param first       <b>IN</b>: Pointer to the first character to parse,
+ *                               must not be NULL
+ * @param afterLast   <b>IN</b>: Pointer to the character after the last to
+ *                               parse, must not be NULL
+ * @param errorPos    <b>OUT</b>: Pointer to a pointer to the first character
+ *                                causing a syntax error, can be NULL;
+ *                                only set when URI_ERROR_SYNTAX was returned
+ * @param memory      <b>IN</b>: Memory manager to use, NULL for default libc
+ * @return            0 on success, error code otherwise
+ *
+ * @see uriMaterializePathMmA
+ * @see uriParseSingleUriExMmA
+ * @since 0.9.5
+ */
+URI_PUBLIC int URI_FUNC(ParseSingleUriLazyExMm)(URI_TYPE(Uri) * uri,
+		const URI_CHAR * first, const URI_CHAR * afterLast,
+		const URI_CHAR ** errorPos, UriMemoryManager * memory);
+
+
+
+/**
+ * Splits the path of a %URI parsed by uriParseSingleUriLazyExMmA into
+ * regular path segments, as uriParseSingleUriExMmA would have produced
+ * them. Does nothing for a %URI whose path is split already, so it is
+ * safe to call on any %URI. On failure the %URI is left unchanged.
+ *
+ * @param uri      <b>INOUT</b>: %URI to split the path of
+ * @param memory   <b>IN</b>: Memory manager to use, NULL for default libc;
+ *                            must be the one the %URI was parsed with
+ * @return         Error code or 0 on success
+ *
+ * @see uriParseSingleUriLazyExMmA
+ * @since 0.9.5
+ */
+URI_PUBLIC int URI_FUNC(MaterializePathMm)(URI_TYPE(Uri) * uri,
+		UriMemoryManager * memory);
+
+
+
+/**
+ * Starts walking the path segments of a %URI from first to last.
+ * The %URI must not be modified while being walked.
+ *
+ * EXAMPLE
+ *   UriPathIteratorA iterator;
+ *   const UriTextRangeA * segment;
+ *   uriPathIteratorBeginA(&iterator, &uri);
+ *   while ((segment = uriPathIteratorNextA(&iterator)) != NULL) {
+ *     ...
+ *   }
+ *
+ * @param iterator   <b>OUT</b>: Iterator to initialize
+ * @param uri        <b>IN</b>: %URI to walk the path of, can be NULL
+ *
+ * @see uriPathIteratorNextA
+ * @see uriPathIteratorBeginReverseA
+ * @since 0.9.5
+ */
+URI_PUBLIC void URI_FUNC(PathIteratorBegin)(URI_TYPE(PathIterator) * iterator,
+		const URI_TYPE(Uri) * uri);
+
+
+
+/**
+ * Returns the next path segment of a walk started with
+ * uriPathIteratorBeginA. The range returned stays valid
+ * until the iterator is advanced again.
+ *
+ * @param iterator   <b>INOUT</b>: Iterator to advance
+ * @return           Next segment or NULL past the last one
+ *
+ * @see uriPathIteratorBeginA
+ * @since 0.9.5
+ */
+URI_PUBLIC const URI_TYPE(TextRange) * URI_FUNC(PathIteratorNext)(
+		URI_TYPE(PathIterator) * iterator);
+
+
+
+/**
+ * Starts walking the path segments of a %URI from last to first.
+ * Stepping back is cheap for paths parsed by uriParseSingleUriLazyExMmA
+ * but takes time linear in the position for split paths, since
+ * segments are singly linked.
+ *
+ * @param iterator   <b>OUT</b>: Iterator to initialize
+ * @param uri        <b>IN</b>: %URI to walk the path of, can be NULL
+ *
+ * @see uriPathIteratorPrevA
+ * @see uriPathIteratorBeginA
+ * @since 0.9.5
+ */
+URI_PUBLIC void URI_FUNC(PathIteratorBeginReverse)(
+		URI_TYPE(PathIterator) * iterator, const URI_TYPE(Uri) * uri);
+
+
+
+/**
+ * Returns the previous path segment of a walk started with
+ * uriPathIteratorBeginReverseA. The range returned stays valid
+ * until the iterator is advanced again.
+ *
+ * @param iterator   <b>INOUT</b>: Iterator to advance
+ * @return           Previous segment or NULL before the first one
+ *
+ * @see uriPathIteratorBeginReverseA
+ * @since 0.9.5
+ */
+URI_PUBLIC const URI_TYPE(TextRange) * URI_FUNC(PathIteratorPrev)(
+		URI_TYPE(PathIterator) * iterator);
+
+
+
+/**
+ * Counts the path segments of a %URI.
+ *
+ * @param uri     <b>IN</b>: %URI to inspect
+ * @param count   <b>OUT</b>: Number of path segments
+ * @return        Error code or 0 on success
+ *
+ * @see uriGetPathSegmentA
+ * @since 0.9.5
+ */
+URI_PUBLIC int URI_FUNC(GetPathSegmentCount)(const URI_TYPE(Uri) * uri,
+		int * count);
+
+
+
+/**
+ * Retrieves the path segment at the given zero-based position.
+ *
+ * @param uri       <b>IN</b>: %URI to inspect
+ * @param index     <b>IN</b>: Position of the segment, starting at 0
+ * @param segment   <b>OUT</b>: Text of the segment
+ * @return          Error code or 0 on success,
+ *                  URI_ERROR_RANGE_INVALID for a position out of range
+ *
+ * @see uriGetPathSegmentCountA
+ * @since 0.9.5
+ */
+URI_PUBLIC int URI_FUNC(GetPathSegment)(const URI_TYPE(Uri) * uri,
+		int index, URI_TYPE(TextRange) * segment);
+
+
+
+/**
+ * Parses a single RFC 3986 %URI using a parser context.
+ * Unlike uriParseSingleUriExMmA the memory manager is not
+ * checked again, and memory freed by earlier %URIs of the same
+ * context is reused. The result must be freed using
+ * uriFreeUriMembersContextA with the same context.
+ *
+ * @param uri         <b>OUT</b>: Output %URI, must not be NULL
+ * @param first       <b>IN</b>: Pointer to the first character to parse,
+ *                               must not be NULL
+ * @param afterLast   <b>IN</b>: Pointer to the character after the last to
+ *                               parse, can be NULL
+ *                               (to use first + strlen(first))
+ * @param errorPos    <b>OUT</b>: Pointer to a pointer to the first character
+ *                                causing a syntax error, can be NULL;
+ *                                only set when URI_ERROR_SYNTAX was returned
+ * @param context     <b>INOUT</b>: Parser context to use, must not be NULL
+ * @return            0 on success, error code otherwise
+ *
+ * @see uriCreateParserContext
+ * @see uriFreeUriMembersContextA
+ * @see uriParseSingleUriExMmA
+ * @since 0.9.5
+ */
+URI_PUBLIC int URI_FUNC(ParseSingleUriContext)(URI_TYPE(Uri) * uri,
+		const URI_CHAR * first, const URI_CHAR * afterLast,
+		const URI_CHAR ** errorPos, UriParserContext * context);
+
+
+
+/**
+ * Converts an IPv6 text representation (RFC 3986 <c>IPv6address</c>,
+ * without surrounding brackets) into 16 bytes, e.g. "::1" or
+ * "2001:db8::192.0.2.1". Neither memory is allocated nor is any
+ * parser state needed.
+ *
+ * @param octetOutput  <b>OUT</b>: Output destination, room for 16 bytes
+ * @param first        <b>IN</b>: First character of IPv6 text to parse
+ * @param afterLast    <b>IN</b>: Position to stop parsing at
+ * @return Error code or 0 on success
+ *
+ * @see uriParseIpFourAddressA
+ * @since 0.9.5
+ */
+URI_PUBLIC int URI_FUNC(ParseIpSixAddress)(unsigned char * octetOutput,
+		const URI_CHAR * first, const URI_CHAR * afterLast);
+
+
+
+/**
+ * Returns the port of a %URI as a number, taken from <c>portText</c>
+ * with leading zeros allowed.  Without a port (or with an empty one),
+ * the default port of the scheme is returned if asked for, e.g. 443
+ * for <c>https</c>, or -1 otherwise.  Ports beyond 65535 give -1
+ * and clear <c>valid</c>, so callers need no overflow checks of
+ * their own.
+ *
+ * @param uri         <b>IN</b>: %URI to inspect
+ * @param useDefault  <b>IN</b>: Whether to fall back to the default port of the scheme
+ * @param port        <b>OUT</b>: Port number or -1 for none
+ * @param valid       <b>OUT</b>: <c>URI_FALSE</c> for a port beyond 65535, <c>URI_TRUE</c> otherwise, can be NULL
+ * @return            Error code or 0 on success
+ *
+ * @see uriGetSchemeIdA
+ * @since 0.9.5
+ */
+URI_PUBLIC int URI_FUNC(GetPort)(const URI_TYPE(Uri) * uri,
+		UriBool useDefault, int * port, UriBool * valid);
+
+
+
+/**
+ * Writes the canonical text representation of an IPv6 address
+ * as recommended by RFC 5952, e.g. "2001:db8::1" or "::ffff:192.0.2.1":
+ * hex digits are lowercase and without leading zeros, and the longest
+ * run of two or more zero groups is replaced by "::".
+ * A buffer of 40 characters is always large enough.
+ * uriNormalizeSyntaxExA rewrites IPv6 host text to this form
+ * with <c>URI_NORMALIZE_IP6</c>.
+ *
+ * @param dest           <b>OUT</b>: Output destination
+ * @param octets         <b>IN</b>: The 16 bytes of the address, e.g. <c>hostData.ip6->data</c>
+ * @param maxChars       <b>IN</b>: Maximum number of characters to copy <b>including</b> terminator
+ * @param charsWritten   <b>OUT</b>: Number of characters written including terminator, can be NULL
+ * @return               Error code or 0 on success, <c>URI_ERROR_OUTPUT_TOO_LARGE</c> if the text does not fit
+ *
+ * @see uriParseIpSixAddressA
+ * @see uriNormalizeSyntaxExA
+ * @since 0.9.5
+ */
+URI_PUBLIC int URI_FUNC(ToStringIpSixAddress)(URI_CHAR * dest,
+		const unsigned char * octets, int maxChars, int * charsWritten);
+
+
+
 /**
  * Frees all memory associated with the members
  * of the %URI structure. Note that the structure
@@ -349,6 +638,24 @@ URI_PUBLIC int URI_FUNC(FreeUriMembersMm)(URI_TYPE(Uri) * uri,
 
 
 
+/**
+ * Frees all memory associated with the members
+ * of a %URI parsed by uriParseSingleUriContextA.
+ * Small blocks are kept by the context for reuse.
+ *
+ * @param uri      <b>INOUT</b>: %URI structure whose members should be freed
+ * @param context  <b>INOUT</b>: Parser context the %URI was parsed with
+ * @return         0 on success, error code otherwise
+ *
+ * @see uriParseSingleUriContextA
+ * @see uriFreeParserContext
+ * @since 0.9.5
+ */
+URI_PUBLIC int URI_FUNC(FreeUriMembersContext)(URI_TYPE(Uri) * uri,
+		UriParserContext * context);
+
+
+
 /**
  * Percent-encodes all unreserved characters from the input string and
  * writes the encoded version to the output string.
@@ -374,6 +681,57 @@ URI_PUBLIC URI_CHAR * URI_FUNC(EscapeEx)(const URI_CHAR * inFirst,
 
 
 
+/**
+ * Calculates the exact number of characters uriEscapeExA would write
+ * for the given input <b>excluding</b> the terminator.
+ * Like uriEscapeExA, reading stops at <c>inAfterLast</c> or the first
+ * zero character, whichever comes first.
+ *
+ * @param inFirst           <b>IN</b>: Pointer to first character of the input text
+ * @param inAfterLast       <b>IN</b>: Pointer after the last character of the input text, can be NULL
+ * @param spaceToPlus       <b>IN</b>: Whether to convert ' ' to '+' or not
+ * @param normalizeBreaks   <b>IN</b>: Whether to convert CR and LF to CR-LF or not.
+ * @param charsRequired     <b>OUT</b>: Length of the escaped text in characters <b>excluding</b> terminator
+ * @return                  Error code or 0 on success
+ *
+ * @see uriEscapeExA
+ * @see uriEscapeBoundedA
+ * @since 0.9.5
+ */
+URI_PUBLIC int URI_FUNC(EscapeCharsRequired)(const URI_CHAR * inFirst,
+		const URI_CHAR * inAfterLast, UriBool spaceToPlus,
+		UriBool normalizeBreaks, int * charsRequired);
+
+
+
+/**
+ * Percent-encodes text like uriEscapeExA but never writes more than
+ * <c>maxChars</c> characters to <c>dest</c>. If the escaped text does
+ * not fit, <c>dest</c> is set to the empty string and
+ * <c>URI_ERROR_OUTPUT_TOO_LARGE</c> is returned; <c>charsRequired</c>
+ * then tells how much room (without terminator) a retry needs.
+ *
+ * @param dest              <b>OUT</b>: Encoded text destination
+ * @param inFirst           <b>IN</b>: Pointer to first character of the input text
+ * @param inAfterLast       <b>IN</b>: Pointer after the last character of the input text, can be NULL
+ * @param maxChars          <b>IN</b>: Maximum number of characters to write <b>including</b> terminator
+ * @param charsWritten      <b>OUT</b>: Number of characters written, can be lower than maxChars even if the output is too large, can be NULL
+ * @param charsRequired     <b>OUT</b>: Length of the escaped text in characters <b>excluding</b> terminator, can be NULL
+ * @param spaceToPlus       <b>IN</b>: Whether to convert ' ' to '+' or not
+ * @param normalizeBreaks   <b>IN</b>: Whether to convert CR and LF to CR-LF or not.
+ * @return                  Error code or 0 on success
+ *
+ * @see uriEscapeCharsRequiredA
+ * @see uriEscapeExA
+ * @since 0.9.5
+ */
+URI_PUBLIC int URI_FUNC(EscapeBounded)(URI_CHAR * dest,
+		const URI_CHAR * inFirst, const URI_CHAR * inAfterLast,
+		int maxChars, int * charsWritten, int * charsRequired,
+		UriBool spaceToPlus, UriBool normalizeBreaks);
+
+
+
 /**
  * Percent-encodes all unreserved characters from the input string and
  * writes the encoded version to the output string.
@@ -419,6 +777,28 @@ URI_PUBLIC const URI_CHAR * URI_FUNC(UnescapeInPlaceEx)(URI_CHAR * inout,
 
 
 
+/**
+ * Unescapes percent-encoded groups in a given range of text,
+ * in place, just like uriUnescapeInPlaceExA but without need
+ * for a terminator: none is searched for and none is written.
+ * Zero characters within the range are kept as they are.
+ *
+ * @param first             <b>INOUT</b>: First character of the text to unescape/decode
+ * @param afterLast         <b>IN</b>: Character after the last of the text
+ * @param plusToSpace       <b>IN</b>: Whether to convert '+' to ' ' or not
+ * @param breakConversion   <b>IN</b>: Line break conversion mode
+ * @return                  New end of the text or NULL on NULL input
+ *
+ * @see uriUnescapeInPlaceExA
+ * @see uriEscapeExA
+ * @since 0.9.5
+ */
+URI_PUBLIC const URI_CHAR * URI_FUNC(UnescapeRangeInPlace)(URI_CHAR * first,
+		const URI_CHAR * afterLast, UriBool plusToSpace,
+		UriBreakConversion breakConversion);
+
+
+
 /**
  * Unescapes percent-encoded groups in a given string.
  * E.g. "%20" will become " ". Unescaping is done in place.
@@ -571,6 +951,67 @@ URI_PUBLIC int URI_FUNC(RemoveBaseUriMm)(URI_TYPE(Uri) * dest,
 
 
 
+/**
+ * Prepares an absolute base %URI for repeated use with
+ * uriRemovePrecompiledBaseToStringA. The handle must be freed
+ * with uriFreePrecompiledBaseA.
+ *
+ * @param base      <b>OUT</b>: Destination for the new handle
+ * @param absBase   <b>IN</b>: Absolute base %URI, must outlive the handle
+ * @param memory    <b>IN</b>: Memory manager to use, NULL for default libc
+ * @return          Error code or 0 on success
+ *
+ * @see uriFreePrecompiledBaseA
+ * @see uriRemovePrecompiledBaseToStringA
+ * @since 0.9.5
+ */
+URI_PUBLIC int URI_FUNC(CreatePrecompiledBase)(
+		URI_TYPE(PrecompiledBase) ** base, const URI_TYPE(Uri) * absBase,
+		UriMemoryManager * memory);
+
+
+
+/**
+ * Frees a handle created by uriCreatePrecompiledBaseA.
+ * The base %URI itself is left untouched.
+ *
+ * @param base   <b>INOUT</b>: Handle to free, can be NULL
+ *
+ * @see uriCreatePrecompiledBaseA
+ * @since 0.9.5
+ */
+URI_PUBLIC void URI_FUNC(FreePrecompiledBase)(
+		URI_TYPE(PrecompiledBase) * base);
+
+
+
+/**
+ * Writes the reference that uriRemoveBaseUriA would produce for
+ * <c>absoluteSource</c> and the precompiled base straight to a string,
+ * exactly as uriToStringA would write it. No memory is allocated:
+ * the base path is kept as an array and hosts of a different kind or
+ * length are told apart without comparing text.
+ *
+ * @param dest             <b>OUT</b>: Output destination
+ * @param base             <b>IN</b>: Precompiled base %URI
+ * @param absoluteSource   <b>IN</b>: Absolute source %URI
+ * @param domainRootMode   <b>IN</b>: Create %URI with path relative to domain root
+ * @param maxChars         <b>IN</b>: Maximum number of characters to copy <b>including</b> terminator
+ * @param charsWritten     <b>OUT</b>: Number of characters written, can be NULL
+ * @return                 Error code or 0 on success
+ *
+ * @see uriCreatePrecompiledBaseA
+ * @see uriRemoveBaseUriA
+ * @see uriToStringA
+ * @since 0.9.5
+ */
+URI_PUBLIC int URI_FUNC(RemovePrecompiledBaseToString)(URI_CHAR * dest,
+		const URI_TYPE(PrecompiledBase) * base,
+		const URI_TYPE(Uri) * absoluteSource, UriBool domainRootMode,
+		int maxChars, int * charsWritten);
+
+
+
 /**
  * Checks two URIs for equivalence. Comparison is done
  * the naive way, without prior normalization.
@@ -587,6 +1028,122 @@ URI_PUBLIC UriBool URI_FUNC(EqualsUri)(const URI_TYPE(Uri) * a,
 
 
 
+/**
+ * Checks two URIs for equivalence, comparing the components
+ * selected by <c>mask</c> as if both URIs had been normalized by
+ * uriNormalizeSyntaxExA with that mask before (see RFC 3986 section 6.2.2):
+ * case, percent-encoding and dot segments are taken care of on the fly,
+ * without modifying the URIs or allocating memory.
+ * With <c>URI_NORMALIZED</c> for a mask, this is equal to uriEqualsUriA.
+ * NOTE: Two <c>NULL</c> URIs are equal as well.
+ *
+ * @param a     <b>IN</b>: First %URI
+ * @param b     <b>IN</b>: Second %URI
+ * @param mask  <b>IN</b>: Components to compare as if normalized
+ * @return      <c>URI_TRUE</c> when equivalent, <c>URI_FAlSE</c> else
+ *
+ * @see uriEqualsUriA
+ * @see uriHashUriA
+ * @since 0.9.5
+ */
+URI_PUBLIC UriBool URI_FUNC(EqualsUriEx)(const URI_TYPE(Uri) * a,
+		const URI_TYPE(Uri) * b, unsigned int mask);
+
+
+
+/**
+ * Compares two URIs for ordering, e.g. for sorting or binary search.
+ * Components are compared in this order: scheme, host, port, user info,
+ * path (segment by segment), query, fragment.  Absent components go
+ * before present ones, text is compared character by character,
+ * IP addresses and ports are compared numerically and hosts
+ * of different type go in order: none, registered name,
+ * IPv4, IPv6, IPvFuture.  Components selected by <c>mask</c> are
+ * compared as if normalized, see uriEqualsUriExA.
+ * Zero is returned exactly when uriEqualsUriExA would return
+ * <c>URI_TRUE</c> for the same mask.
+ * NOTE: A <c>NULL</c> %URI goes before any other.
+ *
+ * @param a     <b>IN</b>: First %URI
+ * @param b     <b>IN</b>: Second %URI
+ * @param mask  <b>IN</b>: Components to compare as if normalized
+ * @return      Negative if <c>a</c> goes first, positive if <c>b</c> goes first, 0 when equivalent
+ *
+ * @see uriEqualsUriExA
+ * @see uriSortUrisA
+ * @since 0.9.5
+ */
+URI_PUBLIC int URI_FUNC(CompareUri)(const URI_TYPE(Uri) * a,
+		const URI_TYPE(Uri) * b, unsigned int mask);
+
+
+
+/**
+ * Sorts an array of %URI pointers in the order of uriCompareUriA.
+ * Sorting is stable, i.e. equivalent URIs keep their relative order.
+ * Uses a temporary buffer of <c>count</c> pointers.
+ *
+ * @param uris   <b>INOUT</b>: Array of %URI pointers to sort
+ * @param count  <b>IN</b>: Number of elements in the array
+ * @param mask   <b>IN</b>: Components to compare as if normalized
+ * @return       Error code or 0 on success
+ *
+ * @see uriCompareUriA
+ * @see uriSortUrisMmA
+ * @since 0.9.5
+ */
+URI_PUBLIC int URI_FUNC(SortUris)(URI_TYPE(Uri) ** uris, int count,
+		unsigned int mask);
+
+
+
+/**
+ * Sorts an array of %URI pointers in the order of uriCompareUriA.
+ * Sorting is stable, i.e. equivalent URIs keep their relative order.
+ * Uses a temporary buffer of <c>count</c> pointers.
+ *
+ * @param uris    <b>INOUT</b>: Array of %URI pointers to sort
+ * @param count   <b>IN</b>: Number of elements in the array
+ * @param mask    <b>IN</b>: Components to compare as if normalized
+ * @param memory  <b>IN</b>: Memory manager to use, NULL for default libc
+ * @return        Error code or 0 on success
+ *
+ * @see uriCompareUriA
+ * @see uriSortUrisA
+ * @since 0.9.5
+ */
+URI_PUBLIC int URI_FUNC(SortUrisMm)(URI_TYPE(Uri) ** uris, int count,
+		unsigned int mask, UriMemoryManager * memory);
+
+
+
+/**
+ * Computes a 128-bit hash of a %URI that is consistent with
+ * uriEqualsUriA and uriEqualsUriExA: URIs that are equal
+ * (with the same mask) produce equal hashes.
+ * Components selected by <c>mask</c> are hashed as if normalized by
+ * uriNormalizeSyntaxExA with that mask, without modifying the %URI or
+ * allocating memory, i.e. the hash equals the plain hash of the
+ * normalized %URI.
+ * Hashes of the ANSI and Unicode variants are the same for the same
+ * %URI, with ANSI text taken as UTF-8: wide characters are hashed
+ * in their UTF-8 encoding.
+ *
+ * @param uri   <b>IN</b>: %URI to hash
+ * @param mask  <b>IN</b>: Components to hash as if normalized, <c>URI_NORMALIZED</c> for none
+ * @param hash  <b>OUT</b>: Hash value
+ * @return      Error code or 0 on success
+ *
+ * @see uriEqualsUriA
+ * @see uriEqualsUriExA
+ * @see uriNormalizeSyntaxExA
+ * @since 0.9.5
+ */
+URI_PUBLIC int URI_FUNC(HashUri)(const URI_TYPE(Uri) * uri,
+		unsigned int mask, UriHash * hash);
+
+
+
 /**
  * Calculates the number of characters needed to store the
  * string representation of the given %URI excluding the
@@ -622,6 +1179,190 @@ URI_PUBLIC int URI_FUNC(ToString)(URI_CHAR * dest, const URI_TYPE(Uri) * uri,
 
 
 
+/**
+ * Calculates the number of characters needed to store the
+ * reverse host key of the given %URI excluding the terminator.
+ *
+ * @param uri             <b>IN</b>: %URI to measure
+ * @param charsRequired   <b>OUT</b>: Length of the key in characters <b>excluding</b> terminator
+ * @return                Error code or 0 on success
+ *
+ * @see uriToReverseHostKeyA
+ * @since 0.9.5
+ */
+URI_PUBLIC int URI_FUNC(ToReverseHostKeyCharsRequired)(
+		const URI_TYPE(Uri) * uri, int * charsRequired);
+
+
+
+/**
+ * Writes a key for the given %URI that has the labels of the host
+ * in reverse order, e.g. <c>com.example.www:443/path?query#https</c> for
+ * <c>https://www.example.com/path?query</c>, so that keys of all URIs of
+ * a domain sort next to each other.  The key is built as if the
+ * %URI was normalized: the host is lowercased, percent-encodings are
+ * normalized and dot segments are removed.  IPv4 and IPv6 addresses
+ * are written numerically without reversal, IPv6 addresses in the
+ * canonical form of uriToStringIpSixAddressA.  The port is written without
+ * leading zeros and the default port of schemes <c>ftp</c>, <c>http</c>,
+ * <c>https</c>, <c>ws</c> and <c>wss</c> is written if no port
+ * is given, so that explicit default ports make no difference.
+ * An empty path is written as <c>/</c> if there is a host.
+ * The lowercased scheme comes last, after a <c>#</c>, so that URIs
+ * with different schemes get different keys even if their ports match.
+ * User info and fragment are not part of the key.
+ *
+ * @param dest           <b>OUT</b>: Output destination
+ * @param uri            <b>IN</b>: %URI to write the key for
+ * @param maxChars       <b>IN</b>: Maximum number of characters to copy <b>including</b> terminator
+ * @param charsWritten   <b>OUT</b>: Number of characters written, can be lower than maxChars even if the key is too long!
+ * @return               Error code or 0 on success, <c>URI_ERROR_OUTPUT_TOO_LARGE</c> if the key does not fit
+ *
+ * @see uriToReverseHostKeyCharsRequiredA
+ * @since 0.9.5
+ */
+URI_PUBLIC int URI_FUNC(ToReverseHostKey)(URI_CHAR * dest,
+		const URI_TYPE(Uri) * uri, int maxChars, int * charsWritten);
+
+
+
+/**
+ * Tells what kind of host a %URI has.
+ *
+ * @param uri   <b>IN</b>: %URI to inspect
+ * @return      Kind of host, URI_HOST_NONE for a NULL %URI
+ *
+ * @see uriGetRegistrableDomainA
+ * @since 0.9.5
+ */
+URI_PUBLIC UriHostType URI_FUNC(GetHostType)(const URI_TYPE(Uri) * uri);
+
+
+
+/**
+ * Finds the public suffix (e.g. "co.uk") and the registrable domain,
+ * i.e. the public suffix plus one more label (e.g. "example.co.uk"),
+ * of the registered name host of a %URI.  The ranges returned point
+ * into <c>uri->hostText</c>, nothing is copied or allocated.
+ * Labels are matched as if normalized, i.e. case-insensitively and with
+ * percent-encodings decoded; non-ASCII rules match UTF-8.
+ * Lookup takes time linear in the number of labels of the host.
+ * If there is no registrable domain, e.g. for IP addresses, a
+ * host that is a public suffix itself or a host with empty labels,
+ * <c>registrableDomain</c> is set to a range of <c>NULL</c> pointers.
+ *
+ * @param uri                <b>IN</b>: %URI to inspect
+ * @param list               <b>IN</b>: Suffix list to use
+ * @param publicSuffix       <b>OUT</b>: Public suffix within the host, can be NULL
+ * @param registrableDomain  <b>OUT</b>: Registrable domain within the host
+ * @return                   Error code or 0 on success
+ *
+ * @see uriLoadSuffixList
+ * @see uriGetHostTypeA
+ * @since 0.9.5
+ */
+URI_PUBLIC int URI_FUNC(GetRegistrableDomain)(const URI_TYPE(Uri) * uri,
+		const UriSuffixList * list, URI_TYPE(TextRange) * publicSuffix,
+		URI_TYPE(TextRange) * registrableDomain);
+
+
+
+/**
+ * Converts a host to its ASCII form as in IDNA's ToASCII operation:
+ * labels with characters beyond ASCII are lowercased in their ASCII
+ * letters and written as <c>xn--</c> followed by their Punycode.
+ * Characters beyond ASCII can come raw (UTF-8 for <c>char</c>,
+ * UTF-16 or UTF-32 for <c>wchar_t</c>) or percent-encoded as UTF-8,
+ * e.g. from <c>hostText</c> of a parsed %URI.  Labels can also be
+ * separated by the ideographic (U+3002), fullwidth (U+FF0E) and
+ * halfwidth (U+FF61) full stop.  Other labels are copied as they are.
+ * No further Unicode mapping (nameprep, UTS #46) is applied.
+ *
+ * Hosts that are plain ASCII already are the common case: then
+ * nothing is written and <c>asciiHost</c> is set to the input range,
+ * so <c>dest</c> can be NULL.  Otherwise <c>asciiHost</c> is set to the
+ * zero-terminated text written to <c>dest</c>.
+ *
+ * @param dest       <b>OUT</b>: Output destination, can be NULL for ASCII hosts
+ * @param first      <b>IN</b>: First character of the host
+ * @param afterLast  <b>IN</b>: Character after the last of the host
+ * @param maxChars   <b>IN</b>: Maximum number of characters to copy <b>including</b> terminator
+ * @param asciiHost  <b>OUT</b>: Range of the ASCII host
+ * @return           Error code or 0 on success
+ *
+ * @see uriHostToUnicodeA
+ * @see uriPunycodeEncode
+ * @since 0.9.5
+ */
+URI_PUBLIC int URI_FUNC(HostToAscii)(URI_CHAR * dest, const URI_CHAR * first,
+		const URI_CHAR * afterLast, int maxChars,
+		URI_TYPE(TextRange) * asciiHost);
+
+
+
+/**
+ * Converts a host to its Unicode form as in IDNA's ToUnicode
+ * operation: labels starting with <c>xn--</c> are decoded from
+ * Punycode and written as UTF-8 for <c>char</c> and as UTF-16 or
+ * UTF-32 for <c>wchar_t</c>.  Other labels are copied as they are.
+ *
+ * Without such labels, nothing is written and <c>unicodeHost</c> is
+ * set to the input range, so <c>dest</c> can be NULL.  Otherwise
+ * <c>unicodeHost</c> is set to the zero-terminated text written
+ * to <c>dest</c>.
+ *
+ * @param dest         <b>OUT</b>: Output destination, can be NULL for hosts without <c>xn--</c> labels
+ * @param first        <b>IN</b>: First character of the host
+ * @param afterLast    <b>IN</b>: Character after the last of the host
+ * @param maxChars     <b>IN</b>: Maximum number of characters to copy <b>including</b> terminator
+ * @param unicodeHost  <b>OUT</b>: Range of the Unicode host
+ * @return             Error code or 0 on success
+ *
+ * @see uriHostToAsciiA
+ * @see uriPunycodeDecode
+ * @since 0.9.5
+ */
+URI_PUBLIC int URI_FUNC(HostToUnicode)(URI_CHAR * dest, const URI_CHAR * first,
+		const URI_CHAR * afterLast, int maxChars,
+		URI_TYPE(TextRange) * unicodeHost);
+
+
+
+/**
+ * Classifies the scheme of a %URI, case-insensitively, so that
+ * dispatching on the scheme becomes a switch over integers.  The
+ * scheme text is looked at once and compared with one candidate
+ * at most.
+ *
+ * @param uri   <b>IN</b>: %URI to inspect
+ * @return      Scheme identifier, URI_SCHEME_NONE for a NULL %URI
+ *
+ * @see uriGetSchemeIdExA
+ * @since 0.9.5
+ */
+URI_PUBLIC UriSchemeId URI_FUNC(GetSchemeId)(const URI_TYPE(Uri) * uri);
+
+
+
+/**
+ * Classifies the scheme of a %URI like uriGetSchemeIdA, with custom
+ * schemes on top: a scheme that is not well-known but equals (ignoring
+ * case) <c>customSchemes[i]</c> is identified as
+ * <c>URI_SCHEME_CUSTOM + i</c>.
+ *
+ * @param uri            <b>IN</b>: %URI to inspect
+ * @param customSchemes  <b>IN</b>: Names of custom schemes in lowercase, can be NULL
+ * @param customCount    <b>IN</b>: Number of custom schemes
+ * @return               Scheme identifier, URI_SCHEME_NONE for a NULL %URI
+ *
+ * @see uriGetSchemeIdA
+ * @since 0.9.5
+ */
+URI_PUBLIC int URI_FUNC(GetSchemeIdEx)(const URI_TYPE(Uri) * uri,
+		const char * const * customSchemes, int customCount);
+
+
+
 /**
  * Determines the components of a %URI that are not normalized.
  *
@@ -702,6 +1443,60 @@ URI_PUBLIC int URI_FUNC(NormalizeSyntaxExMm)(URI_TYPE(Uri) * uri,
 
 
 
+/**
+ * Normalizes a %URI using a normalization mask, including the
+ * scheme-based normalization of section 6.2.3 of RFC 3986 in the
+ * same pass: the profile matching the scheme decides about
+ * <c>URI_NORMALIZE_EMPTY_PATH</c>, <c>URI_NORMALIZE_EMPTY_QUERY</c>,
+ * <c>URI_NORMALIZE_LOCALHOST</c> and the default port removed with
+ * <c>URI_NORMALIZE_PORT</c>.  Other functions ignore these bits,
+ * e.g. <c>http://a:80</c> becomes <c>http://a/</c> only here.
+ *
+ * NOTE: If necessary the %URI becomes owner of all memory
+ * behind the text pointed to. Text is duplicated in that case.
+ * Uses default libc-based memory manager.
+ *
+ * @param uri           <b>INOUT</b>: %URI to normalize
+ * @param mask          <b>IN</b>: Normalization mask
+ * @param profiles      <b>IN</b>: Scheme profiles, NULL for the built-in ones
+ * @param profileCount  <b>IN</b>: Number of scheme profiles
+ * @return              Error code or 0 on success
+ *
+ * @see uriNormalizeSyntaxProfiledMmA
+ * @see uriGetDefaultSchemeProfiles
+ * @see uriNormalizeSyntaxExA
+ * @since 0.9.5
+ */
+URI_PUBLIC int URI_FUNC(NormalizeSyntaxProfiled)(URI_TYPE(Uri) * uri,
+		unsigned int mask, const UriSchemeProfile * profiles,
+		int profileCount);
+
+
+
+/**
+ * Normalizes a %URI using a normalization mask, including
+ * scheme-based normalization.
+ *
+ * NOTE: If necessary the %URI becomes owner of all memory
+ * behind the text pointed to. Text is duplicated in that case.
+ *
+ * @param uri           <b>INOUT</b>: %URI to normalize
+ * @param mask          <b>IN</b>: Normalization mask
+ * @param profiles      <b>IN</b>: Scheme profiles, NULL for the built-in ones
+ * @param profileCount  <b>IN</b>: Number of scheme profiles
+ * @param memory        <b>IN</b>: Memory manager to use, NULL for default libc
+ * @return              Error code or 0 on success
+ *
+ * @see uriNormalizeSyntaxProfiledA
+ * @see uriNormalizeSyntaxExMmA
+ * @since 0.9.5
+ */
+URI_PUBLIC int URI_FUNC(NormalizeSyntaxProfiledMm)(URI_TYPE(Uri) * uri,
+		unsigned int mask, const UriSchemeProfile * profiles,
+		int profileCount, UriMemoryManager * memory);
+
+
+
 /**
  * Normalizes all components of a %URI.
  *
@@ -744,6 +1539,71 @@ URI_PUBLIC int URI_FUNC(UnixFilenameToUriString)(const URI_CHAR * filename,
 
 
 
+/**
+ * Converts a Unix filename given as a range of text to a %URI string,
+ * just like uriUnixFilenameToUriStringA but without need for a terminator
+ * in the input. The output is zero-terminated and needs as much room.
+ *
+ * @param filenameFirst      <b>IN</b>: First character of the Unix filename
+ * @param filenameAfterLast  <b>IN</b>: Character after the last of the Unix filename
+ * @param uriString          <b>OUT</b>: Destination to write %URI string to
+ * @return                   Error code or 0 on success
+ *
+ * @see uriUnixFilenameToUriStringA
+ * @since 0.9.5
+ */
+URI_PUBLIC int URI_FUNC(UnixFilenameToUriStringEx)(
+		const URI_CHAR * filenameFirst, const URI_CHAR * filenameAfterLast,
+		URI_CHAR * uriString);
+
+
+
+/**
+ * Calculates the exact number of characters needed to store the %URI
+ * string for a Unix filename given as a range of text <b>excluding</b>
+ * the terminator.
+ *
+ * @param filenameFirst      <b>IN</b>: First character of the Unix filename
+ * @param filenameAfterLast  <b>IN</b>: Character after the last of the Unix filename
+ * @param charsRequired      <b>OUT</b>: Length of the %URI string in characters <b>excluding</b> terminator
+ * @return                   Error code or 0 on success
+ *
+ * @see uriUnixFilenameToUriStringBoundedA
+ * @since 0.9.5
+ */
+URI_PUBLIC int URI_FUNC(UnixFilenameToUriStringCharsRequired)(
+		const URI_CHAR * filenameFirst, const URI_CHAR * filenameAfterLast,
+		int * charsRequired);
+
+
+
+/**
+ * Converts a Unix filename given as a range of text to a %URI string
+ * like uriUnixFilenameToUriStringExA, but never writes more than
+ * <c>maxChars</c> characters. If the %URI string does not fit,
+ * <c>dest</c> is set to the empty string and
+ * <c>URI_ERROR_OUTPUT_TOO_LARGE</c> is returned with
+ * <c>charsRequired</c> telling how much room a retry needs.
+ *
+ * @param filenameFirst      <b>IN</b>: First character of the Unix filename
+ * @param filenameAfterLast  <b>IN</b>: Character after the last of the Unix filename
+ * @param dest               <b>OUT</b>: Destination to write %URI string to
+ * @param maxChars           <b>IN</b>: Maximum number of characters to write <b>including</b> terminator
+ * @param charsWritten       <b>OUT</b>: Number of characters written, can be NULL
+ * @param charsRequired      <b>OUT</b>: Length of the %URI string in characters <b>excluding</b> terminator, can be NULL
+ * @return                   Error code or 0 on success
+ *
+ * @see uriUnixFilenameToUriStringCharsRequiredA
+ * @see uriUnixFilenameToUriStringExA
+ * @since 0.9.5
+ */
+URI_PUBLIC int URI_FUNC(UnixFilenameToUriStringBounded)(
+		const URI_CHAR * filenameFirst, const URI_CHAR * filenameAfterLast,
+		URI_CHAR * dest, int maxChars, int * charsWritten,
+		int * charsRequired);
+
+
+
 /**
  * Converts a Windows filename to a %URI string.
  * The destination buffer must be large enough to hold 8 + 3 * len(filename) + 1
@@ -767,6 +1627,124 @@ URI_PUBLIC int URI_FUNC(WindowsFilenameToUriString)(const URI_CHAR * filename,
 
 
 
+/**
+ * Converts a Windows filename given as a range of text to a %URI string,
+ * just like uriWindowsFilenameToUriStringA but without need for a terminator
+ * in the input. The output is zero-terminated and needs as much room.
+ *
+ * @param filenameFirst      <b>IN</b>: First character of the Windows filename
+ * @param filenameAfterLast  <b>IN</b>: Character after the last of the Windows filename
+ * @param uriString          <b>OUT</b>: Destination to write %URI string to
+ * @return                   Error code or 0 on success
+ *
+ * @see uriWindowsFilenameToUriStringA
+ * @since 0.9.5
+ */
+URI_PUBLIC int URI_FUNC(WindowsFilenameToUriStringEx)(
+		const URI_CHAR * filenameFirst, const URI_CHAR * filenameAfterLast,
+		URI_CHAR * uriString);
+
+
+
+/**
+ * Calculates the exact number of characters needed to store the %URI
+ * string for a Windows filename given as a range of text <b>excluding</b>
+ * the terminator.
+ *
+ * @param filenameFirst      <b>IN</b>: First character of the Windows filename
+ * @param filenameAfterLast  <b>IN</b>: Character after the last of the Windows filename
+ * @param charsRequired      <b>OUT</b>: Length of the %URI string in characters <b>excluding</b> terminator
+ * @return                   Error code or 0 on success
+ *
+ * @see uriWindowsFilenameToUriStringBoundedA
+ * @since 0.9.5
+ */
+URI_PUBLIC int URI_FUNC(WindowsFilenameToUriStringCharsRequired)(
+		const URI_CHAR * filenameFirst, const URI_CHAR * filenameAfterLast,
+		int * charsRequired);
+
+
+
+/**
+ * Converts a Windows filename given as a range of text to a %URI string
+ * like uriWindowsFilenameToUriStringExA, but never writes more than
+ * <c>maxChars</c> characters. If the %URI string does not fit,
+ * <c>dest</c> is set to the empty string and
+ * <c>URI_ERROR_OUTPUT_TOO_LARGE</c> is returned with
+ * <c>charsRequired</c> telling how much room a retry needs.
+ *
+ * @param filenameFirst      <b>IN</b>: First character of the Windows filename
+ * @param filenameAfterLast  <b>IN</b>: Character after the last of the Windows filename
+ * @param dest               <b>OUT</b>: Destination to write %URI string to
+ * @param maxChars           <b>IN</b>: Maximum number of characters to write <b>including</b> terminator
+ * @param charsWritten       <b>OUT</b>: Number of characters written, can be NULL
+ * @param charsRequired      <b>OUT</b>: Length of the %URI string in characters <b>excluding</b> terminator, can be NULL
+ * @return                   Error code or 0 on success
+ *
+ * @see uriWindowsFilenameToUriStringCharsRequiredA
+ * @see uriWindowsFilenameToUriStringExA
+ * @since 0.9.5
+ */
+URI_PUBLIC int URI_FUNC(WindowsFilenameToUriStringBounded)(
+		const URI_CHAR * filenameFirst, const URI_CHAR * filenameAfterLast,
+		URI_CHAR * dest, int maxChars, int * charsWritten,
+		int * charsRequired);
+
+
+
+/**
+ * Converts many Unix filenames to %URI strings in one go, writing all
+ * results one after another into a single caller-provided arena.
+ * Consecutive filenames sharing leading directories (as produced by
+ * walking a directory tree) reuse the already converted form of that
+ * prefix rather than escaping it again, so sorted input is fastest.
+ *
+ * If the arena runs full, <c>URI_ERROR_OUTPUT_TOO_LARGE</c> is returned
+ * and <c>convertedCount</c> tells how many filenames were converted;
+ * the caller can consume those and continue with the rest.
+ *
+ * @param filenames       <b>IN</b>: Zero-terminated Unix filenames to convert
+ * @param filenameCount   <b>IN</b>: Number of filenames
+ * @param arena           <b>OUT</b>: Destination for all zero-terminated %URI strings
+ * @param arenaChars      <b>IN</b>: Size of the arena in characters
+ * @param uriStrings      <b>OUT</b>: Array of <c>filenameCount</c> pointers into the arena, one per filename
+ * @param convertedCount  <b>OUT</b>: Number of filenames converted, can be NULL
+ * @return                Error code or 0 on success
+ *
+ * @see uriUnixFilenameToUriStringA
+ * @see uriWindowsFilenamesToUriStringsA
+ * @since 0.9.5
+ */
+URI_PUBLIC int URI_FUNC(UnixFilenamesToUriStrings)(
+		const URI_CHAR * const * filenames, int filenameCount,
+		URI_CHAR * arena, int arenaChars, const URI_CHAR ** uriStrings,
+		int * convertedCount);
+
+
+
+/**
+ * Converts many Windows filenames to %URI strings in one go,
+ * just like uriUnixFilenamesToUriStringsA does for Unix filenames.
+ *
+ * @param filenames       <b>IN</b>: Zero-terminated Windows filenames to convert
+ * @param filenameCount   <b>IN</b>: Number of filenames
+ * @param arena           <b>OUT</b>: Destination for all zero-terminated %URI strings
+ * @param arenaChars      <b>IN</b>: Size of the arena in characters
+ * @param uriStrings      <b>OUT</b>: Array of <c>filenameCount</c> pointers into the arena, one per filename
+ * @param convertedCount  <b>OUT</b>: Number of filenames converted, can be NULL
+ * @return                Error code or 0 on success
+ *
+ * @see uriWindowsFilenameToUriStringA
+ * @see uriUnixFilenamesToUriStringsA
+ * @since 0.9.5
+ */
+URI_PUBLIC int URI_FUNC(WindowsFilenamesToUriStrings)(
+		const URI_CHAR * const * filenames, int filenameCount,
+		URI_CHAR * arena, int arenaChars, const URI_CHAR ** uriStrings,
+		int * convertedCount);
+
+
+
 /**
  * Extracts a Unix filename from a %URI string.
  * The destination buffer must be large enough to hold len(uriString) + 1 - 7
@@ -786,6 +1764,25 @@ URI_PUBLIC int URI_FUNC(UriStringToUnixFilename)(const URI_CHAR * uriString,
 
 
 
+/**
+ * Extracts a Unix filename from a %URI string given as a range of text,
+ * just like uriUriStringToUnixFilenameA but without need for a terminator
+ * in the input. The output is zero-terminated and needs as much room.
+ *
+ * @param uriStringFirst      <b>IN</b>: First character of the %URI string
+ * @param uriStringAfterLast  <b>IN</b>: Character after the last of the %URI string
+ * @param filename            <b>OUT</b>: Destination to write filename to
+ * @return                    Error code or 0 on success
+ *
+ * @see uriUriStringToUnixFilenameA
+ * @since 0.9.5
+ */
+URI_PUBLIC int URI_FUNC(UriStringToUnixFilenameEx)(
+		const URI_CHAR * uriStringFirst, const URI_CHAR * uriStringAfterLast,
+		URI_CHAR * filename);
+
+
+
 /**
  * Extracts a Windows filename from a %URI string.
  * The destination buffer must be large enough to hold len(uriString) + 1 - 5
@@ -805,6 +1802,25 @@ URI_PUBLIC int URI_FUNC(UriStringToWindowsFilename)(const URI_CHAR * uriString,
 
 
 
+/**
+ * Extracts a Windows filename from a %URI string given as a range of text,
+ * just like uriUriStringToWindowsFilenameA but without need for a terminator
+ * in the input. The output is zero-terminated and needs as much room.
+ *
+ * @param uriStringFirst      <b>IN</b>: First character of the %URI string
+ * @param uriStringAfterLast  <b>IN</b>: Character after the last of the %URI string
+ * @param filename            <b>OUT</b>: Destination to write filename to
+ * @return                    Error code or 0 on success
+ *
+ * @see uriUriStringToWindowsFilenameA
+ * @since 0.9.5
+ */
+URI_PUBLIC int URI_FUNC(UriStringToWindowsFilenameEx)(
+		const URI_CHAR * uriStringFirst, const URI_CHAR * uriStringAfterLast,
+		URI_CHAR * filename);
+
+
+
 /**
  * Calculates the number of characters needed to store the
  * string representation of the given query list excluding the
@@ -900,6 +1916,57 @@ URI_PUBLIC int URI_FUNC(ComposeQueryEx)(URI_CHAR * dest,
 
 
 
+/**
+ * Calculates the number of characters needed to store the
+ * query string composed from the given key and value ranges
+ * excluding the terminator, see uriComposeQueryRangesA.
+ *
+ * @param keys              <b>IN</b>: Array of itemCount keys
+ * @param values            <b>IN</b>: Array of itemCount values, can be NULL
+ * @param itemCount         <b>IN</b>: Number of items
+ * @param charsRequired     <b>OUT</b>: Length of the string representation in characters <b>excluding</b> terminator
+ * @param spaceToPlus       <b>IN</b>: Whether to convert ' ' to '+' or not
+ * @param normalizeBreaks   <b>IN</b>: Whether to convert CR and LF to CR-LF or not.
+ * @return                  Error code or 0 on success
+ *
+ * @see uriComposeQueryRangesA
+ * @since 0.9.5
+ */
+URI_PUBLIC int URI_FUNC(ComposeQueryRangesCharsRequired)(
+		const URI_TYPE(TextRange) * keys, const URI_TYPE(TextRange) * values,
+		int itemCount, int * charsRequired,
+		UriBool spaceToPlus, UriBool normalizeBreaks);
+
+
+
+/**
+ * Composes a query string from arrays of key and value ranges,
+ * just like uriComposeQueryExA does from a query list,
+ * but without need for zero-terminated keys and values.
+ * A value with <c>first</c> NULL, or all values if \p values
+ * is NULL, makes a key without "=" and value.
+ *
+ * @param dest              <b>OUT</b>: Output destination
+ * @param keys              <b>IN</b>: Array of itemCount keys
+ * @param values            <b>IN</b>: Array of itemCount values, can be NULL
+ * @param itemCount         <b>IN</b>: Number of items
+ * @param maxChars          <b>IN</b>: Maximum number of characters to copy <b>including</b> terminator
+ * @param charsWritten      <b>OUT</b>: Number of characters written, can be lower than maxChars even if the query is too long!
+ * @param spaceToPlus       <b>IN</b>: Whether to convert ' ' to '+' or not
+ * @param normalizeBreaks   <b>IN</b>: Whether to convert CR and LF to CR-LF or not.
+ * @return                  Error code or 0 on success
+ *
+ * @see uriComposeQueryRangesCharsRequiredA
+ * @see uriComposeQueryExA
+ * @since 0.9.5
+ */
+URI_PUBLIC int URI_FUNC(ComposeQueryRanges)(URI_CHAR * dest,
+		const URI_TYPE(TextRange) * keys, const URI_TYPE(TextRange) * values,
+		int itemCount, int maxChars, int * charsWritten,
+		UriBool spaceToPlus, UriBool normalizeBreaks);
+
+
+
 /**
  * Converts a query list structure back to a query string.
  * Memory for this string is allocated internally.
@@ -1114,6 +2181,116 @@ URI_PUBLIC int URI_FUNC(MakeOwnerMm)(URI_TYPE(Uri) * uri,
 
 
 
+/**
+ * Makes the %URI hold copies of strings so that it no longer depends
+ * on the original %URI string, just like uriMakeOwnerA does, but
+ * packs all text into a single contiguous block in %URI order.
+ * That takes a single allocation rather than one per component
+ * and makes uriFreeUriMembersA release all text with a single call.
+ * Text ranges of the %URI can be read and normalized as usual.
+ * If the %URI is already owner of copies, this function returns
+ * <c>URI_SUCCESS</c> and does not modify the %URI further.
+ *
+ * @param uri    <b>INOUT</b>: %URI to make independent
+ * @return       Error code or 0 on success
+ *
+ * @see uriMakeOwnerCompactMmA
+ * @see uriMakeOwnerA
+ * @since 0.9.5
+ */
+URI_PUBLIC int URI_FUNC(MakeOwnerCompact)(URI_TYPE(Uri) * uri);
+
+
+
+/**
+ * Makes the %URI hold copies of strings so that it no longer depends
+ * on the original %URI string, just like uriMakeOwnerMmA does, but
+ * packs all text into a single contiguous block in %URI order.
+ * If the %URI is already owner of copies, this function returns
+ * <c>URI_SUCCESS</c> and does not modify the %URI further.
+ *
+ * @param uri     <b>INOUT</b>: %URI to make independent
+ * @param memory  <b>IN</b>: Memory manager to use, NULL for default libc
+ * @return        Error code or 0 on success
+ *
+ * @see uriMakeOwnerCompactA
+ * @see uriMakeOwnerMmA
+ * @since 0.9.5
+ */
+URI_PUBLIC int URI_FUNC(MakeOwnerCompactMm)(URI_TYPE(Uri) * uri,
+                                            UriMemoryManager * memory);
+
+
+
+/**
+ * Determines the number of characters needed to convert UTF-16 text
+ * to a %URI string using uriUtf16ToUriStringA, excluding the terminator.
+ *
+ * @param first          <b>IN</b>: First code unit of the text
+ * @param afterLast      <b>IN</b>: Code unit after the last of the text
+ * @param charsRequired  <b>OUT</b>: Length of the %URI string
+ * @return               Error code or 0 on success
+ *
+ * @see uriUtf16ToUriStringA
+ * @since 0.9.5
+ */
+URI_PUBLIC int URI_FUNC(Utf16ToUriStringCharsRequired)(
+		const UriUtf16Char * first, const UriUtf16Char * afterLast,
+		int * charsRequired);
+
+
+
+/**
+ * Converts UTF-16 text, e.g. an IRI, to a %URI string as of
+ * RFC 3987 section 3.1: ASCII is copied as is and all other
+ * characters are percent-encoded as UTF-8, e.g. "ü" becomes "%C3%BC".
+ * Unpaired surrogates are rejected with <c>URI_ERROR_SYNTAX</c>.
+ * The result still needs parsing to be known valid.
+ *
+ * @param dest          <b>OUT</b>: Output destination
+ * @param first         <b>IN</b>: First code unit of the text
+ * @param afterLast     <b>IN</b>: Code unit after the last of the text
+ * @param maxChars      <b>IN</b>: Maximum number of characters to copy <b>including</b> terminator
+ * @param charsWritten  <b>OUT</b>: Number of characters written, can be lower than maxChars even if the string is too long!
+ * @return              Error code or 0 on success
+ *
+ * @see uriUtf16ToUriStringCharsRequiredA
+ * @see uriParseSingleUriUtf16MmA
+ * @since 0.9.5
+ */
+URI_PUBLIC int URI_FUNC(Utf16ToUriString)(URI_CHAR * dest,
+		const UriUtf16Char * first, const UriUtf16Char * afterLast,
+		int maxChars, int * charsWritten);
+
+
+
+/**
+ * Parses a single %URI from UTF-16 text without widening it
+ * to <c>wchar_t</c> first. The text is converted as by
+ * uriUtf16ToUriStringA, on the stack for short text, and the
+ * resulting %URI owns a copy of its text as by uriMakeOwnerCompactMmA.
+ * On syntax errors, \p errorPos points into the UTF-16 text.
+ *
+ * @param uri        <b>OUT</b>: Output %URI, must not be NULL
+ * @param first      <b>IN</b>: First code unit to parse, must not be NULL
+ * @param afterLast  <b>IN</b>: Code unit after the last to parse,
+ *                              can be NULL to parse up to a zero code unit
+ * @param errorPos   <b>OUT</b>: Pointer to a pointer to the first code unit
+ *                               causing a syntax error, can be NULL;
+ *                               only set when URI_ERROR_SYNTAX was returned
+ * @param memory     <b>IN</b>: Memory manager to use, NULL for default libc
+ * @return           0 on success, error code otherwise
+ *
+ * @see uriUtf16ToUriStringA
+ * @see uriFreeUriMembersMmA
+ * @since 0.9.5
+ */
+URI_PUBLIC int URI_FUNC(ParseSingleUriUtf16Mm)(URI_TYPE(Uri) * uri,
+		const UriUtf16Char * first, const UriUtf16Char * afterLast,
+		const UriUtf16Char ** errorPos, UriMemoryManager * memory);
+
+
+
 #ifdef __cplusplus
 }
 #endif
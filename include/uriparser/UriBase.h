@@ -179,6 +179,99 @@ typedef struct UriIp6Struct {
 } UriIp6; /**< @copydoc UriIp6Struct */
 
 
+
+/**
+ * Holds a 128-bit %URI hash as produced by uriHashUriA.
+ * Any 8 bytes of it make a fine 64-bit hash.
+ *
+ * @see uriHashUriA
+ * @since 0.9.5
+ */
+typedef struct UriHashStruct {
+	unsigned char data[16]; /**< Hash value, most significant byte first */
+} UriHash; /**< @copydoc UriHashStruct */
+
+
+
+/**
+ * Compiled Public Suffix List as loaded by uriLoadSuffixListA.
+ * The list is never modified after loading, so it can be
+ * shared by threads looking up domains concurrently.
+ *
+ * @see uriLoadSuffixListMm
+ * @see uriGetRegistrableDomainA
+ * @since 0.9.5
+ */
+typedef struct UriSuffixListStruct UriSuffixList;
+
+
+
+/**
+ * Parser context as created by uriCreateParserContext.
+ * A context keeps a validated memory manager and caches small
+ * blocks freed by one parse for reuse by the next.
+ * A context must not be used by more than one thread at a time;
+ * threads parsing concurrently should have a context each.
+ *
+ * @see uriCreateParserContext
+ * @see uriParseSingleUriContextA
+ * @since 0.9.5
+ */
+typedef struct UriParserContextStruct UriParserContext;
+
+
+
+/**
+ * Specifies the kind of host a %URI has.
+ *
+ * @see uriGetHostTypeA
+ * @since 0.9.5
+ */
+typedef enum UriHostTypeEnum {
+	URI_HOST_NONE, /**< No host at all */
+	URI_HOST_REGNAME, /**< Registered name, e.g. "www.example.com" */
+	URI_HOST_IP4, /**< IPv4 address */
+	URI_HOST_IP6, /**< IPv6 address */
+	URI_HOST_IP_FUTURE /**< IPvFuture address */
+} UriHostType; /**< @copydoc UriHostTypeEnum */
+
+
+
+/**
+ * Identifies well-known schemes, see uriGetSchemeIdA.
+ *
+ * @see uriGetSchemeIdA
+ * @see uriGetSchemeIdExA
+ * @since 0.9.5
+ */
+typedef enum UriSchemeIdEnum {
+	URI_SCHEME_NONE = 0, /**< No scheme at all, i.e. a relative reference */
+	URI_SCHEME_UNKNOWN, /**< Scheme other than the ones below */
+	URI_SCHEME_HTTP, /**< Scheme "http" */
+	URI_SCHEME_HTTPS, /**< Scheme "https" */
+	URI_SCHEME_WS, /**< Scheme "ws" */
+	URI_SCHEME_WSS, /**< Scheme "wss" */
+	URI_SCHEME_FTP, /**< Scheme "ftp" */
+	URI_SCHEME_FILE, /**< Scheme "file" */
+	URI_SCHEME_MAILTO, /**< Scheme "mailto" */
+	URI_SCHEME_DATA, /**< Scheme "data" */
+	URI_SCHEME_URN, /**< Scheme "urn" */
+	URI_SCHEME_CUSTOM = 256 /**< Identifier of the first custom scheme, see uriGetSchemeIdExA */
+} UriSchemeId; /**< @copydoc UriSchemeIdEnum */
+
+
+
+/**
+ * UTF-16 code unit, matching the layout of C11 <c>char16_t</c>
+ * and of <c>WCHAR</c> on Windows.
+ *
+ * @see uriParseSingleUriUtf16MmA
+ * @see uriUtf16ToUriStringA
+ * @since 0.9.5
+ */
+typedef unsigned short UriUtf16Char;
+
+
 struct UriMemoryManagerStruct;  /* foward declaration to break loop */
 
 
@@ -262,11 +355,45 @@ typedef enum UriNormalizationMaskEnum {
 	URI_NORMALIZE_HOST = 1 << 2, /**< Normalize host (fix uppercase letters) */
 	URI_NORMALIZE_PATH = 1 << 3, /**< Normalize path (fix uppercase percent-encodings and redundant dot segments) */
 	URI_NORMALIZE_QUERY = 1 << 4, /**< Normalize query (fix uppercase percent-encodings) */
-	URI_NORMALIZE_FRAGMENT = 1 << 5 /**< Normalize fragment (fix uppercase percent-encodings) */
+	URI_NORMALIZE_FRAGMENT = 1 << 5, /**< Normalize fragment (fix uppercase percent-encodings) */
+	URI_NORMALIZE_IP6 = 1 << 6, /**< [>=0.9.5] Normalize IPv6 host text (rewrite to canonical form of RFC 5952); only if asked for explicitly, not by uriNormalizeSyntaxA, masks like <c>(unsigned int)-1</c> or uriNormalizeSyntaxMaskRequiredA */
+	URI_NORMALIZE_PORT = 1 << 7, /**< [>=0.9.5] Remove empty port and default port of the scheme (scheme-based, see uriNormalizeSyntaxProfiledA) */
+	URI_NORMALIZE_EMPTY_PATH = 1 << 8, /**< [>=0.9.5] Write empty path as "/" if the scheme says so (scheme-based, see uriNormalizeSyntaxProfiledA) */
+	URI_NORMALIZE_EMPTY_QUERY = 1 << 9, /**< [>=0.9.5] Remove empty query if the scheme says so (scheme-based, see uriNormalizeSyntaxProfiledA) */
+	URI_NORMALIZE_LOCALHOST = 1 << 10 /**< [>=0.9.5] Rewrite host "localhost" to empty host if the scheme says so (scheme-based, see uriNormalizeSyntaxProfiledA) */
 } UriNormalizationMask; /**< @copydoc UriNormalizationMaskEnum */
 
 
 
+/**
+ * Specifies equivalences a scheme defines beyond generic syntax,
+ * see section 6.2.3 of RFC 3986.
+ *
+ * @since 0.9.5
+ */
+typedef enum UriSchemeProfileFlagsEnum {
+	URI_SCHEME_EMPTY_PATH_IS_SLASH = 1 << 0, /**< Empty path equals path "/" if there is a host, e.g. for http */
+	URI_SCHEME_EMPTY_QUERY_IS_NONE = 1 << 1, /**< Empty query equals no query, e.g. for http */
+	URI_SCHEME_LOCALHOST_IS_EMPTY = 1 << 2 /**< Host "localhost" equals empty host, e.g. for file */
+} UriSchemeProfileFlags; /**< @copydoc UriSchemeProfileFlagsEnum */
+
+
+
+/**
+ * Describes a scheme for scheme-based normalization.
+ *
+ * @see uriGetDefaultSchemeProfiles
+ * @see uriNormalizeSyntaxProfiledA
+ * @since 0.9.5
+ */
+typedef struct UriSchemeProfileStruct {
+	const char * scheme; /**< Name of the scheme, in lowercase */
+	int defaultPort; /**< Default port or -1 for none */
+	unsigned int flags; /**< Combination of UriSchemeProfileFlags values */
+} UriSchemeProfile; /**< @copydoc UriSchemeProfileStruct */
+
+
+
 /**
  * Specifies how to resolve %URI references.
  */
@@ -374,4 +501,233 @@ URI_PUBLIC int uriTestMemoryManager(UriMemoryManager * memory);
 
 
 
+/**
+ * Creates a memory manager that keeps freed blocks of up to 64 bytes
+ * in size-class freelists and hands them out again on the next request
+ * of that class. This suits the many small nodes of %URIs and query
+ * lists, e.g. UriPathSegmentA, UriQueryListA and UriIp6.
+ * Larger blocks go straight to \p backend.
+ *
+ * The manager is not thread-safe; threads should create one each.
+ *
+ * @param memory   <b>OUT</b>: Destination for the new memory manager
+ * @param backend  <b>IN</b>: Memory manager to use as a backend,
+ *                           NULL for default libc
+ * @return         Error code or 0 on success
+ *
+ * @see uriReleaseFreelistMemoryManager
+ * @see uriFreeFreelistMemoryManager
+ * @see uriTestMemoryManager
+ * @since 0.9.5
+ */
+URI_PUBLIC int uriCreateFreelistMemoryManager(UriMemoryManager ** memory,
+		UriMemoryManager * backend);
+
+
+
+/**
+ * Hands all blocks cached by a memory manager created with
+ * uriCreateFreelistMemoryManager back to its backend, in bulk.
+ * Blocks still in use are not affected.
+ *
+ * @param memory  <b>INOUT</b>: Freelist memory manager, can be NULL
+ *
+ * @see uriCreateFreelistMemoryManager
+ * @since 0.9.5
+ */
+URI_PUBLIC void uriReleaseFreelistMemoryManager(UriMemoryManager * memory);
+
+
+
+/**
+ * Frees a memory manager created with uriCreateFreelistMemoryManager
+ * including all blocks it cached. Blocks still in use
+ * need to be freed through it before.
+ *
+ * @param memory  <b>INOUT</b>: Freelist memory manager, can be NULL
+ *
+ * @see uriCreateFreelistMemoryManager
+ * @since 0.9.5
+ */
+URI_PUBLIC void uriFreeFreelistMemoryManager(UriMemoryManager * memory);
+
+
+
+/**
+ * Creates a parser context for repeated parsing with
+ * uriParseSingleUriContextA. The memory manager is checked
+ * for completeness once, here, rather than on every call.
+ *
+ * @param context  <b>OUT</b>: Destination for the new context
+ * @param memory   <b>IN</b>: Memory manager to use, NULL for default libc
+ * @return         Error code or 0 on success
+ *
+ * @see uriFreeParserContext
+ * @see uriParseSingleUriContextA
+ * @since 0.9.5
+ */
+URI_PUBLIC int uriCreateParserContext(UriParserContext ** context,
+		UriMemoryManager * memory);
+
+
+
+/**
+ * Frees a parser context and all memory it kept for reuse.
+ * All %URIs parsed with the context need to be freed
+ * using uriFreeUriMembersContextA before.
+ *
+ * @param context  <b>INOUT</b>: Context to free, can be NULL
+ *
+ * @see uriCreateParserContext
+ * @since 0.9.5
+ */
+URI_PUBLIC void uriFreeParserContext(UriParserContext * context);
+
+
+
+/**
+ * Returns the memory manager of a parser context. It can be passed
+ * to all functions of the "Mm" family to have them share the memory
+ * cached by the context, e.g. uriNormalizeSyntaxExMmA on a %URI
+ * parsed with uriParseSingleUriContextA.
+ *
+ * @param context  <b>IN</b>: Context to query
+ * @return         Memory manager or NULL if \p context is NULL
+ *
+ * @see uriCreateParserContext
+ * @since 0.9.5
+ */
+URI_PUBLIC UriMemoryManager * uriGetParserContextMemoryManager(
+		UriParserContext * context);
+
+
+
+/**
+ * Compiles a Public Suffix List (see https://publicsuffix.org/)
+ * from its text, e.g. the content of file <c>public_suffix_list.dat</c>
+ * read or mapped into memory by the caller.  Normal, wildcard
+ * (<c>*.</c>) and exception (<c>!</c>) rules are supported; comments,
+ * empty lines and everything after the first whitespace of a line
+ * are ignored.  Uses default libc-based memory manager.
+ *
+ * @param list       <b>OUT</b>: Where to write the compiled list to
+ * @param first      <b>IN</b>: First character of the list text
+ * @param afterLast  <b>IN</b>: Character after the last of the list text
+ * @return           Error code or 0 on success
+ *
+ * @see uriLoadSuffixListMm
+ * @see uriFreeSuffixList
+ * @see uriGetRegistrableDomainA
+ * @since 0.9.5
+ */
+URI_PUBLIC int uriLoadSuffixList(UriSuffixList ** list, const char * first,
+		const char * afterLast);
+
+
+
+/**
+ * Compiles a Public Suffix List (see https://publicsuffix.org/)
+ * from its text.  The compiled list takes a single allocation.
+ *
+ * @param list       <b>OUT</b>: Where to write the compiled list to
+ * @param first      <b>IN</b>: First character of the list text
+ * @param afterLast  <b>IN</b>: Character after the last of the list text
+ * @param memory     <b>IN</b>: Memory manager to use, NULL for default libc
+ * @return           Error code or 0 on success
+ *
+ * @see uriLoadSuffixList
+ * @see uriFreeSuffixListMm
+ * @since 0.9.5
+ */
+URI_PUBLIC int uriLoadSuffixListMm(UriSuffixList ** list, const char * first,
+		const char * afterLast, UriMemoryManager * memory);
+
+
+
+/**
+ * Frees a suffix list compiled by uriLoadSuffixList.
+ * Uses default libc-based memory manager.
+ *
+ * @param list   <b>INOUT</b>: Suffix list to free
+ *
+ * @see uriLoadSuffixList
+ * @see uriFreeSuffixListMm
+ * @since 0.9.5
+ */
+URI_PUBLIC void uriFreeSuffixList(UriSuffixList * list);
+
+
+
+/**
+ * Frees a suffix list compiled by uriLoadSuffixListMm.
+ *
+ * @param list     <b>INOUT</b>: Suffix list to free
+ * @param memory   <b>IN</b>: Memory manager to use, NULL for default libc
+ * @return         Error code or 0 on success
+ *
+ * @see uriLoadSuffixListMm
+ * @see uriFreeSuffixList
+ * @since 0.9.5
+ */
+URI_PUBLIC int uriFreeSuffixListMm(UriSuffixList * list,
+		UriMemoryManager * memory);
+
+
+
+/**
+ * Encodes a sequence of Unicode code points as Punycode (RFC 3492),
+ * e.g. for the part of an internationalized domain label after the
+ * <c>xn--</c> prefix.  Letters are written in lowercase.
+ *
+ * @param dest            <b>OUT</b>: Output destination
+ * @param codePoints      <b>IN</b>: Code points to encode
+ * @param codePointCount  <b>IN</b>: Number of code points to encode
+ * @param maxChars        <b>IN</b>: Maximum number of characters to copy <b>including</b> terminator
+ * @param charsWritten    <b>OUT</b>: Number of characters written, can be lower than maxChars even if the output is too long, can be NULL
+ * @return                Error code or 0 on success
+ *
+ * @see uriPunycodeDecode
+ * @see uriHostToAsciiA
+ * @since 0.9.5
+ */
+URI_PUBLIC int uriPunycodeEncode(char * dest, const unsigned int * codePoints,
+		int codePointCount, int maxChars, int * charsWritten);
+
+
+
+/**
+ * Decodes Punycode (RFC 3492) to a sequence of Unicode code points.
+ * No terminator is written.
+ *
+ * @param dest               <b>OUT</b>: Output destination
+ * @param first              <b>IN</b>: First character of the Punycode text
+ * @param afterLast          <b>IN</b>: Character after the last of the Punycode text
+ * @param maxCodePoints      <b>IN</b>: Maximum number of code points to write
+ * @param codePointsWritten  <b>OUT</b>: Number of code points written, can be NULL
+ * @return                   Error code or 0 on success
+ *
+ * @see uriPunycodeEncode
+ * @see uriHostToUnicodeA
+ * @since 0.9.5
+ */
+URI_PUBLIC int uriPunycodeDecode(unsigned int * dest, const char * first,
+		const char * afterLast, int maxCodePoints, int * codePointsWritten);
+
+
+
+/**
+ * Returns the built-in scheme profiles used for scheme-based normalization:
+ * <c>file</c>, <c>ftp</c>, <c>http</c>, <c>https</c>, <c>ws</c> and <c>wss</c>.
+ * Callers can copy them into a table of their own to add schemes.
+ *
+ * @param count   <b>OUT</b>: Number of profiles, can be NULL
+ * @return        Array of profiles
+ *
+ * @see uriNormalizeSyntaxProfiledA
+ * @since 0.9.5
+ */
+URI_PUBLIC const UriSchemeProfile * uriGetDefaultSchemeProfiles(int * count);
+
+
+
 #endif /* URI_BASE_H */
@@ -100,6 +100,30 @@ URI_PUBLIC int URI_FUNC(ParseIpFourAddress)(unsigned char * octetOutput,
 
 
 
+/**
+ * Converts many IPv4 text representations into four bytes each in one call.
+ * The i-th candidate is <c>firsts[i]</c> to <c>afterLasts[i]</c>;
+ * its bytes go to <c>octetOutput[4 * i]</c> to <c>octetOutput[4 * i + 3]</c>
+ * and its individual result (as returned by uriParseIpFourAddressA)
+ * to <c>results[i]</c>.
+ * Candidates that fail to parse do not affect the others.
+ *
+ * @param octetOutput  <b>OUT</b>: Output destination, room for <c>4 * count</c> bytes
+ * @param results      <b>OUT</b>: Per-candidate error code or 0, room for <c>count</c> entries
+ * @param firsts       <b>IN</b>: First character of each candidate
+ * @param afterLasts   <b>IN</b>: Position to stop parsing at for each candidate
+ * @param count        <b>IN</b>: Number of candidates
+ * @return Error code or 0 on success
+ *
+ * @see uriParseIpFourAddressA
+ * @since 0.9.5
+ */
+URI_PUBLIC int URI_FUNC(ParseIpFourAddresses)(unsigned char * octetOutput,
+		int * results, const URI_CHAR * const * firsts,
+		const URI_CHAR * const * afterLasts, int count);
+
+
+
 #ifdef __cplusplus
 }
 #endif
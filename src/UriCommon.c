@@ -64,13 +64,26 @@
 #ifndef URI_DOXYGEN
 # include <uriparser/Uri.h>
 # include "UriCommon.h"
+# include "UriNormalizeBase.h"
 #endif
 
 
 
+static int URI_FUNC(DotSegmentKind)(const URI_TYPE(TextRange) * text,
+		UriBool fixPercent);
+static int URI_FUNC(BalanceStep)(int kind);
+static void URI_FUNC(FindBlockMinima)(URI_TYPE(NormalizedPathWalker) * walker);
+static void URI_FUNC(FindRemovedInChunk)(
+		URI_TYPE(NormalizedPathWalker) * walker, int kind);
+static UriBool URI_FUNC(IsRemovedByLaterParent)(
+		URI_TYPE(NormalizedPathWalker) * walker, int kind);
+
+
+
 /*extern*/ const URI_CHAR * const URI_FUNC(SafeToPointTo) = _UT("X");
 /*extern*/ const URI_CHAR * const URI_FUNC(ConstPwd) = _UT(".");
 /*extern*/ const URI_CHAR * const URI_FUNC(ConstParent) = _UT("..");
+/*extern*/ const URI_CHAR * const URI_FUNC(ConstLazyPath) = _UT("/");
 
 
 
@@ -125,7 +138,8 @@ UriBool URI_FUNC(RemoveDotSegments)(URI_TYPE(Uri) * uri,
 	if (uri == NULL) {
 		return URI_TRUE;
 	}
-	return URI_FUNC(RemoveDotSegmentsEx)(uri, relative, uri->owner, memory);
+	return URI_FUNC(RemoveDotSegmentsEx)(uri, relative,
+			uri->owner && !URI_FUNC(IsCompactOwner)(uri), memory);
 }
 
 
@@ -137,6 +151,11 @@ UriBool URI_FUNC(RemoveDotSegmentsEx)(URI_TYPE(Uri) * uri,
 		return URI_TRUE;
 	}
 
+	/* Segments are removed in place, so a lazy path is split up first */
+	if (!URI_FUNC(MaterializePath)(uri, memory)) {
+		return URI_FALSE; /* Raises malloc error */
+	}
+
 	walker = uri->pathHead;
 	walker->reserved = NULL; /* Prev pointer */
 	do {
@@ -430,6 +449,266 @@ UriBool URI_FUNC(IsHostSet)(const URI_TYPE(Uri) * uri) {
 
 
 
+/* Tells whether the URI owns its text through a single block
+ * made by uriMakeOwnerCompact*, rather than one block per range */
+UriBool URI_FUNC(IsCompactOwner)(const URI_TYPE(Uri) * uri) {
+	return (uri != NULL)
+			&& uri->owner
+			&& (uri->reserved != NULL);
+}
+
+
+
+/* Tells whether the path is still the single unsplit node
+ * made by uriParseSingleUriLazyExMm* */
+UriBool URI_FUNC(IsPathLazy)(const URI_TYPE(Uri) * uri) {
+	return (uri != NULL)
+			&& (uri->pathHead != NULL)
+			&& (uri->pathHead->reserved == (void *)URI_FUNC(ConstLazyPath));
+}
+
+
+
+static void URI_FUNC(FreeSegmentList)(URI_TYPE(PathSegment) * head,
+		UriBool ownsText, UriMemoryManager * memory) {
+	while (head != NULL) {
+		URI_TYPE(PathSegment) * const next = head->next;
+		if (ownsText && (head->text.first < head->text.afterLast)) {
+			memory->free(memory, (URI_CHAR *)head->text.first);
+		}
+		memory->free(memory, head);
+		head = next;
+	}
+}
+
+
+
+/* Splits a lazy path into regular segments, leaving the URI
+ * untouched on failure. Owners get one text block per segment. */
+UriBool URI_FUNC(MaterializePath)(URI_TYPE(Uri) * uri,
+		UriMemoryManager * memory) {
+	URI_TYPE(PathSegment) * const lazy = uri->pathHead;
+	const UriBool ownsText = uri->owner && !URI_FUNC(IsCompactOwner)(uri);
+	const URI_CHAR * walker;
+	const URI_CHAR * afterLast;
+	URI_TYPE(PathSegment) * head = NULL;
+	URI_TYPE(PathSegment) * tail = NULL;
+
+	if (!URI_FUNC(IsPathLazy)(uri)) {
+		return URI_TRUE;
+	}
+
+	walker = lazy->text.first;
+	afterLast = lazy->text.afterLast;
+	for (;;) {
+		const URI_CHAR * afterSegment = walker;
+		URI_TYPE(PathSegment) * segment;
+
+		while ((afterSegment < afterLast) && (afterSegment[0] != _UT('/'))) {
+			afterSegment++;
+		}
+
+		segment = memory->calloc(memory, 1, sizeof(URI_TYPE(PathSegment)));
+		if (segment == NULL) {
+			URI_FUNC(FreeSegmentList)(head, ownsText, memory);
+			return URI_FALSE; /* Raises malloc error */
+		}
+
+		if (afterSegment == walker) {
+			segment->text.first = URI_FUNC(SafeToPointTo);
+			segment->text.afterLast = URI_FUNC(SafeToPointTo);
+		} else if (ownsText) {
+			const size_t len = (size_t)(afterSegment - walker);
+			URI_CHAR * const text = memory->malloc(memory,
+					len * sizeof(URI_CHAR));
+			if (text == NULL) {
+				memory->free(memory, segment);
+				URI_FUNC(FreeSegmentList)(head, ownsText, memory);
+				return URI_FALSE; /* Raises malloc error */
+			}
+			memcpy(text, walker, len * sizeof(URI_CHAR));
+			segment->text.first = text;
+			segment->text.afterLast = text + len;
+		} else {
+			segment->text.first = walker;
+			segment->text.afterLast = afterSegment;
+		}
+
+		if (tail == NULL) {
+			head = segment;
+		} else {
+			tail->next = segment;
+		}
+		tail = segment;
+
+		if (afterSegment >= afterLast) {
+			break;
+		}
+		walker = afterSegment + 1;
+	}
+
+	/* Swap in the new list */
+	if (ownsText && (lazy->text.first < lazy->text.afterLast)) {
+		memory->free(memory, (URI_CHAR *)lazy->text.first);
+	}
+	memory->free(memory, lazy);
+	uri->pathHead = head;
+	uri->pathTail = tail;
+	return URI_TRUE;
+}
+
+
+
+/* Returns the profile of the scheme from the given table (or the
+ * built-in one for NULL) or NULL if unknown.  Scheme comparison is
+ * case-insensitive. */
+const UriSchemeProfile * URI_FUNC(FindSchemeProfile)(
+		const URI_TYPE(TextRange) * scheme, const UriSchemeProfile * profiles,
+		int profileCount) {
+	int lenInChars;
+	int i;
+
+	if ((scheme == NULL) || (scheme->first == NULL)) {
+		return NULL;
+	}
+	if (profiles == NULL) {
+		profiles = uriGetDefaultSchemeProfiles(&profileCount);
+	}
+
+	lenInChars = (int)(scheme->afterLast - scheme->first);
+	for (i = 0; i < profileCount; i++) {
+		const char * const name = profiles[i].scheme;
+		int j = 0;
+		if (name == NULL) {
+			continue;
+		}
+		for (; (j < lenInChars) && (name[j] != '\0'); j++) {
+			URI_CHAR c = scheme->first[j];
+			if ((c >= _UT('A')) && (c <= _UT('Z'))) {
+				c = (URI_CHAR)(c + (_UT('a') - _UT('A')));
+			}
+			if (c != (URI_CHAR)name[j]) {
+				break;
+			}
+		}
+		if ((j == lenInChars) && (name[j] == '\0')) {
+			return profiles + i;
+		}
+	}
+	return NULL;
+}
+
+
+
+/* Returns the value of port text, -1 for no or empty port text or
+ * -2 for values beyond 65535; stops reading as soon as that is clear */
+int URI_FUNC(ParsePortNumber)(const URI_TYPE(TextRange) * portText) {
+	const URI_CHAR * walker = portText->first;
+	long value = 0;
+
+	if ((walker == NULL) || (walker == portText->afterLast)) {
+		return -1;
+	}
+	for (; walker < portText->afterLast; walker++) {
+		value = 10 * value + (*walker - _UT('0'));
+		if (value > 65535) {
+			return -2;
+		}
+	}
+	return (int)value;
+}
+
+
+
+/* Returns the default port of well-known schemes or -1 if unknown. */
+int URI_FUNC(GetDefaultPort)(const URI_TYPE(TextRange) * scheme) {
+	const UriSchemeProfile * const profile
+			= URI_FUNC(FindSchemeProfile)(scheme, NULL, 0);
+	return (profile != NULL) ? profile->defaultPort : -1;
+}
+
+
+
+/* Writes the canonical text form of an IPv6 address (RFC 5952):
+ * lowercase hex digits without leading zeros, the longest run of two
+ * or more zero fields (the first one on ties) replaced by "::" and
+ * IPv4-mapped addresses with a dotted quad. text needs room for
+ * URI_IP6_TEXT_MAX_CHARS characters; no terminator is written.
+ * Returns the number of characters written. */
+int URI_FUNC(WriteIpSixAddress)(URI_CHAR * text, const unsigned char * octets) {
+	unsigned int fields[8];
+	int zipperFirst = -1;
+	int zipperLength = 1;  /* a single zero field is not compressed */
+	int runFirst = -1;
+	int written = 0;
+	int i;
+
+	for (i = 0; i < 8; i++) {
+		fields[i] = ((unsigned int)octets[2 * i] << 8) | octets[2 * i + 1];
+		if (fields[i] != 0) {
+			runFirst = -1;
+			continue;
+		}
+		if (runFirst == -1) {
+			runFirst = i;
+		}
+		if (i - runFirst + 1 > zipperLength) {
+			zipperFirst = runFirst;
+			zipperLength = i - runFirst + 1;
+		}
+	}
+
+	for (i = 0; i < 8; i++) {
+		unsigned int shift = 12;
+
+		if (i == zipperFirst) {
+			text[written++] = _UT(':');
+			text[written++] = _UT(':');
+			i += zipperLength - 1;
+			continue;
+		}
+		if ((i > 0) && (i != zipperFirst + zipperLength)) {
+			text[written++] = _UT(':');
+		}
+
+		/* IPv4-mapped, i.e. ::ffff:a.b.c.d */
+		if ((i == 6) && (zipperFirst == 0) && (zipperLength == 5)
+				&& (fields[5] == 0xffff)) {
+			int j = 12;
+			for (; j < 16; j++) {
+				const unsigned char value = octets[j];
+				if (j > 12) {
+					text[written++] = _UT('.');
+				}
+				if (value > 99) {
+					text[written++] = (URI_CHAR)(_UT('0') + value / 100);
+				}
+				if (value > 9) {
+					text[written++] = (URI_CHAR)(_UT('0') + (value / 10) % 10);
+				}
+				text[written++] = (URI_CHAR)(_UT('0') + value % 10);
+			}
+			break;
+		}
+
+		while ((shift > 0) && ((fields[i] >> shift) == 0)) {
+			shift -= 4;
+		}
+		for (;;) {
+			text[written++] = URI_FUNC(HexToLetterEx)(
+					(fields[i] >> shift) & 0xf, URI_FALSE);
+			if (shift == 0) {
+				break;
+			}
+			shift -= 4;
+		}
+	}
+
+	return written;
+}
+
+
+
 /* Copies the path segment list from one URI to another. */
 UriBool URI_FUNC(CopyPath)(URI_TYPE(Uri) * dest,
 		const URI_TYPE(Uri) * source, UriMemoryManager * memory) {
@@ -454,6 +733,8 @@ UriBool URI_FUNC(CopyPath)(URI_TYPE(Uri) * dest,
 			/* From this functions usage we know that *
 			 * the dest URI cannot be uri->owner      */
 			cur->text = sourceWalker->text;
+			cur->reserved = ((destPrev == NULL) && URI_FUNC(IsPathLazy)(source))
+					? (void *)URI_FUNC(ConstLazyPath) : NULL;
 			if (destPrev == NULL) {
 				/* First segment ever */
 				dest->pathHead = cur;
@@ -522,6 +803,10 @@ UriBool URI_FUNC(FixAmbiguity)(URI_TYPE(Uri) * uri,
 		UriMemoryManager * memory) {
 	URI_TYPE(PathSegment) * segment;
 
+	if (!URI_FUNC(MaterializePath)(uri, memory)) {
+		return URI_FALSE; /* Raises malloc error */
+	}
+
 	if (	/* Case 1: absolute path, empty first segment */
 			(uri->absolutePath
 			&& (uri->pathHead != NULL)
@@ -545,6 +830,7 @@ UriBool URI_FUNC(FixAmbiguity)(URI_TYPE(Uri) * uri,
 
 	/* Insert "." segment in front */
 	segment->next = uri->pathHead;
+	segment->reserved = NULL;
 	segment->text.first = URI_FUNC(ConstPwd);
 	segment->text.afterLast = URI_FUNC(ConstPwd) + 1;
 	uri->pathHead = segment;
@@ -569,4 +855,328 @@ void URI_FUNC(FixEmptyTrailSegment)(URI_TYPE(Uri) * uri,
 
 
 
+void URI_FUNC(NormalizedCursorInit)(URI_TYPE(NormalizedCursor) * cursor,
+		const URI_TYPE(TextRange) * range, UriBool lowercase,
+		UriBool fixPercent) {
+	cursor->read = range->first;
+	cursor->afterLast = (range->first != NULL) ? range->afterLast : NULL;
+	cursor->pendingCount = 0;
+	cursor->lowercase = lowercase;
+	cursor->fixPercent = fixPercent;
+}
+
+
+
+/* Returns the next character of the normalized text or -1 at the end.
+ * Mirrors FixPercentEncodingEngine and LowercaseInplace of UriNormalize.c */
+int URI_FUNC(NormalizedCursorNext)(URI_TYPE(NormalizedCursor) * cursor) {
+	URI_CHAR c;
+
+	if (cursor->pendingCount > 0) {
+		c = cursor->pending[2 - cursor->pendingCount];
+		cursor->pendingCount--;
+	} else if (cursor->read < cursor->afterLast) {
+		c = cursor->read[0];
+		if (cursor->fixPercent && (c == _UT('%'))
+				&& (cursor->read + 2 < cursor->afterLast)) {
+			/* 6.2.2.2 Percent-Encoding Normalization: *
+			 * percent-encoded unreserved characters   */
+			const unsigned char left = URI_FUNC(HexdigToInt)(cursor->read[1]);
+			const unsigned char right = URI_FUNC(HexdigToInt)(cursor->read[2]);
+			const int code = 16 * left + right;
+			if (uriIsUnreserved(code)) {
+				c = (URI_CHAR)code;
+			} else {
+				/* 6.2.2.1 Case Normalization: *
+				 * lowercase percent-encodings */
+				cursor->pending[0] = URI_FUNC(HexToLetter)(left);
+				cursor->pending[1] = URI_FUNC(HexToLetter)(right);
+				cursor->pendingCount = 2;
+			}
+			cursor->read += 3;
+		} else {
+			cursor->read++;
+		}
+	} else {
+		return -1;
+	}
+
+	if (cursor->lowercase && (c >= _UT('A')) && (c <= _UT('Z'))) {
+		c = (URI_CHAR)(c + (_UT('a') - _UT('A')));
+	}
+	return (int)c;
+}
+
+
+
+/* Returns 1 for ".", 2 for ".." and 0 for any other segment */
+static URI_INLINE int URI_FUNC(DotSegmentKind)(const URI_TYPE(TextRange) * text,
+		UriBool fixPercent) {
+	URI_TYPE(NormalizedCursor) cursor;
+	int dots = 0;
+	int c;
+
+	if ((text->first == NULL) || (text->afterLast <= text->first)
+			|| (text->afterLast - text->first > 6)) {
+		return 0;  /* "%2E%2E" is the longest candidate */
+	}
+
+	URI_FUNC(NormalizedCursorInit)(&cursor, text, URI_FALSE, fixPercent);
+	while ((c = URI_FUNC(NormalizedCursorNext)(&cursor)) != -1) {
+		if ((c != _UT('.')) || (dots == 2)) {
+			return 0;
+		}
+		dots++;
+	}
+	return dots;
+}
+
+
+
+/* Regular segments count +1, ".." counts -1 and "." counts 0 */
+static URI_INLINE int URI_FUNC(BalanceStep)(int kind) {
+	switch (kind) {
+	case 0:
+		return 1;
+
+	case 2:
+		return -1;
+
+	default:
+		return 0;
+	}
+}
+
+
+
+/* A segment is removed by a later ".." if the balance after it drops
+ * below the balance right after that segment.  Splits the path into
+ * up to URI_PATH_WALKER_BLOCKS blocks and records the lowest balance
+ * from the start of each block to the end of the path. */
+static void URI_FUNC(FindBlockMinima)(URI_TYPE(NormalizedPathWalker) * walker) {
+	URI_TYPE(PathIterator) scan = walker->iterator;
+	const URI_TYPE(TextRange) * segment;
+	int balance = 0;
+	int block;
+	int i = 0;
+
+	walker->blockSize = (walker->segmentCount + URI_PATH_WALKER_BLOCKS - 1)
+			/ URI_PATH_WALKER_BLOCKS;
+	while ((segment = URI_FUNC(PathIteratorNext)(&scan)) != NULL) {
+		balance += URI_FUNC(BalanceStep)(URI_FUNC(DotSegmentKind)(segment,
+				URI_TRUE));
+		block = i / walker->blockSize;
+		if ((i % walker->blockSize == 0)
+				|| (balance < walker->blockMinimum[block])) {
+			walker->blockMinimum[block] = balance;
+		}
+		i++;
+	}
+
+	for (block = (walker->segmentCount - 1) / walker->blockSize - 1;
+			block >= 0; block--) {
+		if (walker->blockMinimum[block + 1] < walker->blockMinimum[block]) {
+			walker->blockMinimum[block] = walker->blockMinimum[block + 1];
+		}
+	}
+}
+
+
+
+/* Finds which of the next URI_PATH_WALKER_CHUNK segments, starting
+ * with the one last read, are removed by a later "..".  Going backwards,
+ * a segment is removed if a ".." right of it is still unmatched.  The
+ * unmatched ".." right of the chunk follow from the lowest balance
+ * there: scanning to the end of the block is enough. */
+static void URI_FUNC(FindRemovedInChunk)(
+		URI_TYPE(NormalizedPathWalker) * walker, int kind) {
+	URI_TYPE(PathIterator) scan = walker->iterator;
+	const URI_TYPE(TextRange) * segment;
+	int balance = walker->balance;
+	int lowest;
+	int pendingParents;
+	int count = 1;
+	int next;
+	int i;
+
+	/* Store the dot segment kind first, then overwrite in reverse */
+	walker->removed[0] = (unsigned char)kind;
+	while ((count < URI_PATH_WALKER_CHUNK)
+			&& ((segment = URI_FUNC(PathIteratorNext)(&scan)) != NULL)) {
+		kind = URI_FUNC(DotSegmentKind)(segment, URI_TRUE);
+		walker->removed[count++] = (unsigned char)kind;
+		balance += URI_FUNC(BalanceStep)(kind);
+	}
+
+	lowest = balance;
+	next = walker->index + count;
+	for (i = balance; (next < walker->segmentCount)
+			&& (next % walker->blockSize != 0); next++) {
+		segment = URI_FUNC(PathIteratorNext)(&scan);
+		i += URI_FUNC(BalanceStep)(URI_FUNC(DotSegmentKind)(segment,
+				URI_TRUE));
+		if (i < lowest) {
+			lowest = i;
+		}
+	}
+	if ((next < walker->segmentCount)
+			&& (walker->blockMinimum[next / walker->blockSize] < lowest)) {
+		lowest = walker->blockMinimum[next / walker->blockSize];
+	}
+
+	pendingParents = balance - lowest;
+	for (i = count - 1; i >= 0; i--) {
+		kind = walker->removed[i];
+		walker->removed[i] = (pendingParents > 0) ? 1 : 0;
+		if (kind == 2) {
+			pendingParents++;
+		} else if ((kind == 0) && (pendingParents > 0)) {
+			pendingParents--;
+		}
+	}
+
+	walker->chunkFirst = walker->index;
+}
+
+
+
+void URI_FUNC(NormalizedPathWalkerInit)(URI_TYPE(NormalizedPathWalker) * walker,
+		const URI_TYPE(Uri) * uri, UriBool normalize) {
+	URI_TYPE(PathIterator) scan;
+	const URI_TYPE(TextRange) * segment;
+
+	URI_FUNC(PathIteratorBegin)(&(walker->iterator), uri);
+	walker->index = -1;
+	walker->balance = 0;
+	walker->segmentCount = 0;
+	walker->blockSize = 1;
+	walker->chunkFirst = -1;
+	walker->normalize = normalize;
+	walker->relative = ((uri->scheme.first == NULL)
+			&& !uri->absolutePath) ? URI_TRUE : URI_FALSE;
+	walker->hostSet = URI_FUNC(IsHostSet)(uri);
+	walker->dotSegments = URI_FALSE;
+	walker->keptRegular = 0;
+	walker->keptParent = 0;
+	walker->empty.first = URI_FUNC(SafeToPointTo);
+	walker->empty.afterLast = URI_FUNC(SafeToPointTo);
+
+	if (!normalize) {
+		return;
+	}
+
+	scan = walker->iterator;
+	while ((segment = URI_FUNC(PathIteratorNext)(&scan)) != NULL) {
+		if (URI_FUNC(DotSegmentKind)(segment, URI_TRUE) != 0) {
+			walker->dotSegments = URI_TRUE;
+		}
+		walker->segmentCount++;
+	}
+	if (walker->dotSegments) {
+		URI_FUNC(FindBlockMinima)(walker);
+	}
+
+	/* Mirror FixEmptyTrailSegment */
+	if (!uri->absolutePath && !walker->hostSet) {
+		URI_TYPE(NormalizedPathWalker) probe = *walker;
+		const URI_TYPE(TextRange) * const first
+				= URI_FUNC(NormalizedPathWalkerNext)(&probe);
+		if ((first != NULL) && (first->first == first->afterLast)
+				&& (URI_FUNC(NormalizedPathWalkerNext)(&probe) == NULL)) {
+			walker->iterator.done = URI_TRUE;
+		}
+	}
+}
+
+
+
+/* Tells if the segment last read by the walker would be removed
+ * by a ".." coming later, matching ".." segments against regular
+ * segments like parentheses */
+static URI_INLINE UriBool URI_FUNC(IsRemovedByLaterParent)(
+		URI_TYPE(NormalizedPathWalker) * walker, int kind) {
+	if ((walker->chunkFirst < 0)
+			|| (walker->index >= walker->chunkFirst + URI_PATH_WALKER_CHUNK)) {
+		URI_FUNC(FindRemovedInChunk)(walker, kind);
+	}
+	return walker->removed[walker->index - walker->chunkFirst]
+			? URI_TRUE : URI_FALSE;
+}
+
+
+
+/* Returns the next surviving segment or NULL at the end.
+ * Segment text is not normalized, read it through a cursor.
+ * Mirrors RemoveDotSegmentsEx, see there for details. */
+const URI_TYPE(TextRange) * URI_FUNC(NormalizedPathWalkerNext)(
+		URI_TYPE(NormalizedPathWalker) * walker) {
+	const URI_TYPE(TextRange) * segment;
+	while ((segment = URI_FUNC(PathIteratorNext)(&(walker->iterator)))
+			!= NULL) {
+		const UriBool last = walker->iterator.done;
+		int kind;
+
+		if (!walker->dotSegments) {
+			return segment;
+		}
+
+		kind = URI_FUNC(DotSegmentKind)(segment, URI_TRUE);
+		walker->index++;
+		walker->balance += URI_FUNC(BalanceStep)(kind);
+		switch (kind) {
+		case 1:
+			if (walker->relative && (walker->keptRegular == 0)
+					&& (walker->keptParent == 0) && !last) {
+				/* Keep "." if the next segment contains a colon */
+				URI_TYPE(PathIterator) lookahead = walker->iterator;
+				const URI_TYPE(TextRange) * const next
+						= URI_FUNC(PathIteratorNext)(&lookahead);
+				const URI_CHAR * ch = next->first;
+				for (; ch < next->afterLast; ch++) {
+					if (*ch == _UT(':')) {
+						break;
+					}
+				}
+				if (ch < next->afterLast) {
+					walker->keptRegular++;
+					if (!URI_FUNC(IsRemovedByLaterParent)(walker, kind)) {
+						return segment;
+					}
+					break;
+				}
+			}
+
+			if (last && ((walker->keptRegular + walker->keptParent > 0)
+					|| walker->hostSet)) {
+				/* Trailing slash */
+				return &(walker->empty);
+			}
+			break;
+
+		case 2:
+			if (walker->keptRegular > 0) {
+				walker->keptRegular--;
+				if (last) {
+					/* Trailing slash */
+					return &(walker->empty);
+				}
+			} else if (walker->relative) {
+				walker->keptParent++;
+				return segment;
+			}
+			break;
+
+		default:
+			walker->keptRegular++;
+			if (!URI_FUNC(IsRemovedByLaterParent)(walker, kind)) {
+				return segment;
+			}
+			break;
+		}
+	}
+	return NULL;
+}
+
+
+
 #endif
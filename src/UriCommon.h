@@ -73,6 +73,9 @@
 extern const URI_CHAR * const URI_FUNC(SafeToPointTo);
 extern const URI_CHAR * const URI_FUNC(ConstPwd);
 extern const URI_CHAR * const URI_FUNC(ConstParent);
+/* Marks the single path node of a lazily parsed URI through its
+ * reserved field, see uriParseSingleUriLazyExMmA */
+extern const URI_CHAR * const URI_FUNC(ConstLazyPath);
 
 
 
@@ -94,6 +97,21 @@ URI_CHAR URI_FUNC(HexToLetter)(unsigned int value);
 URI_CHAR URI_FUNC(HexToLetterEx)(unsigned int value, UriBool uppercase);
 
 UriBool URI_FUNC(IsHostSet)(const URI_TYPE(Uri) * uri);
+UriBool URI_FUNC(IsCompactOwner)(const URI_TYPE(Uri) * uri);
+UriBool URI_FUNC(IsPathLazy)(const URI_TYPE(Uri) * uri);
+UriBool URI_FUNC(MaterializePath)(URI_TYPE(Uri) * uri,
+		UriMemoryManager * memory);
+const UriSchemeProfile * URI_FUNC(FindSchemeProfile)(
+		const URI_TYPE(TextRange) * scheme, const UriSchemeProfile * profiles,
+		int profileCount);
+int URI_FUNC(GetDefaultPort)(const URI_TYPE(TextRange) * scheme);
+int URI_FUNC(ParsePortNumber)(const URI_TYPE(TextRange) * portText);
+
+/* Longest canonical IPv6 text, "ffff:ffff:ffff:ffff:ffff:ffff:ffff:ffff" */
+#ifndef URI_IP6_TEXT_MAX_CHARS
+# define URI_IP6_TEXT_MAX_CHARS 39
+#endif
+int URI_FUNC(WriteIpSixAddress)(URI_CHAR * text, const unsigned char * octets);
 
 UriBool URI_FUNC(CopyPath)(URI_TYPE(Uri) * dest, const URI_TYPE(Uri) * source,
 		UriMemoryManager * memory);
@@ -105,5 +123,58 @@ void URI_FUNC(FixEmptyTrailSegment)(URI_TYPE(Uri) * uri,
 		UriMemoryManager * memory);
 
 
+
+/* Reads text as if normalized by uriNormalizeSyntax*,
+ * one character at a time and without allocating memory */
+typedef struct URI_TYPE(NormalizedCursorStruct) {
+	const URI_CHAR * read;
+	const URI_CHAR * afterLast;
+	URI_CHAR pending[2];
+	int pendingCount;
+	UriBool lowercase;
+	UriBool fixPercent;
+} URI_TYPE(NormalizedCursor);
+
+void URI_FUNC(NormalizedCursorInit)(URI_TYPE(NormalizedCursor) * cursor,
+		const URI_TYPE(TextRange) * range, UriBool lowercase,
+		UriBool fixPercent);
+int URI_FUNC(NormalizedCursorNext)(URI_TYPE(NormalizedCursor) * cursor);
+
+/* Buffers of the normalized path walker: time stays linear in the
+ * number of path segments up to the product of both, 131072 */
+#ifndef URI_PATH_WALKER_BLOCKS
+# define URI_PATH_WALKER_BLOCKS 128
+#endif
+#ifndef URI_PATH_WALKER_CHUNK
+# define URI_PATH_WALKER_CHUNK 1024
+#endif
+
+/* Walks the path segments that would survive uriNormalizeSyntax*,
+ * i.e. with dot segments removed, without modifying the path
+ * or allocating memory */
+typedef struct URI_TYPE(NormalizedPathWalkerStruct) {
+	URI_TYPE(PathIterator) iterator;
+	int index; /* of the segment last read */
+	int balance; /* regular segments minus ".." segments read */
+	int segmentCount;
+	int blockSize;
+	int blockMinimum[URI_PATH_WALKER_BLOCKS]; /* lowest balance onwards */
+	int chunkFirst; /* index of the segment at removed[0], -1 if none */
+	unsigned char removed[URI_PATH_WALKER_CHUNK];
+	UriBool normalize;
+	UriBool relative;
+	UriBool hostSet;
+	UriBool dotSegments;
+	int keptRegular;
+	int keptParent;
+	URI_TYPE(TextRange) empty;
+} URI_TYPE(NormalizedPathWalker);
+
+void URI_FUNC(NormalizedPathWalkerInit)(URI_TYPE(NormalizedPathWalker) * walker,
+		const URI_TYPE(Uri) * uri, UriBool normalize);
+const URI_TYPE(TextRange) * URI_FUNC(NormalizedPathWalkerNext)(
+		URI_TYPE(NormalizedPathWalker) * walker);
+
+
 #endif
 #endif
@@ -65,19 +65,76 @@
 # include <uriparser/Uri.h>
 # include <uriparser/UriIp4.h>
 # include "UriCommon.h"
+# include "UriMemory.h"
 #endif
 
 
 
+static UriBool URI_FUNC(RangesEquivalent)(const URI_TYPE(TextRange) * a,
+		const URI_TYPE(TextRange) * b, UriBool lowercase, UriBool fixPercent);
+static int URI_FUNC(CompareRangesLexically)(const URI_TYPE(TextRange) * a,
+		const URI_TYPE(TextRange) * b, UriBool lowercase, UriBool fixPercent);
+static int URI_FUNC(ComparePorts)(const URI_TYPE(TextRange) * a,
+		const URI_TYPE(TextRange) * b);
+static int URI_FUNC(HostRank)(const URI_TYPE(Uri) * uri);
+static void URI_FUNC(MergeSortUris)(URI_TYPE(Uri) ** uris,
+		URI_TYPE(Uri) ** temp, int count, unsigned int mask);
+
+
+
+static UriBool URI_FUNC(RangesEquivalent)(const URI_TYPE(TextRange) * a,
+		const URI_TYPE(TextRange) * b, UriBool lowercase, UriBool fixPercent) {
+	URI_TYPE(NormalizedCursor) cursorA;
+	URI_TYPE(NormalizedCursor) cursorB;
+	int c;
+
+	if (!lowercase && !fixPercent) {
+		return URI_FUNC(CompareRange)(a, b) ? URI_FALSE : URI_TRUE;
+	}
+
+	/* NOTE: Both NULL means equal! */
+	if ((a->first == NULL) || (b->first == NULL)) {
+		return ((a->first == NULL) && (b->first == NULL)) ? URI_TRUE : URI_FALSE;
+	}
+
+	URI_FUNC(NormalizedCursorInit)(&cursorA, a, lowercase, fixPercent);
+	URI_FUNC(NormalizedCursorInit)(&cursorB, b, lowercase, fixPercent);
+	do {
+		c = URI_FUNC(NormalizedCursorNext)(&cursorA);
+		if (c != URI_FUNC(NormalizedCursorNext)(&cursorB)) {
+			return URI_FALSE;
+		}
+	} while (c != -1);
+
+	return URI_TRUE;
+}
+
+
+
 UriBool URI_FUNC(EqualsUri)(const URI_TYPE(Uri) * a,
 		const URI_TYPE(Uri) * b) {
+	return URI_FUNC(EqualsUriEx)(a, b, URI_NORMALIZED);
+}
+
+
+
+UriBool URI_FUNC(EqualsUriEx)(const URI_TYPE(Uri) * a,
+		const URI_TYPE(Uri) * b, unsigned int mask) {
+	const UriBool normalizeHost = (mask & URI_NORMALIZE_HOST)
+			? URI_TRUE : URI_FALSE;
+	URI_TYPE(NormalizedPathWalker) walkA;
+	URI_TYPE(NormalizedPathWalker) walkB;
+	const URI_TYPE(TextRange) * segmentA;
+	const URI_TYPE(TextRange) * segmentB;
+
 	/* NOTE: Both NULL means equal! */
 	if ((a == NULL) || (b == NULL)) {
 		return ((a == NULL) && (b == NULL)) ? URI_TRUE : URI_FALSE;
 	}
 
 	/* scheme */
-	if (URI_FUNC(CompareRange)(&(a->scheme), &(b->scheme))) {
+	if (!URI_FUNC(RangesEquivalent)(&(a->scheme), &(b->scheme),
+			(mask & URI_NORMALIZE_SCHEME) ? URI_TRUE : URI_FALSE, URI_FALSE)) {
 		return URI_FALSE;
 	}
 
@@ -87,7 +144,8 @@ UriBool URI_FUNC(EqualsUri)(const URI_TYPE(Uri) * a,
 	}
 
 	/* userInfo */
-	if (URI_FUNC(CompareRange)(&(a->userInfo), &(b->userInfo))) {
+	if (!URI_FUNC(RangesEquivalent)(&(a->userInfo), &(b->userInfo), URI_FALSE,
+			(mask & URI_NORMALIZE_USER_INFO) ? URI_TRUE : URI_FALSE)) {
 		return URI_FALSE;
 	}
 
@@ -112,7 +170,8 @@ UriBool URI_FUNC(EqualsUri)(const URI_TYPE(Uri) * a,
 	}
 
 	if (a->hostData.ipFuture.first != NULL) {
-		if (URI_FUNC(CompareRange)(&(a->hostData.ipFuture), &(b->hostData.ipFuture))) {
+		if (!URI_FUNC(RangesEquivalent)(&(a->hostData.ipFuture),
+				&(b->hostData.ipFuture), normalizeHost, URI_FALSE)) {
 			return URI_FALSE;
 		}
 	}
@@ -120,7 +179,8 @@ UriBool URI_FUNC(EqualsUri)(const URI_TYPE(Uri) * a,
 	if ((a->hostData.ip4 == NULL)
 			&& (a->hostData.ip6 == NULL)
 			&& (a->hostData.ipFuture.first == NULL)) {
-		if (URI_FUNC(CompareRange)(&(a->hostText), &(b->hostText))) {
+		if (!URI_FUNC(RangesEquivalent)(&(a->hostText), &(b->hostText),
+				normalizeHost, normalizeHost)) {
 			return URI_FALSE;
 		}
 	}
@@ -131,32 +191,33 @@ UriBool URI_FUNC(EqualsUri)(const URI_TYPE(Uri) * a,
 	}
 
 	/* Path */
-	if ((a->pathHead == NULL) != (b->pathHead == NULL)) {
-		return URI_FALSE;
-	}
-
-	if (a->pathHead != NULL) {
-		URI_TYPE(PathSegment) * walkA = a->pathHead;
-		URI_TYPE(PathSegment) * walkB = b->pathHead;
-		do {
-			if (URI_FUNC(CompareRange)(&(walkA->text), &(walkB->text))) {
+	URI_FUNC(NormalizedPathWalkerInit)(&walkA, a,
+			(mask & URI_NORMALIZE_PATH) ? URI_TRUE : URI_FALSE);
+	URI_FUNC(NormalizedPathWalkerInit)(&walkB, b, walkA.normalize);
+	for (;;) {
+		segmentA = URI_FUNC(NormalizedPathWalkerNext)(&walkA);
+		segmentB = URI_FUNC(NormalizedPathWalkerNext)(&walkB);
+		if ((segmentA == NULL) || (segmentB == NULL)) {
+			if (segmentA != segmentB) {
 				return URI_FALSE;
 			}
-			if ((walkA->next == NULL) != (walkB->next == NULL)) {
-				return URI_FALSE;
-			}
-			walkA = walkA->next;
-			walkB = walkB->next;
-		} while (walkA != NULL);
+			break;
+		}
+		if (!URI_FUNC(RangesEquivalent)(segmentA, segmentB, URI_FALSE,
+				walkA.normalize)) {
+			return URI_FALSE;
+		}
 	}
 
 	/* query */
-	if (URI_FUNC(CompareRange)(&(a->query), &(b->query))) {
+	if (!URI_FUNC(RangesEquivalent)(&(a->query), &(b->query), URI_FALSE,
+			(mask & URI_NORMALIZE_QUERY) ? URI_TRUE : URI_FALSE)) {
 		return URI_FALSE;
 	}
 
 	/* fragment */
-	if (URI_FUNC(CompareRange)(&(a->fragment), &(b->fragment))) {
+	if (!URI_FUNC(RangesEquivalent)(&(a->fragment), &(b->fragment), URI_FALSE,
+			(mask & URI_NORMALIZE_FRAGMENT) ? URI_TRUE : URI_FALSE)) {
 		return URI_FALSE;
 	}
 
@@ -165,4 +226,246 @@ UriBool URI_FUNC(EqualsUri)(const URI_TYPE(Uri) * a,
 
 
 
+/* Orders absent before present, then character by character */
+static int URI_FUNC(CompareRangesLexically)(const URI_TYPE(TextRange) * a,
+		const URI_TYPE(TextRange) * b, UriBool lowercase, UriBool fixPercent) {
+	URI_TYPE(NormalizedCursor) cursorA;
+	URI_TYPE(NormalizedCursor) cursorB;
+	int ca;
+	int cb;
+
+	if ((a->first == NULL) || (b->first == NULL)) {
+		return ((a->first == NULL) ? 0 : 1) - ((b->first == NULL) ? 0 : 1);
+	}
+
+	URI_FUNC(NormalizedCursorInit)(&cursorA, a, lowercase, fixPercent);
+	URI_FUNC(NormalizedCursorInit)(&cursorB, b, lowercase, fixPercent);
+	do {
+		ca = URI_FUNC(NormalizedCursorNext)(&cursorA);
+		cb = URI_FUNC(NormalizedCursorNext)(&cursorB);
+		if (ca != cb) {
+			return (ca < cb) ? -1 : 1;
+		}
+	} while (ca != -1);
+
+	return 0;
+}
+
+
+
+/* Orders by numeric value first, so that "9" < "10" */
+static int URI_FUNC(ComparePorts)(const URI_TYPE(TextRange) * a,
+		const URI_TYPE(TextRange) * b) {
+	const URI_CHAR * digitsA = a->first;
+	const URI_CHAR * digitsB = b->first;
+	int diff;
+
+	if ((a->first == NULL) || (b->first == NULL)) {
+		return ((a->first == NULL) ? 0 : 1) - ((b->first == NULL) ? 0 : 1);
+	}
+
+	while ((digitsA < a->afterLast) && (*digitsA == _UT('0'))) {
+		digitsA++;
+	}
+	while ((digitsB < b->afterLast) && (*digitsB == _UT('0'))) {
+		digitsB++;
+	}
+
+	diff = (int)(a->afterLast - digitsA) - (int)(b->afterLast - digitsB);
+	if (diff != 0) {
+		return (diff < 0) ? -1 : 1;
+	}
+
+	for (; digitsA < a->afterLast; digitsA++, digitsB++) {
+		if (*digitsA != *digitsB) {
+			return (*digitsA < *digitsB) ? -1 : 1;
+		}
+	}
+
+	/* Same number, e.g. "080" and "80", still not equal */
+	return URI_FUNC(CompareRangesLexically)(a, b, URI_FALSE, URI_FALSE);
+}
+
+
+
+static int URI_FUNC(HostRank)(const URI_TYPE(Uri) * uri) {
+	if (uri->hostData.ip4 != NULL) {
+		return 2;
+	} else if (uri->hostData.ip6 != NULL) {
+		return 3;
+	} else if (uri->hostData.ipFuture.first != NULL) {
+		return 4;
+	} else if (uri->hostText.first != NULL) {
+		return 1;
+	}
+	return 0;
+}
+
+
+
+int URI_FUNC(CompareUri)(const URI_TYPE(Uri) * a, const URI_TYPE(Uri) * b,
+		unsigned int mask) {
+	const UriBool normalizeHost = (mask & URI_NORMALIZE_HOST)
+			? URI_TRUE : URI_FALSE;
+	URI_TYPE(NormalizedPathWalker) walkA;
+	URI_TYPE(NormalizedPathWalker) walkB;
+	const URI_TYPE(TextRange) * segmentA;
+	const URI_TYPE(TextRange) * segmentB;
+	int diff;
+
+	/* NOTE: Both NULL means equal! */
+	if ((a == NULL) || (b == NULL)) {
+		return ((a == NULL) ? 0 : 1) - ((b == NULL) ? 0 : 1);
+	}
+
+	/* scheme */
+	diff = URI_FUNC(CompareRangesLexically)(&(a->scheme), &(b->scheme),
+			(mask & URI_NORMALIZE_SCHEME) ? URI_TRUE : URI_FALSE, URI_FALSE);
+	if (diff != 0) {
+		return diff;
+	}
+
+	/* Host */
+	diff = URI_FUNC(HostRank)(a) - URI_FUNC(HostRank)(b);
+	if (diff != 0) {
+		return (diff < 0) ? -1 : 1;
+	}
+
+	if (a->hostData.ip4 != NULL) {
+		diff = memcmp(a->hostData.ip4->data, b->hostData.ip4->data, 4);
+	} else if (a->hostData.ip6 != NULL) {
+		diff = memcmp(a->hostData.ip6->data, b->hostData.ip6->data, 16);
+	} else if (a->hostData.ipFuture.first != NULL) {
+		diff = URI_FUNC(CompareRangesLexically)(&(a->hostData.ipFuture),
+				&(b->hostData.ipFuture), normalizeHost, URI_FALSE);
+	} else {
+		diff = URI_FUNC(CompareRangesLexically)(&(a->hostText), &(b->hostText),
+				normalizeHost, normalizeHost);
+	}
+	if (diff != 0) {
+		return (diff < 0) ? -1 : 1;
+	}
+
+	/* portText */
+	diff = URI_FUNC(ComparePorts)(&(a->portText), &(b->portText));
+	if (diff != 0) {
+		return diff;
+	}
+
+	/* userInfo */
+	diff = URI_FUNC(CompareRangesLexically)(&(a->userInfo), &(b->userInfo),
+			URI_FALSE, (mask & URI_NORMALIZE_USER_INFO) ? URI_TRUE : URI_FALSE);
+	if (diff != 0) {
+		return diff;
+	}
+
+	/* absolutePath, only relevant without a scheme, see uriEqualsUriA */
+	if ((a->scheme.first == NULL) && (a->absolutePath != b->absolutePath)) {
+		return a->absolutePath ? 1 : -1;
+	}
+
+	/* Path */
+	URI_FUNC(NormalizedPathWalkerInit)(&walkA, a,
+			(mask & URI_NORMALIZE_PATH) ? URI_TRUE : URI_FALSE);
+	URI_FUNC(NormalizedPathWalkerInit)(&walkB, b, walkA.normalize);
+	for (;;) {
+		segmentA = URI_FUNC(NormalizedPathWalkerNext)(&walkA);
+		segmentB = URI_FUNC(NormalizedPathWalkerNext)(&walkB);
+		if ((segmentA == NULL) || (segmentB == NULL)) {
+			if (segmentA != segmentB) {
+				return (segmentA == NULL) ? -1 : 1;
+			}
+			break;
+		}
+		diff = URI_FUNC(CompareRangesLexically)(segmentA, segmentB, URI_FALSE,
+				walkA.normalize);
+		if (diff != 0) {
+			return diff;
+		}
+	}
+
+	/* query */
+	diff = URI_FUNC(CompareRangesLexically)(&(a->query), &(b->query),
+			URI_FALSE, (mask & URI_NORMALIZE_QUERY) ? URI_TRUE : URI_FALSE);
+	if (diff != 0) {
+		return diff;
+	}
+
+	/* fragment */
+	return URI_FUNC(CompareRangesLexically)(&(a->fragment), &(b->fragment),
+			URI_FALSE, (mask & URI_NORMALIZE_FRAGMENT) ? URI_TRUE : URI_FALSE);
+}
+
+
+
+/* Stable top-down merge sort, sorts <uris> using <temp> as scratch space */
+static void URI_FUNC(MergeSortUris)(URI_TYPE(Uri) ** uris,
+		URI_TYPE(Uri) ** temp, int count, unsigned int mask) {
+	const int half = count / 2;
+	int left = 0;
+	int right = half;
+	int write = 0;
+
+	if (count < 2) {
+		return;
+	}
+
+	URI_FUNC(MergeSortUris)(uris, temp, half, mask);
+	URI_FUNC(MergeSortUris)(uris + half, temp, count - half, mask);
+
+	/* Already in order? */
+	if (URI_FUNC(CompareUri)(uris[half - 1], uris[half], mask) <= 0) {
+		return;
+	}
+
+	while ((left < half) && (right < count)) {
+		if (URI_FUNC(CompareUri)(uris[right], uris[left], mask) < 0) {
+			temp[write++] = uris[right++];
+		} else {
+			temp[write++] = uris[left++];
+		}
+	}
+	while (left < half) {
+		temp[write++] = uris[left++];
+	}
+
+	/* Elements right of <right> are in place already */
+	memcpy(uris, temp, write * sizeof(URI_TYPE(Uri) *));
+}
+
+
+
+int URI_FUNC(SortUris)(URI_TYPE(Uri) ** uris, int count, unsigned int mask) {
+	return URI_FUNC(SortUrisMm)(uris, count, mask, NULL);
+}
+
+
+
+int URI_FUNC(SortUrisMm)(URI_TYPE(Uri) ** uris, int count, unsigned int mask,
+		UriMemoryManager * memory) {
+	URI_TYPE(Uri) ** temp;
+
+	if ((uris == NULL) && (count > 0)) {
+		return URI_ERROR_NULL;
+	}
+
+	URI_CHECK_MEMORY_MANAGER(memory);  /* may return */
+
+	if (count < 2) {
+		return URI_SUCCESS;
+	}
+
+	temp = memory->malloc(memory, count * sizeof(URI_TYPE(Uri) *));
+	if (temp == NULL) {
+		return URI_ERROR_MALLOC;
+	}
+
+	URI_FUNC(MergeSortUris)(uris, temp, count, mask);
+
+	memory->free(memory, temp);
+	return URI_SUCCESS;
+}
+
+
+
 #endif
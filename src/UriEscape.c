@@ -68,6 +68,33 @@
 
 
 
+#include <limits.h>
+
+
+
+#ifndef URI_ESCAPE_UNRESERVED_DEFINED
+# define URI_ESCAPE_UNRESERVED_DEFINED 1
+/* Non-zero for ASCII characters that EscapeEx copies unmodified */
+static const unsigned char uriEscapeUnreserved[128] = {
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 0,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0,
+	0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 1,
+	0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 1, 0
+};
+#endif
+
+
+
+static const URI_CHAR * URI_FUNC(UnescapeInPlaceEngine)(URI_CHAR * inout,
+		const URI_CHAR * afterLast, UriBool plusToSpace,
+		UriBreakConversion breakConversion);
+
+
+
 URI_CHAR * URI_FUNC(Escape)(const URI_CHAR * in, URI_CHAR * out,
 		UriBool spaceToPlus, UriBool normalizeBreaks) {
 	return URI_FUNC(EscapeEx)(in, NULL, out, spaceToPlus, normalizeBreaks);
@@ -244,6 +271,101 @@ URI_CHAR * URI_FUNC(EscapeEx)(const URI_CHAR * inFirst,
 
 
 
+int URI_FUNC(EscapeCharsRequired)(const URI_CHAR * inFirst,
+		const URI_CHAR * inAfterLast, UriBool spaceToPlus,
+		UriBool normalizeBreaks, int * charsRequired) {
+	const URI_CHAR * read = inFirst;
+	UriBool prevWasCr = URI_FALSE;
+	size_t required = 0;
+
+	if ((inFirst == NULL) || (charsRequired == NULL)) {
+		return URI_ERROR_NULL;
+	}
+
+	/* Table lookup covers the common case, see EscapeEx for the rest */
+	for (; ((inAfterLast == NULL) || (read < inAfterLast))
+			&& (read[0] != _UT('\0')); read++) {
+		const unsigned int code = (unsigned int)read[0];
+		if ((code < 128) && uriEscapeUnreserved[code]) {
+			required++;
+			prevWasCr = URI_FALSE;
+			continue;
+		}
+
+		switch (code) {
+		case ' ':
+			required += spaceToPlus ? 1 : 3;
+			break;
+
+		case 0x0a:
+			required += normalizeBreaks ? (prevWasCr ? 0 : 6) : 3;
+			break;
+
+		case 0x0d:
+			required += normalizeBreaks ? 6 : 3;
+			break;
+
+		default:
+			required += 3;
+			break;
+		}
+		prevWasCr = (code == 0x0d) ? URI_TRUE : URI_FALSE;
+
+		if (required > (size_t)INT_MAX - 6) {
+			return URI_ERROR_OUTPUT_TOO_LARGE;
+		}
+	}
+
+	if (required > (size_t)INT_MAX - 1) {
+		return URI_ERROR_OUTPUT_TOO_LARGE;
+	}
+	*charsRequired = (int)required;
+	return URI_SUCCESS;
+}
+
+
+
+int URI_FUNC(EscapeBounded)(URI_CHAR * dest, const URI_CHAR * inFirst,
+		const URI_CHAR * inAfterLast, int maxChars, int * charsWritten,
+		int * charsRequired, UriBool spaceToPlus, UriBool normalizeBreaks) {
+	int required;
+	int res;
+
+	if ((dest == NULL) || (inFirst == NULL)) {
+		return URI_ERROR_NULL;
+	}
+
+	res = URI_FUNC(EscapeCharsRequired)(inFirst, inAfterLast, spaceToPlus,
+			normalizeBreaks, &required);
+	if (res != URI_SUCCESS) {
+		return res;
+	}
+	if (charsRequired != NULL) {
+		*charsRequired = required;
+	}
+
+	if (required + 1 > maxChars) {
+		if (maxChars > 0) {
+			dest[0] = _UT('\0');
+		}
+		if (charsWritten != NULL) {
+			*charsWritten = 0;
+		}
+		return URI_ERROR_OUTPUT_TOO_LARGE;
+	}
+
+	if (URI_FUNC(EscapeEx)(inFirst, inAfterLast, dest, spaceToPlus,
+			normalizeBreaks) == NULL) {
+		return URI_ERROR_NULL;
+	}
+	if (charsWritten != NULL) {
+		*charsWritten = required + 1;  /* .. for terminator */
+	}
+	return URI_SUCCESS;
+}
+
+
+
 const URI_CHAR * URI_FUNC(UnescapeInPlace)(URI_CHAR * inout) {
 	return URI_FUNC(UnescapeInPlaceEx)(inout, URI_FALSE, URI_BR_DONT_TOUCH);
 }
@@ -252,15 +374,60 @@ const URI_CHAR * URI_FUNC(UnescapeInPlace)(URI_CHAR * inout) {
 
 const URI_CHAR * URI_FUNC(UnescapeInPlaceEx)(URI_CHAR * inout,
 		UriBool plusToSpace, UriBreakConversion breakConversion) {
-	URI_CHAR * read = inout;
-	URI_CHAR * write = inout;
-	UriBool prevWasCr = URI_FALSE;
-
 	if (inout == NULL) {
 		return NULL;
 	}
 
+	return URI_FUNC(UnescapeInPlaceEngine)(inout, NULL, plusToSpace,
+			breakConversion);
+}
+
+
+
+const URI_CHAR * URI_FUNC(UnescapeRangeInPlace)(URI_CHAR * first,
+		const URI_CHAR * afterLast, UriBool plusToSpace,
+		UriBreakConversion breakConversion) {
+	if ((first == NULL) || (afterLast == NULL) || (afterLast < first)) {
+		return NULL;
+	}
+
+	return URI_FUNC(UnescapeInPlaceEngine)(first, afterLast, plusToSpace,
+			breakConversion);
+}
+
+
+
+/*
+ * Unescapes up to the terminator if afterLast is NULL, otherwise
+ * the given range with no terminator written or recognized.
+ */
+static const URI_CHAR * URI_FUNC(UnescapeInPlaceEngine)(URI_CHAR * inout,
+		const URI_CHAR * afterLast, UriBool plusToSpace,
+		UriBreakConversion breakConversion) {
+	URI_CHAR * read = inout;
+	URI_CHAR * write = inout;
+	UriBool prevWasCr = URI_FALSE;
+
 	for (;;) {
+		if (afterLast != NULL) {
+			if (read >= afterLast) {
+				return write;
+			}
+
+			if ((read[0] == _UT('\0'))
+					|| ((read[0] == _UT('%')) && (afterLast - read < 3))) {
+				/* Copy one char unmodified */
+				if (read > write) {
+					write[0] = read[0];
+				}
+				read++;
+				write++;
+
+				prevWasCr = URI_FALSE;
+				continue;
+			}
+		}
+
 		switch (read[0]) {
 		case _UT('\0'):
 			if (read > write) {
@@ -68,98 +68,225 @@
 
 
 #include <stdlib.h>  /* for size_t, avoiding stddef.h for older MSVCs */
+#include <limits.h>
 
 
 
-static URI_INLINE int URI_FUNC(FilenameToUriString)(const URI_CHAR * filename,
-		URI_CHAR * uriString, UriBool fromUnix) {
+/*
+ * Returns the %URI prefix for an absolute filename or NULL for a
+ * relative one.
+ */
+static const URI_CHAR * URI_FUNC(FilenameUriPrefix)(const URI_CHAR * filename,
+		const URI_CHAR * filenameAfterLast, UriBool fromUnix) {
+	const UriBool is_windows_network = (filenameAfterLast - filename >= 2)
+			&& (filename[0] == _UT('\\')) && (filename[1] == _UT('\\'));
+
+	if (fromUnix) {
+		return ((filenameAfterLast - filename >= 1) && (filename[0] == _UT('/')))
+				? _UT("file://")
+				: NULL;
+	} else if (is_windows_network) {
+		return _UT("file:");
+	} else if ((filenameAfterLast - filename >= 2) && (filename[1] == _UT(':'))) {
+		return _UT("file:///");
+	}
+	return NULL;
+}
+
+
+
+/*
+ * Writes the %URI string for a filename to <uriString> or, with
+ * <uriString> being NULL, only stores its length (without terminator)
+ * to <charsRequired>; both modes share the same walk.
+ * A non-NULL <resumeSep> must point to a separator inside the filename
+ * whose conversion is already present in the first <resumeWritten>
+ * characters of <uriString>; conversion then continues right after it.
+ */
+static int URI_FUNC(FilenameToUriString)(const URI_CHAR * filename,
+		const URI_CHAR * filenameAfterLast, const URI_CHAR * resumeSep,
+		size_t resumeWritten, URI_CHAR * uriString, size_t * charsRequired,
+		UriBool fromUnix) {
 	const URI_CHAR * input = filename;
 	const URI_CHAR * lastSep = input - 1;
 	UriBool firstSegment = URI_TRUE;
-	URI_CHAR * output = uriString;
+	size_t written = 0;
+	const URI_CHAR * prefix;
 	UriBool absolute;
-	UriBool is_windows_network;
 
-	if ((filename == NULL) || (uriString == NULL)) {
+	if ((filename == NULL) || (filenameAfterLast == NULL)
+			|| ((uriString == NULL) && (charsRequired == NULL))) {
 		return URI_ERROR_NULL;
 	}
 
-	is_windows_network = (filename[0] == _UT('\\')) && (filename[1] == _UT('\\'));
-	absolute = fromUnix
-			? (filename[0] == _UT('/'))
-			: (((filename[0] != _UT('\0')) && (filename[1] == _UT(':')))
-				|| is_windows_network);
+	prefix = URI_FUNC(FilenameUriPrefix)(filename, filenameAfterLast, fromUnix);
+	absolute = (prefix != NULL) ? URI_TRUE : URI_FALSE;
 
-	if (absolute) {
-		const URI_CHAR * const prefix = fromUnix
-				? _UT("file://")
-				: is_windows_network
-					? _UT("file:")
-					: _UT("file:///");
+	if (resumeSep != NULL) {
+		/* Everything up to and including the separator is done */
+		input = resumeSep + 1;
+		lastSep = resumeSep;
+		firstSegment = URI_FALSE;
+		written = resumeWritten;
+	} else if (absolute) {
 		const size_t prefixLen = URI_STRLEN(prefix);
 
 		/* Copy prefix */
-		memcpy(uriString, prefix, prefixLen * sizeof(URI_CHAR));
-		output += prefixLen;
+		if (uriString != NULL) {
+			memcpy(uriString, prefix, prefixLen * sizeof(URI_CHAR));
+		}
+		written += prefixLen;
 	}
 
 	/* Copy and escape on the fly */
 	for (;;) {
-		if ((input[0] == _UT('\0'))
+		if ((input >= filenameAfterLast)
 				|| (fromUnix && input[0] == _UT('/'))
 				|| (!fromUnix && input[0] == _UT('\\'))) {
 			/* Copy text after last separator */
 			if (lastSep + 1 < input) {
 				if (!fromUnix && absolute && (firstSegment == URI_TRUE)) {
 					/* Quick hack to not convert "C:" to "C%3A" */
-					const int charsToCopy = (int)(input - (lastSep + 1));
-					memcpy(output, lastSep + 1, charsToCopy * sizeof(URI_CHAR));
-					output += charsToCopy;
+					const size_t charsToCopy = (size_t)(input - (lastSep + 1));
+					if (uriString != NULL) {
+						memcpy(uriString + written, lastSep + 1,
+								charsToCopy * sizeof(URI_CHAR));
+					}
+					written += charsToCopy;
+				} else if (uriString != NULL) {
+					written = (size_t)(URI_FUNC(EscapeEx)(lastSep + 1, input,
+							uriString + written, URI_FALSE, URI_FALSE)
+							- uriString);
 				} else {
-					output = URI_FUNC(EscapeEx)(lastSep + 1, input, output,
-							URI_FALSE, URI_FALSE);
+					int segmentChars;
+					const int res = URI_FUNC(EscapeCharsRequired)(lastSep + 1,
+							input, URI_FALSE, URI_FALSE, &segmentChars);
+					if (res != URI_SUCCESS) {
+						return res;
+					}
+					written += (size_t)segmentChars;
 				}
 			}
 			firstSegment = URI_FALSE;
 		}
 
-		if (input[0] == _UT('\0')) {
-			output[0] = _UT('\0');
+		if (input >= filenameAfterLast) {
+			if (uriString != NULL) {
+				uriString[written] = _UT('\0');
+			}
 			break;
-		} else if (fromUnix && (input[0] == _UT('/'))) {
-			/* Copy separators unmodified */
-			output[0] = _UT('/');
-			output++;
-			lastSep = input;
-		} else if (!fromUnix && (input[0] == _UT('\\'))) {
-			/* Convert backslashes to forward slashes */
-			output[0] = _UT('/');
-			output++;
+		} else if ((fromUnix && (input[0] == _UT('/')))
+				|| (!fromUnix && (input[0] == _UT('\\')))) {
+			/* Copy separators, converting backslashes to forward slashes */
+			if (uriString != NULL) {
+				uriString[written] = _UT('/');
+			}
+			written++;
 			lastSep = input;
 		}
 		input++;
 	}
 
+	if (charsRequired != NULL) {
+		*charsRequired = written;
+	}
+	return URI_SUCCESS;
+}
+
+
+
+static int URI_FUNC(FilenameToUriStringBounded)(const URI_CHAR * filenameFirst,
+		const URI_CHAR * filenameAfterLast, URI_CHAR * dest, int maxChars,
+		int * charsWritten, int * charsRequired, UriBool fromUnix) {
+	size_t required;
+	int res;
+
+	if (dest == NULL) {
+		return URI_ERROR_NULL;
+	}
+
+	res = URI_FUNC(FilenameToUriString)(filenameFirst, filenameAfterLast,
+			NULL, 0, NULL, &required, fromUnix);
+	if (res != URI_SUCCESS) {
+		return res;
+	}
+	if (required > (size_t)INT_MAX - 1) {
+		return URI_ERROR_OUTPUT_TOO_LARGE;
+	}
+	if (charsRequired != NULL) {
+		*charsRequired = (int)required;
+	}
+
+	if ((maxChars < 1) || (required > (size_t)(maxChars - 1))) {
+		if (maxChars > 0) {
+			dest[0] = _UT('\0');
+		}
+		if (charsWritten != NULL) {
+			*charsWritten = 0;
+		}
+		return URI_ERROR_OUTPUT_TOO_LARGE;
+	}
+
+	res = URI_FUNC(FilenameToUriString)(filenameFirst, filenameAfterLast,
+			NULL, 0, dest, NULL, fromUnix);
+	if ((res == URI_SUCCESS) && (charsWritten != NULL)) {
+		*charsWritten = (int)required + 1;  /* .. for terminator */
+	}
+	return res;
+}
+
+
+
+static int URI_FUNC(FilenameToUriStringCharsRequired)(
+		const URI_CHAR * filenameFirst, const URI_CHAR * filenameAfterLast,
+		int * charsRequired, UriBool fromUnix) {
+	size_t required;
+	int res;
+
+	if (charsRequired == NULL) {
+		return URI_ERROR_NULL;
+	}
+
+	res = URI_FUNC(FilenameToUriString)(filenameFirst, filenameAfterLast,
+			NULL, 0, NULL, &required, fromUnix);
+	if (res != URI_SUCCESS) {
+		return res;
+	}
+	if (required > (size_t)INT_MAX - 1) {
+		return URI_ERROR_OUTPUT_TOO_LARGE;
+	}
+	*charsRequired = (int)required;
 	return URI_SUCCESS;
 }
 
 
 
+static URI_INLINE UriBool URI_FUNC(HasPrefix)(const URI_CHAR * first,
+		const URI_CHAR * afterLast, const URI_CHAR * prefix) {
+	const size_t prefixLen = URI_STRLEN(prefix);
+	return ((size_t)(afterLast - first) >= prefixLen)
+			&& (URI_STRNCMP(first, prefix, prefixLen) == 0);
+}
+
+
+
 static URI_INLINE int URI_FUNC(UriStringToFilename)(const URI_CHAR * uriString,
-		URI_CHAR * filename, UriBool toUnix) {
-	if ((uriString == NULL) || (filename == NULL)) {
+		const URI_CHAR * uriStringAfterLast, URI_CHAR * filename,
+		UriBool toUnix) {
+	if ((uriString == NULL) || (uriStringAfterLast == NULL)
+			|| (filename == NULL)) {
 		return URI_ERROR_NULL;
 	}
 
 	{
-		const UriBool file_unknown_slashes =
-				URI_STRNCMP(uriString, _UT("file:"), URI_STRLEN(_UT("file:"))) == 0;
+		const UriBool file_unknown_slashes = URI_FUNC(HasPrefix)(uriString,
+				uriStringAfterLast, _UT("file:"));
 		const UriBool file_one_or_more_slashes = file_unknown_slashes
-				&& (URI_STRNCMP(uriString, _UT("file:/"), URI_STRLEN(_UT("file:/"))) == 0);
+				&& URI_FUNC(HasPrefix)(uriString, uriStringAfterLast, _UT("file:/"));
 		const UriBool file_two_or_more_slashes = file_one_or_more_slashes
-				&& (URI_STRNCMP(uriString, _UT("file://"), URI_STRLEN(_UT("file://"))) == 0);
+				&& URI_FUNC(HasPrefix)(uriString, uriStringAfterLast, _UT("file://"));
 		const UriBool file_three_or_more_slashes = file_two_or_more_slashes
-				&& (URI_STRNCMP(uriString, _UT("file:///"), URI_STRLEN(_UT("file:///"))) == 0);
+				&& URI_FUNC(HasPrefix)(uriString, uriStringAfterLast, _UT("file:///"));
 
 		const size_t charsToSkip = file_two_or_more_slashes
 				? file_three_or_more_slashes
@@ -179,7 +306,8 @@ static URI_INLINE int URI_FUNC(UriStringToFilename)(const URI_CHAR * uriString,
 						/* https://tools.ietf.org/html/rfc8089#appendix-E.2 */
 						? URI_STRLEN(_UT("file:"))
 						: 0));
-		const size_t charsToCopy = URI_STRLEN(uriString + charsToSkip) + 1;
+		const size_t charsToCopy = (size_t)(uriStringAfterLast - uriString)
+				- charsToSkip;
 
 		const UriBool is_windows_network_with_authority =
 				(toUnix == URI_FALSE)
@@ -196,6 +324,7 @@ static URI_INLINE int URI_FUNC(UriStringToFilename)(const URI_CHAR * uriString,
 		}
 
 		memcpy(unescape_target, uriString + charsToSkip, charsToCopy * sizeof(URI_CHAR));
+		unescape_target[charsToCopy] = _UT('\0');
 		URI_FUNC(UnescapeInPlaceEx)(filename, URI_FALSE, URI_BR_DONT_TOUCH);
 	}
 
@@ -215,26 +344,256 @@ static URI_INLINE int URI_FUNC(UriStringToFilename)(const URI_CHAR * uriString,
 
 
 
+/*
+ * Finds the last separator (past the first character) that <filename>
+ * shares with <prevFilename> and where its conversion ends in
+ * <prevUriString>, so that converting <filename> can resume from there.
+ */
+static void URI_FUNC(FindSharedFilenamePrefix)(const URI_CHAR * prevFilename,
+		const URI_CHAR * prevUriString, const URI_CHAR * filename,
+		UriBool fromUnix, const URI_CHAR ** resumeSep,
+		size_t * resumeWritten) {
+	const URI_CHAR sep = fromUnix ? _UT('/') : _UT('\\');
+	const URI_CHAR * lastSharedSep = NULL;
+	size_t firstSepIndex = 0;
+	int sepCount = 0;
+	int sharedSepCount = 0;
+	size_t k;
+
+	for (k = 0; (prevFilename[k] != _UT('\0'))
+			&& (prevFilename[k] == filename[k]); k++) {
+		if (filename[k] == sep) {
+			if (sepCount == 0) {
+				firstSepIndex = k;
+			}
+			sepCount++;
+			/* Index 0 alone does not pin down the kind of filename */
+			if (k >= 1) {
+				lastSharedSep = filename + k;
+				sharedSepCount = sepCount;
+			}
+		}
+	}
+
+	if (lastSharedSep == NULL) {
+		return;
+	}
+
+	{
+		const URI_CHAR * const prefix = URI_FUNC(FilenameUriPrefix)(filename,
+				lastSharedSep + 1, fromUnix);
+		/* An absolute Windows filename has its drive copied raw, "/" and all */
+		const size_t rawLen = (!fromUnix && (prefix != NULL))
+				? firstSepIndex
+				: 0;
+		const URI_CHAR * walker = prevUriString
+				+ ((prefix != NULL) ? URI_STRLEN(prefix) : 0) + rawLen;
+
+		/* Separators are the only source of "/" from here on */
+		for (;;) {
+			if ((walker[0] == _UT('/')) && (--sharedSepCount == 0)) {
+				break;
+			}
+			walker++;
+		}
+
+		*resumeSep = lastSharedSep;
+		*resumeWritten = (size_t)(walker + 1 - prevUriString);
+	}
+}
+
+
+
+static int URI_FUNC(FilenamesToUriStrings)(const URI_CHAR * const * filenames,
+		int filenameCount, URI_CHAR * arena, int arenaChars,
+		const URI_CHAR ** uriStrings, int * convertedCount, UriBool fromUnix) {
+	const size_t arenaSize = (arenaChars > 0) ? (size_t)arenaChars : 0;
+	const URI_CHAR * prevFilename = NULL;
+	const URI_CHAR * prevUriString = NULL;
+	size_t used = 0;
+	int i;
+
+	if ((filenames == NULL) || (arena == NULL) || (uriStrings == NULL)) {
+		return URI_ERROR_NULL;
+	}
+	if (convertedCount != NULL) {
+		*convertedCount = 0;
+	}
+
+	for (i = 0; i < filenameCount; i++) {
+		const URI_CHAR * const filename = filenames[i];
+		URI_CHAR * const output = arena + used;
+		const URI_CHAR * resumeSep = NULL;
+		size_t resumeWritten = 0;
+		size_t len;
+		size_t remaining;
+		size_t required;
+		int res;
+
+		if (filename == NULL) {
+			return URI_ERROR_NULL;
+		}
+		len = URI_STRLEN(filename);
+
+		if (prevFilename != NULL) {
+			URI_FUNC(FindSharedFilenamePrefix)(prevFilename, prevUriString,
+					filename, fromUnix, &resumeSep, &resumeWritten);
+		}
+
+		/* Only count exactly if the worst case might not fit */
+		remaining = (resumeSep != NULL)
+				? (size_t)(filename + len - (resumeSep + 1))
+				: len;
+		if (resumeWritten + 8 + 3 * remaining + 1 > arenaSize - used) {
+			res = URI_FUNC(FilenameToUriString)(filename, filename + len,
+					resumeSep, resumeWritten, NULL, &required, fromUnix);
+			if (res != URI_SUCCESS) {
+				return res;
+			}
+			if (required + 1 > arenaSize - used) {
+				return URI_ERROR_OUTPUT_TOO_LARGE;
+			}
+		}
+
+		if (resumeSep != NULL) {
+			memcpy(output, prevUriString, resumeWritten * sizeof(URI_CHAR));
+		}
+		res = URI_FUNC(FilenameToUriString)(filename, filename + len,
+				resumeSep, resumeWritten, output, &required, fromUnix);
+		if (res != URI_SUCCESS) {
+			return res;
+		}
+
+		uriStrings[i] = output;
+		used += required + 1;  /* .. for terminator */
+		prevFilename = filename;
+		prevUriString = output;
+		if (convertedCount != NULL) {
+			*convertedCount = i + 1;
+		}
+	}
+
+	return URI_SUCCESS;
+}
+
+
+
 int URI_FUNC(UnixFilenameToUriString)(const URI_CHAR * filename, URI_CHAR * uriString) {
-	return URI_FUNC(FilenameToUriString)(filename, uriString, URI_TRUE);
+	return URI_FUNC(FilenameToUriString)(filename,
+			(filename == NULL) ? NULL : filename + URI_STRLEN(filename),
+			NULL, 0, uriString, NULL, URI_TRUE);
+}
+
+
+
+int URI_FUNC(UnixFilenameToUriStringEx)(const URI_CHAR * filenameFirst,
+		const URI_CHAR * filenameAfterLast, URI_CHAR * uriString) {
+	return URI_FUNC(FilenameToUriString)(filenameFirst, filenameAfterLast,
+			NULL, 0, uriString, NULL, URI_TRUE);
+}
+
+
+
+int URI_FUNC(UnixFilenameToUriStringCharsRequired)(
+		const URI_CHAR * filenameFirst, const URI_CHAR * filenameAfterLast,
+		int * charsRequired) {
+	return URI_FUNC(FilenameToUriStringCharsRequired)(filenameFirst,
+			filenameAfterLast, charsRequired, URI_TRUE);
+}
+
+
+
+int URI_FUNC(UnixFilenameToUriStringBounded)(const URI_CHAR * filenameFirst,
+		const URI_CHAR * filenameAfterLast, URI_CHAR * dest, int maxChars,
+		int * charsWritten, int * charsRequired) {
+	return URI_FUNC(FilenameToUriStringBounded)(filenameFirst,
+			filenameAfterLast, dest, maxChars, charsWritten, charsRequired,
+			URI_TRUE);
 }
 
 
 
 int URI_FUNC(WindowsFilenameToUriString)(const URI_CHAR * filename, URI_CHAR * uriString) {
-	return URI_FUNC(FilenameToUriString)(filename, uriString, URI_FALSE);
+	return URI_FUNC(FilenameToUriString)(filename,
+			(filename == NULL) ? NULL : filename + URI_STRLEN(filename),
+			NULL, 0, uriString, NULL, URI_FALSE);
+}
+
+
+
+int URI_FUNC(WindowsFilenameToUriStringEx)(const URI_CHAR * filenameFirst,
+		const URI_CHAR * filenameAfterLast, URI_CHAR * uriString) {
+	return URI_FUNC(FilenameToUriString)(filenameFirst, filenameAfterLast,
+			NULL, 0, uriString, NULL, URI_FALSE);
+}
+
+
+
+int URI_FUNC(WindowsFilenameToUriStringCharsRequired)(
+		const URI_CHAR * filenameFirst, const URI_CHAR * filenameAfterLast,
+		int * charsRequired) {
+	return URI_FUNC(FilenameToUriStringCharsRequired)(filenameFirst,
+			filenameAfterLast, charsRequired, URI_FALSE);
+}
+
+
+
+int URI_FUNC(WindowsFilenameToUriStringBounded)(const URI_CHAR * filenameFirst,
+		const URI_CHAR * filenameAfterLast, URI_CHAR * dest, int maxChars,
+		int * charsWritten, int * charsRequired) {
+	return URI_FUNC(FilenameToUriStringBounded)(filenameFirst,
+			filenameAfterLast, dest, maxChars, charsWritten, charsRequired,
+			URI_FALSE);
+}
+
+
+
+int URI_FUNC(UnixFilenamesToUriStrings)(const URI_CHAR * const * filenames,
+		int filenameCount, URI_CHAR * arena, int arenaChars,
+		const URI_CHAR ** uriStrings, int * convertedCount) {
+	return URI_FUNC(FilenamesToUriStrings)(filenames, filenameCount, arena,
+			arenaChars, uriStrings, convertedCount, URI_TRUE);
+}
+
+
+
+int URI_FUNC(WindowsFilenamesToUriStrings)(const URI_CHAR * const * filenames,
+		int filenameCount, URI_CHAR * arena, int arenaChars,
+		const URI_CHAR ** uriStrings, int * convertedCount) {
+	return URI_FUNC(FilenamesToUriStrings)(filenames, filenameCount, arena,
+			arenaChars, uriStrings, convertedCount, URI_FALSE);
 }
 
 
 
 int URI_FUNC(UriStringToUnixFilename)(const URI_CHAR * uriString, URI_CHAR * filename) {
-	return URI_FUNC(UriStringToFilename)(uriString, filename, URI_TRUE);
+	return URI_FUNC(UriStringToFilename)(uriString,
+			(uriString == NULL) ? NULL : uriString + URI_STRLEN(uriString),
+			filename, URI_TRUE);
+}
+
+
+
+int URI_FUNC(UriStringToUnixFilenameEx)(const URI_CHAR * uriStringFirst,
+		const URI_CHAR * uriStringAfterLast, URI_CHAR * filename) {
+	return URI_FUNC(UriStringToFilename)(uriStringFirst, uriStringAfterLast,
+			filename, URI_TRUE);
 }
 
 
 
 int URI_FUNC(UriStringToWindowsFilename)(const URI_CHAR * uriString, URI_CHAR * filename) {
-	return URI_FUNC(UriStringToFilename)(uriString, filename, URI_FALSE);
+	return URI_FUNC(UriStringToFilename)(uriString,
+			(uriString == NULL) ? NULL : uriString + URI_STRLEN(uriString),
+			filename, URI_FALSE);
+}
+
+
+
+int URI_FUNC(UriStringToWindowsFilenameEx)(const URI_CHAR * uriStringFirst,
+		const URI_CHAR * uriStringAfterLast, URI_CHAR * filename) {
+	return URI_FUNC(UriStringToFilename)(uriStringFirst, uriStringAfterLast,
+			filename, URI_FALSE);
 }
 
 
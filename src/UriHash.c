@@ -0,0 +1,219 @@
+/*
+ * uriparser - RFC 3986 URI parsing library
+ *
+ * Copyright (C) 2020, Weijia Song <songweijia@gmail.com>
+ * Copyright (C) 2020, Sebastian Pipping <sebastian@pipping.org>
+ * All rights reserved.
+ *
+ * Redistribution and use in source  and binary forms, with or without
+ * modification, are permitted provided  that the following conditions
+ * are met:
+ *
+ *     1. Redistributions  of  source  code   must  retain  the  above
+ *        copyright notice, this list  of conditions and the following
+ *        disclaimer.
+ *
+ *     2. Redistributions  in binary  form  must  reproduce the  above
+ *        copyright notice, this list  of conditions and the following
+ *        disclaimer  in  the  documentation  and/or  other  materials
+ *        provided with the distribution.
+ *
+ *     3. Neither the  name of the  copyright holder nor the  names of
+ *        its contributors may be used  to endorse or promote products
+ *        derived from  this software  without specific  prior written
+ *        permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND  ANY EXPRESS OR IMPLIED WARRANTIES,  INCLUDING, BUT NOT
+ * LIMITED TO,  THE IMPLIED WARRANTIES OF  MERCHANTABILITY AND FITNESS
+ * FOR  A  PARTICULAR  PURPOSE  ARE  DISCLAIMED.  IN  NO  EVENT  SHALL
+ * THE  COPYRIGHT HOLDER  OR CONTRIBUTORS  BE LIABLE  FOR ANY  DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL,  EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO,  PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA,  OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT  LIABILITY,  OR  TORT (INCLUDING  NEGLIGENCE  OR  OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file UriHash.c
+ * Holds the %URI hashing implementation.
+ * NOTE: This source file includes itself twice.
+ */
+
+/* What encodings are enabled? */
+#include <uriparser/UriDefsConfig.h>
+#if (!defined(URI_PASS_ANSI) && !defined(URI_PASS_UNICODE))
+/* Include SELF twice */
+# ifdef URI_ENABLE_ANSI
+#  define URI_PASS_ANSI 1
+#  include "UriHash.c"
+#  undef URI_PASS_ANSI
+# endif
+# ifdef URI_ENABLE_UNICODE
+#  define URI_PASS_UNICODE 1
+#  include "UriHash.c"
+#  undef URI_PASS_UNICODE
+# endif
+#else
+# ifdef URI_PASS_ANSI
+#  include <uriparser/UriDefsAnsi.h>
+# else
+#  include <uriparser/UriDefsUnicode.h>
+#  include <wchar.h>
+# endif
+
+
+
+#ifndef URI_DOXYGEN
+# include <uriparser/Uri.h>
+# include "UriCommon.h"
+# include "UriHashBase.h"
+#endif
+
+
+
+static void URI_FUNC(HashChar)(UriHashState * state, URI_CHAR ch,
+		unsigned long * highSurrogate);
+static void URI_FUNC(HashRange)(UriHashState * state, int marker,
+		const URI_TYPE(TextRange) * range, UriBool lowercase,
+		UriBool fixPercent);
+
+
+
+/* Hashes wide characters as UTF-8, so that ANSI text in UTF-8
+ * hashes the same; UTF-16 surrogate pairs are combined first */
+static URI_INLINE void URI_FUNC(HashChar)(UriHashState * state, URI_CHAR ch,
+		unsigned long * highSurrogate) {
+	unsigned long c;
+
+	if (sizeof(URI_CHAR) == 1) {
+		URI_HASH_APPEND_BYTE(state, ch);
+		return;
+	}
+
+	c = (unsigned long)ch;
+	if ((*highSurrogate != 0) && (c >= 0xdc00) && (c <= 0xdfff)) {
+		c = 0x10000 + ((*highSurrogate - 0xd800) << 10) + (c - 0xdc00);
+		*highSurrogate = 0;
+	} else {
+		if (*highSurrogate != 0) {
+			uriHashAppendUtf8(state, *highSurrogate);
+			*highSurrogate = 0;
+		}
+		if ((c >= 0xd800) && (c <= 0xdbff)) {
+			*highSurrogate = c;
+			return;
+		}
+	}
+	uriHashAppendUtf8(state, c);
+}
+
+
+
+static void URI_FUNC(HashRange)(UriHashState * state, int marker,
+		const URI_TYPE(TextRange) * range, UriBool lowercase,
+		UriBool fixPercent) {
+	unsigned long highSurrogate = 0;
+
+	URI_HASH_APPEND_BYTE(state, marker);
+
+	if (!lowercase && !fixPercent) {
+		const URI_CHAR * walker = range->first;
+		for (; walker < range->afterLast; walker++) {
+			URI_FUNC(HashChar)(state, *walker, &highSurrogate);
+		}
+	} else {
+		URI_TYPE(NormalizedCursor) cursor;
+		int c;
+		URI_FUNC(NormalizedCursorInit)(&cursor, range, lowercase, fixPercent);
+		while ((c = URI_FUNC(NormalizedCursorNext)(&cursor)) != -1) {
+			URI_FUNC(HashChar)(state, (URI_CHAR)c, &highSurrogate);
+		}
+	}
+
+	if (highSurrogate != 0) {
+		uriHashAppendUtf8(state, highSurrogate);
+	}
+}
+
+
+
+int URI_FUNC(HashUri)(const URI_TYPE(Uri) * uri, unsigned int mask,
+		UriHash * hash) {
+	UriHashState state;
+	URI_TYPE(NormalizedPathWalker) walker;
+	const URI_TYPE(TextRange) * segment;
+
+	if ((uri == NULL) || (hash == NULL)) {
+		return URI_ERROR_NULL;
+	}
+
+	uriHashInit(&state);
+
+	/* Scheme */
+	if (uri->scheme.first != NULL) {
+		URI_FUNC(HashRange)(&state, URI_HASH_MARKER_SCHEME, &(uri->scheme),
+				(mask & URI_NORMALIZE_SCHEME) ? URI_TRUE : URI_FALSE, URI_FALSE);
+	} else if (uri->absolutePath) {
+		URI_HASH_APPEND_BYTE(&state, URI_HASH_MARKER_ABSOLUTE_PATH);
+	}
+
+	/* User info */
+	if (uri->userInfo.first != NULL) {
+		URI_FUNC(HashRange)(&state, URI_HASH_MARKER_USER_INFO, &(uri->userInfo),
+				URI_FALSE, (mask & URI_NORMALIZE_USER_INFO) ? URI_TRUE : URI_FALSE);
+	}
+
+	/* Host */
+	if (uri->hostData.ip4 != NULL) {
+		URI_HASH_APPEND_BYTE(&state, URI_HASH_MARKER_HOST_IP4);
+		uriHashAppendBytes(&state, uri->hostData.ip4->data, 4);
+	} else if (uri->hostData.ip6 != NULL) {
+		URI_HASH_APPEND_BYTE(&state, URI_HASH_MARKER_HOST_IP6);
+		uriHashAppendBytes(&state, uri->hostData.ip6->data, 16);
+	} else if (uri->hostData.ipFuture.first != NULL) {
+		URI_FUNC(HashRange)(&state, URI_HASH_MARKER_HOST_IP_FUTURE,
+				&(uri->hostData.ipFuture),
+				(mask & URI_NORMALIZE_HOST) ? URI_TRUE : URI_FALSE, URI_FALSE);
+	} else if (uri->hostText.first != NULL) {
+		const UriBool normalizeHost = (mask & URI_NORMALIZE_HOST)
+				? URI_TRUE : URI_FALSE;
+		URI_FUNC(HashRange)(&state, URI_HASH_MARKER_HOST_REGNAME,
+				&(uri->hostText), normalizeHost, normalizeHost);
+	}
+
+	/* Port */
+	if (uri->portText.first != NULL) {
+		URI_FUNC(HashRange)(&state, URI_HASH_MARKER_PORT, &(uri->portText),
+				URI_FALSE, URI_FALSE);
+	}
+
+	/* Path */
+	URI_FUNC(NormalizedPathWalkerInit)(&walker, uri,
+			(mask & URI_NORMALIZE_PATH) ? URI_TRUE : URI_FALSE);
+	while ((segment = URI_FUNC(NormalizedPathWalkerNext)(&walker)) != NULL) {
+		URI_FUNC(HashRange)(&state, URI_HASH_MARKER_PATH_SEGMENT, segment,
+				URI_FALSE, walker.normalize);
+	}
+
+	/* Query, fragment */
+	if (uri->query.first != NULL) {
+		URI_FUNC(HashRange)(&state, URI_HASH_MARKER_QUERY, &(uri->query),
+				URI_FALSE, (mask & URI_NORMALIZE_QUERY) ? URI_TRUE : URI_FALSE);
+	}
+
+	if (uri->fragment.first != NULL) {
+		URI_FUNC(HashRange)(&state, URI_HASH_MARKER_FRAGMENT, &(uri->fragment),
+				URI_FALSE, (mask & URI_NORMALIZE_FRAGMENT) ? URI_TRUE : URI_FALSE);
+	}
+
+	uriHashFinish(&state, hash);
+	return URI_SUCCESS;
+}
+
+
+
+#endif
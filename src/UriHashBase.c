@@ -0,0 +1,206 @@
+/*
+ * uriparser - RFC 3986 URI parsing library
+ *
+ * Copyright (C) 2020, Weijia Song <songweijia@gmail.com>
+ * Copyright (C) 2020, Sebastian Pipping <sebastian@pipping.org>
+ * All rights reserved.
+ *
+ * Redistribution and use in source  and binary forms, with or without
+ * modification, are permitted provided  that the following conditions
+ * are met:
+ *
+ *     1. Redistributions  of  source  code   must  retain  the  above
+ *        copyright notice, this list  of conditions and the following
+ *        disclaimer.
+ *
+ *     2. Redistributions  in binary  form  must  reproduce the  above
+ *        copyright notice, this list  of conditions and the following
+ *        disclaimer  in  the  documentation  and/or  other  materials
+ *        provided with the distribution.
+ *
+ *     3. Neither the  name of the  copyright holder nor the  names of
+ *        its contributors may be used  to endorse or promote products
+ *        derived from  this software  without specific  prior written
+ *        permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND  ANY EXPRESS OR IMPLIED WARRANTIES,  INCLUDING, BUT NOT
+ * LIMITED TO,  THE IMPLIED WARRANTIES OF  MERCHANTABILITY AND FITNESS
+ * FOR  A  PARTICULAR  PURPOSE  ARE  DISCLAIMED.  IN  NO  EVENT  SHALL
+ * THE  COPYRIGHT HOLDER  OR CONTRIBUTORS  BE LIABLE  FOR ANY  DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL,  EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO,  PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA,  OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT  LIABILITY,  OR  TORT (INCLUDING  NEGLIGENCE  OR  OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file UriHashBase.c
+ * Holds code independent of the encoding pass.
+ */
+
+#include <uriparser/UriDefsConfig.h>
+
+#ifndef URI_DOXYGEN
+# include "UriHashBase.h"
+#endif
+
+
+
+#define URI_HASH_MASK32  0xffffffffUL
+#define URI_HASH_ROTL32(x, r)  \
+	((((x) << (r)) | ((x) >> (32 - (r)))) & URI_HASH_MASK32)
+
+
+
+static unsigned long uriHashMixKey(unsigned long k, int index);
+static unsigned long uriHashFmix32(unsigned long h);
+static unsigned long uriHashReadWord(const unsigned char * bytes);
+
+
+
+static const unsigned long uriHashKeyFactors[5] = {
+	0x239b961bUL, 0xab0e9789UL, 0x38b34ae5UL, 0xa1e38b93UL, 0x239b961bUL
+};
+
+static const int uriHashKeyRotations[4] = { 15, 16, 17, 18 };
+
+
+
+static URI_INLINE unsigned long uriHashMixKey(unsigned long k, int index) {
+	k = (k * uriHashKeyFactors[index]) & URI_HASH_MASK32;
+	k = URI_HASH_ROTL32(k, uriHashKeyRotations[index]);
+	return (k * uriHashKeyFactors[index + 1]) & URI_HASH_MASK32;
+}
+
+
+
+static URI_INLINE unsigned long uriHashFmix32(unsigned long h) {
+	h ^= h >> 16;
+	h = (h * 0x85ebca6bUL) & URI_HASH_MASK32;
+	h ^= h >> 13;
+	h = (h * 0xc2b2ae35UL) & URI_HASH_MASK32;
+	h ^= h >> 16;
+	return h;
+}
+
+
+
+static URI_INLINE unsigned long uriHashReadWord(const unsigned char * bytes) {
+	return (unsigned long)bytes[0]
+			| ((unsigned long)bytes[1] << 8)
+			| ((unsigned long)bytes[2] << 16)
+			| ((unsigned long)bytes[3] << 24);
+}
+
+
+
+void uriHashInit(UriHashState * state) {
+	state->h[0] = 0;
+	state->h[1] = 0;
+	state->h[2] = 0;
+	state->h[3] = 0;
+	state->blockCount = 0;
+	state->tailCount = 0;
+}
+
+
+
+void uriHashProcessBlock(UriHashState * state) {
+	unsigned long * const h = state->h;
+
+	h[0] ^= uriHashMixKey(uriHashReadWord(state->tail), 0);
+	h[0] = URI_HASH_ROTL32(h[0], 19);
+	h[0] = (((h[0] + h[1]) * 5) + 0x561ccd1bUL) & URI_HASH_MASK32;
+
+	h[1] ^= uriHashMixKey(uriHashReadWord(state->tail + 4), 1);
+	h[1] = URI_HASH_ROTL32(h[1], 17);
+	h[1] = (((h[1] + h[2]) * 5) + 0x0bcaa747UL) & URI_HASH_MASK32;
+
+	h[2] ^= uriHashMixKey(uriHashReadWord(state->tail + 8), 2);
+	h[2] = URI_HASH_ROTL32(h[2], 15);
+	h[2] = (((h[2] + h[3]) * 5) + 0x96cd1c35UL) & URI_HASH_MASK32;
+
+	h[3] ^= uriHashMixKey(uriHashReadWord(state->tail + 12), 3);
+	h[3] = URI_HASH_ROTL32(h[3], 13);
+	h[3] = (((h[3] + h[0]) * 5) + 0x32ac3b17UL) & URI_HASH_MASK32;
+
+	state->blockCount++;
+	state->tailCount = 0;
+}
+
+
+
+void uriHashAppendBytes(UriHashState * state, const unsigned char * bytes,
+		int count) {
+	int i = 0;
+	for (; i < count; i++) {
+		URI_HASH_APPEND_BYTE(state, bytes[i]);
+	}
+}
+
+
+
+void uriHashAppendUtf8(UriHashState * state, unsigned long codePoint) {
+	if (codePoint < 0x80) {
+		URI_HASH_APPEND_BYTE(state, codePoint);
+		return;
+	}
+	if (codePoint < 0x800) {
+		URI_HASH_APPEND_BYTE(state, 0xc0 | (codePoint >> 6));
+	} else {
+		if (codePoint < 0x10000) {
+			URI_HASH_APPEND_BYTE(state, 0xe0 | (codePoint >> 12));
+		} else {
+			URI_HASH_APPEND_BYTE(state, 0xf0 | ((codePoint >> 18) & 0x07));
+			URI_HASH_APPEND_BYTE(state, 0x80 | ((codePoint >> 12) & 0x3f));
+		}
+		URI_HASH_APPEND_BYTE(state, 0x80 | ((codePoint >> 6) & 0x3f));
+	}
+	URI_HASH_APPEND_BYTE(state, 0x80 | (codePoint & 0x3f));
+}
+
+
+
+void uriHashFinish(UriHashState * state, UriHash * hash) {
+	unsigned long * const h = state->h;
+	const unsigned long length
+			= ((state->blockCount * 16) + state->tailCount) & URI_HASH_MASK32;
+	unsigned int i;
+
+	/* Tail */
+	if (state->tailCount > 0) {
+		unsigned int lane = 0;
+		for (i = state->tailCount; i < 16; i++) {
+			state->tail[i] = 0;
+		}
+		for (; lane * 4 < state->tailCount; lane++) {
+			h[lane] ^= uriHashMixKey(uriHashReadWord(state->tail + lane * 4),
+					(int)lane);
+		}
+	}
+
+	/* Finalization */
+	for (i = 0; i < 4; i++) {
+		h[i] ^= length;
+	}
+	h[0] = (h[0] + h[1] + h[2] + h[3]) & URI_HASH_MASK32;
+	h[1] = (h[1] + h[0]) & URI_HASH_MASK32;
+	h[2] = (h[2] + h[0]) & URI_HASH_MASK32;
+	h[3] = (h[3] + h[0]) & URI_HASH_MASK32;
+
+	for (i = 0; i < 4; i++) {
+		h[i] = uriHashFmix32(h[i]);
+	}
+	h[0] = (h[0] + h[1] + h[2] + h[3]) & URI_HASH_MASK32;
+	h[1] = (h[1] + h[0]) & URI_HASH_MASK32;
+	h[2] = (h[2] + h[0]) & URI_HASH_MASK32;
+	h[3] = (h[3] + h[0]) & URI_HASH_MASK32;
+
+	for (i = 0; i < 16; i++) {
+		hash->data[i] = (unsigned char)(h[i / 4] >> (24 - 8 * (i % 4)));
+	}
+}
@@ -1,8 +1,8 @@
 /*
  * uriparser - RFC 3986 URI parsing library
  *
- * Copyright (C) 2007, Weijia Song <songweijia@gmail.com>
- * Copyright (C) 2007, Sebastian Pipping <sebastian@pipping.org>
+ * Copyright (C) 2020, Weijia Song <songweijia@gmail.com>
+ * Copyright (C) 2020, Sebastian Pipping <sebastian@pipping.org>
  * All rights reserved.
  *
  * Redistribution and use in source  and binary forms, with or without
@@ -37,60 +37,62 @@
  * OF THE POSSIBILITY OF SUCH DAMAGE.
  */
 
-/**
- * @file UriIp4Base.c
- * Holds code independent of the encoding pass.
- */
+#ifndef URI_HASH_BASE_H
+#define URI_HASH_BASE_H 1
+
+
 
 #ifndef URI_DOXYGEN
-# include "UriIp4Base.h"
+# include <uriparser/UriBase.h>
 #endif
 
 
 
-void uriStackToOctet(UriIp4Parser * parser, unsigned char * octet) {
-	switch (parser->stackCount) {
-	case 1:
-		*octet = parser->stackOne;
-		break;
+/* Bytes above 0x7f never occur in %URI text, we use them as markers */
+typedef enum UriHashMarkerEnum {
+	URI_HASH_MARKER_SCHEME = 0x80,
+	URI_HASH_MARKER_ABSOLUTE_PATH,
+	URI_HASH_MARKER_USER_INFO,
+	URI_HASH_MARKER_HOST_IP4,
+	URI_HASH_MARKER_HOST_IP6,
+	URI_HASH_MARKER_HOST_IP_FUTURE,
+	URI_HASH_MARKER_HOST_REGNAME,
+	URI_HASH_MARKER_PORT,
+	URI_HASH_MARKER_PATH_SEGMENT,
+	URI_HASH_MARKER_QUERY,
+	URI_HASH_MARKER_FRAGMENT
+} UriHashMarker;
+
+
+
+/* Incremental MurmurHash3 (x86, 128-bit variant), operating on
+ * 32-bit words held in unsigned long for portability */
+typedef struct UriHashStateStruct {
+	unsigned long h[4];
+	unsigned long blockCount;
+	unsigned char tail[16];
+	unsigned int tailCount;
+} UriHashState;
 
-	case 2:
-		*octet = parser->stackOne * 10
-				+ parser->stackTwo;
-		break;
 
-	case 3:
-		*octet = parser->stackOne * 100
-				+ parser->stackTwo * 10
-				+ parser->stackThree;
-		break;
 
-	default:
-		;
-	}
-	parser->stackCount = 0;
-}
+#define URI_HASH_APPEND_BYTE(state, byte)  \
+	do { \
+		(state)->tail[(state)->tailCount++] = (unsigned char)(byte); \
+		if ((state)->tailCount == 16) { \
+			uriHashProcessBlock(state); \
+		} \
+	} while (0)
 
 
 
-void uriPushToStack(UriIp4Parser * parser, unsigned char digit) {
-	switch (parser->stackCount) {
-	case 0:
-		parser->stackOne = digit;
-		parser->stackCount = 1;
-		break;
+void uriHashInit(UriHashState * state);
+void uriHashProcessBlock(UriHashState * state);
+void uriHashAppendBytes(UriHashState * state, const unsigned char * bytes,
+		int count);
+void uriHashAppendUtf8(UriHashState * state, unsigned long codePoint);
+void uriHashFinish(UriHashState * state, UriHash * hash);
 
-	case 1:
-		parser->stackTwo = digit;
-		parser->stackCount = 2;
-		break;
 
-	case 2:
-		parser->stackThree = digit;
-		parser->stackCount = 3;
-		break;
 
-	default:
-		;
-	}
-}
+#endif /* URI_HASH_BASE_H */
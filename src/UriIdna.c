@@ -0,0 +1,498 @@
+/*
+ * uriparser - RFC 3986 URI parsing library
+ *
+ * Copyright (C) 2020, Weijia Song <songweijia@gmail.com>
+ * Copyright (C) 2020, Sebastian Pipping <sebastian@pipping.org>
+ * All rights reserved.
+ *
+ * Redistribution and use in source  and binary forms, with or without
+ * modification, are permitted provided  that the following conditions
+ * are met:
+ *
+ *     1. Redistributions  of  source  code   must  retain  the  above
+ *        copyright notice, this list  of conditions and the following
+ *        disclaimer.
+ *
+ *     2. Redistributions  in binary  form  must  reproduce the  above
+ *        copyright notice, this list  of conditions and the following
+ *        disclaimer  in  the  documentation  and/or  other  materials
+ *        provided with the distribution.
+ *
+ *     3. Neither the  name of the  copyright holder nor the  names of
+ *        its contributors may be used  to endorse or promote products
+ *        derived from  this software  without specific  prior written
+ *        permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND  ANY EXPRESS OR IMPLIED WARRANTIES,  INCLUDING, BUT NOT
+ * LIMITED TO,  THE IMPLIED WARRANTIES OF  MERCHANTABILITY AND FITNESS
+ * FOR  A  PARTICULAR  PURPOSE  ARE  DISCLAIMED.  IN  NO  EVENT  SHALL
+ * THE  COPYRIGHT HOLDER  OR CONTRIBUTORS  BE LIABLE  FOR ANY  DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL,  EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO,  PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA,  OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT  LIABILITY,  OR  TORT (INCLUDING  NEGLIGENCE  OR  OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file UriIdna.c
+ * Holds the IDNA host conversion implementation.
+ * NOTE: This source file includes itself twice.
+ */
+
+/* What encodings are enabled? */
+#include <uriparser/UriDefsConfig.h>
+#if (!defined(URI_PASS_ANSI) && !defined(URI_PASS_UNICODE))
+/* Include SELF twice */
+# ifdef URI_ENABLE_ANSI
+#  define URI_PASS_ANSI 1
+#  include "UriIdna.c"
+#  undef URI_PASS_ANSI
+# endif
+# ifdef URI_ENABLE_UNICODE
+#  define URI_PASS_UNICODE 1
+#  include "UriIdna.c"
+#  undef URI_PASS_UNICODE
+# endif
+#else
+# ifdef URI_PASS_ANSI
+#  include <uriparser/UriDefsAnsi.h>
+# else
+#  include <uriparser/UriDefsUnicode.h>
+#  include <wchar.h>
+# endif
+
+
+
+#ifndef URI_DOXYGEN
+# include <uriparser/Uri.h>
+# include "UriCommon.h"
+#endif
+
+
+
+/* DNS labels are at most 63 characters, "xn--" included */
+#ifndef URI_IDNA_MAX_LABEL_CHARS
+# define URI_IDNA_MAX_LABEL_CHARS  63
+# define URI_IDNA_ACE_PREFIX_CHARS  4
+#endif
+
+
+
+static UriBool URI_FUNC(IsHexdig)(URI_CHAR c);
+static int URI_FUNC(NextByte)(const URI_CHAR ** walker,
+		const URI_CHAR * afterLast);
+static int URI_FUNC(NextCodePoint)(const URI_CHAR ** walker,
+		const URI_CHAR * afterLast, unsigned int * codePoint);
+static UriBool URI_FUNC(IsLabelSeparator)(unsigned int codePoint);
+static UriBool URI_FUNC(HasAcePrefix)(const URI_CHAR * first,
+		const URI_CHAR * afterLast);
+static UriBool URI_FUNC(NeedsToAscii)(const URI_CHAR * first,
+		const URI_CHAR * afterLast);
+static UriBool URI_FUNC(NeedsToUnicode)(const URI_CHAR * first,
+		const URI_CHAR * afterLast);
+static int URI_FUNC(AppendCodePoint)(URI_CHAR * dest, int maxChars,
+		int * written, unsigned int codePoint);
+static int URI_FUNC(HostToAsciiEngine)(URI_CHAR * dest,
+		const URI_CHAR * first, const URI_CHAR * afterLast, int maxChars,
+		int * written);
+static int URI_FUNC(HostToUnicodeEngine)(URI_CHAR * dest,
+		const URI_CHAR * first, const URI_CHAR * afterLast, int maxChars,
+		int * written);
+static int URI_FUNC(ConvertHost)(URI_CHAR * dest, const URI_CHAR * first,
+		const URI_CHAR * afterLast, int maxChars,
+		URI_TYPE(TextRange) * result, UriBool toAscii);
+
+
+
+static URI_INLINE UriBool URI_FUNC(IsHexdig)(URI_CHAR c) {
+	return (((c >= _UT('0')) && (c <= _UT('9')))
+			|| ((c >= _UT('a')) && (c <= _UT('f')))
+			|| ((c >= _UT('A')) && (c <= _UT('F'))))
+			? URI_TRUE : URI_FALSE;
+}
+
+
+
+/* Reads a byte, i.e. a percent-encoded triplet or, for narrow
+ * characters, a single character.  Returns -1 for a wide character,
+ * without moving the walker. */
+static URI_INLINE int URI_FUNC(NextByte)(const URI_CHAR ** walker,
+		const URI_CHAR * afterLast) {
+	const URI_CHAR * const w = *walker;
+	if ((*w == _UT('%')) && (afterLast - w >= 3)
+			&& URI_FUNC(IsHexdig)(w[1]) && URI_FUNC(IsHexdig)(w[2])) {
+		*walker += 3;
+		return 16 * URI_FUNC(HexdigToInt)(w[1]) + URI_FUNC(HexdigToInt)(w[2]);
+	} else if (sizeof(URI_CHAR) == 1) {
+		*walker += 1;
+		return (unsigned char)*w;
+	}
+	return -1;
+}
+
+
+
+/* Reads a code point: bytes are decoded as UTF-8 and wide characters
+ * as UTF-16 (if wchar_t is 16 bits wide) or UTF-32 */
+static int URI_FUNC(NextCodePoint)(const URI_CHAR ** walker,
+		const URI_CHAR * afterLast, unsigned int * codePoint) {
+	const URI_CHAR * w = *walker;
+	unsigned int cp;
+	unsigned int minimum;
+	int trailing;
+	const int lead = URI_FUNC(NextByte)(&w, afterLast);
+
+	if (lead < 0) {
+		cp = (unsigned int)(unsigned long)*w++;
+		if ((cp >= 0xd800) && (cp <= 0xdbff) && (w < afterLast)
+				&& ((unsigned long)*w >= 0xdc00)
+				&& ((unsigned long)*w <= 0xdfff)) {
+			cp = 0x10000 + ((cp - 0xd800) << 10)
+					+ ((unsigned int)*w++ - 0xdc00);
+		}
+		minimum = 0;
+		trailing = 0;
+	} else if (lead < 0x80) {
+		cp = (unsigned int)lead;
+		minimum = 0;
+		trailing = 0;
+	} else if ((lead & 0xe0) == 0xc0) {
+		cp = (unsigned int)lead & 0x1f;
+		minimum = 0x80;
+		trailing = 1;
+	} else if ((lead & 0xf0) == 0xe0) {
+		cp = (unsigned int)lead & 0x0f;
+		minimum = 0x800;
+		trailing = 2;
+	} else if ((lead & 0xf8) == 0xf0) {
+		cp = (unsigned int)lead & 0x07;
+		minimum = 0x10000;
+		trailing = 3;
+	} else {
+		return URI_ERROR_SYNTAX;
+	}
+
+	for (; trailing > 0; trailing--) {
+		const int byte = (w < afterLast)
+				? URI_FUNC(NextByte)(&w, afterLast)
+				: -1;
+		if ((byte < 0) || ((byte & 0xc0) != 0x80)) {
+			return URI_ERROR_SYNTAX;
+		}
+		cp = (cp << 6) | ((unsigned int)byte & 0x3f);
+	}
+
+	if ((cp < minimum) || (cp > 0x10ffff)
+			|| ((cp >= 0xd800) && (cp <= 0xdfff))) {
+		return URI_ERROR_SYNTAX;
+	}
+	*codePoint = cp;
+	*walker = w;
+	return URI_SUCCESS;
+}
+
+
+
+/* Full stop and its ideographic, fullwidth and halfwidth forms */
+static URI_INLINE UriBool URI_FUNC(IsLabelSeparator)(unsigned int codePoint) {
+	return ((codePoint == 0x2e) || (codePoint == 0x3002)
+			|| (codePoint == 0xff0e) || (codePoint == 0xff61))
+			? URI_TRUE : URI_FALSE;
+}
+
+
+
+static URI_INLINE UriBool URI_FUNC(HasAcePrefix)(const URI_CHAR * first,
+		const URI_CHAR * afterLast) {
+	return ((afterLast - first >= URI_IDNA_ACE_PREFIX_CHARS)
+			&& ((first[0] == _UT('x')) || (first[0] == _UT('X')))
+			&& ((first[1] == _UT('n')) || (first[1] == _UT('N')))
+			&& (first[2] == _UT('-'))
+			&& (first[3] == _UT('-')))
+			? URI_TRUE : URI_FALSE;
+}
+
+
+
+/* Anything beyond ASCII, raw or percent-encoded, needs conversion */
+static URI_INLINE UriBool URI_FUNC(NeedsToAscii)(const URI_CHAR * first,
+		const URI_CHAR * afterLast) {
+	for (; first < afterLast; first++) {
+		if ((unsigned long)*first > 0x7f) {
+			return URI_TRUE;
+		} else if ((*first == _UT('%')) && (afterLast - first >= 3)
+				&& URI_FUNC(IsHexdig)(first[1])
+				&& (URI_FUNC(HexdigToInt)(first[1]) >= 8)) {
+			return URI_TRUE;
+		}
+	}
+	return URI_FALSE;
+}
+
+
+
+static URI_INLINE UriBool URI_FUNC(NeedsToUnicode)(const URI_CHAR * first,
+		const URI_CHAR * afterLast) {
+	const URI_CHAR * walker = first;
+	for (; walker < afterLast; walker++) {
+		if (((walker == first) || (walker[-1] == _UT('.')))
+				&& URI_FUNC(HasAcePrefix)(walker, afterLast)) {
+			return URI_TRUE;
+		}
+	}
+	return URI_FALSE;
+}
+
+
+
+/* Appends a code point as UTF-8 or as a wide character, leaving
+ * room for a terminator */
+static int URI_FUNC(AppendCodePoint)(URI_CHAR * dest, int maxChars,
+		int * written, unsigned int codePoint) {
+	if (sizeof(URI_CHAR) == 1) {
+		const int count = (codePoint < 0x80) ? 1
+				: (codePoint < 0x800) ? 2
+				: (codePoint < 0x10000) ? 3
+				: 4;
+		int i;
+		if (*written + count >= maxChars) {
+			return URI_ERROR_OUTPUT_TOO_LARGE;
+		}
+		if (count == 1) {
+			dest[*written] = (URI_CHAR)codePoint;
+		} else {
+			dest[*written] = (URI_CHAR)(((0xff00 >> count) & 0xff)
+					| (codePoint >> (6 * (count - 1))));
+			for (i = 1; i < count; i++) {
+				dest[*written + i] = (URI_CHAR)(0x80
+						| ((codePoint >> (6 * (count - 1 - i))) & 0x3f));
+			}
+		}
+		*written += count;
+	} else if ((sizeof(URI_CHAR) == 2) && (codePoint >= 0x10000)) {
+		if (*written + 2 >= maxChars) {
+			return URI_ERROR_OUTPUT_TOO_LARGE;
+		}
+		dest[(*written)++] = (URI_CHAR)(0xd800 + ((codePoint - 0x10000) >> 10));
+		dest[(*written)++] = (URI_CHAR)(0xdc00 + ((codePoint - 0x10000) & 0x3ff));
+	} else {
+		if (*written + 1 >= maxChars) {
+			return URI_ERROR_OUTPUT_TOO_LARGE;
+		}
+		dest[(*written)++] = (URI_CHAR)codePoint;
+	}
+	return URI_SUCCESS;
+}
+
+
+
+static int URI_FUNC(HostToAsciiEngine)(URI_CHAR * dest,
+		const URI_CHAR * first, const URI_CHAR * afterLast, int maxChars,
+		int * written) {
+	unsigned int codePoints[URI_IDNA_MAX_LABEL_CHARS];
+	char encoded[URI_IDNA_MAX_LABEL_CHARS - URI_IDNA_ACE_PREFIX_CHARS + 1];
+	const URI_CHAR * labelFirst = first;
+
+	for (;;) {
+		const URI_CHAR * walker = labelFirst;
+		const URI_CHAR * labelAfterLast = afterLast;
+		UriBool nonAscii = URI_FALSE;
+		int count = 0;
+		int encodedLen;
+		int i;
+
+		/* Collect the label, up to the next separator */
+		while (walker < afterLast) {
+			const URI_CHAR * const before = walker;
+			unsigned int cp;
+			const int res = URI_FUNC(NextCodePoint)(&walker, afterLast, &cp);
+			if (res != URI_SUCCESS) {
+				return res;
+			}
+			if (URI_FUNC(IsLabelSeparator)(cp)) {
+				labelAfterLast = before;
+				break;
+			}
+			if (cp > 0x7f) {
+				nonAscii = URI_TRUE;
+			} else if ((cp >= 'A') && (cp <= 'Z')) {
+				cp += 'a' - 'A';
+			}
+			if (count < URI_IDNA_MAX_LABEL_CHARS) {
+				codePoints[count] = cp;
+			}
+			count++;
+		}
+
+		if (! nonAscii) {
+			/* Copied as it is, escapes included */
+			const int len = (int)(labelAfterLast - labelFirst);
+			if (*written + len >= maxChars) {
+				return URI_ERROR_OUTPUT_TOO_LARGE;
+			}
+			memcpy(dest + *written, labelFirst, len * sizeof(URI_CHAR));
+			*written += len;
+		} else {
+			if ((count > URI_IDNA_MAX_LABEL_CHARS)
+					|| (uriPunycodeEncode(encoded, codePoints, count,
+						sizeof(encoded), &encodedLen) != URI_SUCCESS)) {
+				return URI_ERROR_SYNTAX;  /* label too long */
+			}
+			encodedLen--;  /* terminator */
+			if (*written + URI_IDNA_ACE_PREFIX_CHARS + encodedLen >= maxChars) {
+				return URI_ERROR_OUTPUT_TOO_LARGE;
+			}
+			dest[(*written)++] = _UT('x');
+			dest[(*written)++] = _UT('n');
+			dest[(*written)++] = _UT('-');
+			dest[(*written)++] = _UT('-');
+			for (i = 0; i < encodedLen; i++) {
+				dest[(*written)++] = (URI_CHAR)encoded[i];
+			}
+		}
+
+		if (labelAfterLast == afterLast) {
+			return URI_SUCCESS;
+		}
+		if (*written + 1 >= maxChars) {
+			return URI_ERROR_OUTPUT_TOO_LARGE;
+		}
+		dest[(*written)++] = _UT('.');
+		labelFirst = walker;
+	}
+}
+
+
+
+static int URI_FUNC(HostToUnicodeEngine)(URI_CHAR * dest,
+		const URI_CHAR * first, const URI_CHAR * afterLast, int maxChars,
+		int * written) {
+	unsigned int codePoints[URI_IDNA_MAX_LABEL_CHARS];
+	char encoded[URI_IDNA_MAX_LABEL_CHARS];
+	const URI_CHAR * labelFirst = first;
+
+	for (;;) {
+		const URI_CHAR * labelAfterLast = labelFirst;
+		while ((labelAfterLast < afterLast) && (*labelAfterLast != _UT('.'))) {
+			labelAfterLast++;
+		}
+
+		if (URI_FUNC(HasAcePrefix)(labelFirst, labelAfterLast)) {
+			const URI_CHAR * walker = labelFirst + URI_IDNA_ACE_PREFIX_CHARS;
+			int encodedLen = 0;
+			int count;
+			int i;
+			if (labelAfterLast - labelFirst > URI_IDNA_MAX_LABEL_CHARS) {
+				return URI_ERROR_SYNTAX;
+			}
+			for (; walker < labelAfterLast; walker++) {
+				if ((unsigned long)*walker > 0x7f) {
+					return URI_ERROR_SYNTAX;
+				}
+				encoded[encodedLen++] = (char)*walker;
+			}
+			if (uriPunycodeDecode(codePoints, encoded, encoded + encodedLen,
+					URI_IDNA_MAX_LABEL_CHARS, &count) != URI_SUCCESS) {
+				return URI_ERROR_SYNTAX;
+			}
+			for (i = 0; i < count; i++) {
+				const int res = URI_FUNC(AppendCodePoint)(dest, maxChars,
+						written, codePoints[i]);
+				if (res != URI_SUCCESS) {
+					return res;
+				}
+			}
+		} else {
+			const int len = (int)(labelAfterLast - labelFirst);
+			if (*written + len >= maxChars) {
+				return URI_ERROR_OUTPUT_TOO_LARGE;
+			}
+			memcpy(dest + *written, labelFirst, len * sizeof(URI_CHAR));
+			*written += len;
+		}
+
+		if (labelAfterLast == afterLast) {
+			return URI_SUCCESS;
+		}
+		if (*written + 1 >= maxChars) {
+			return URI_ERROR_OUTPUT_TOO_LARGE;
+		}
+		dest[(*written)++] = _UT('.');
+		labelFirst = labelAfterLast + 1;
+	}
+}
+
+
+
+static int URI_FUNC(ConvertHost)(URI_CHAR * dest, const URI_CHAR * first,
+		const URI_CHAR * afterLast, int maxChars,
+		URI_TYPE(TextRange) * result, UriBool toAscii) {
+	int written = 0;
+	int res;
+
+	if ((first == NULL) || (afterLast == NULL) || (result == NULL)) {
+		return URI_ERROR_NULL;
+	}
+	if (afterLast < first) {
+		return URI_ERROR_RANGE_INVALID;
+	}
+
+	/* Fast path: the host is returned as it is */
+	if (toAscii
+			? ! URI_FUNC(NeedsToAscii)(first, afterLast)
+			: ! URI_FUNC(NeedsToUnicode)(first, afterLast)) {
+		result->first = first;
+		result->afterLast = afterLast;
+		return URI_SUCCESS;
+	}
+
+	result->first = NULL;
+	result->afterLast = NULL;
+	if (dest == NULL) {
+		return URI_ERROR_NULL;
+	}
+	if (maxChars < 1) {
+		return URI_ERROR_OUTPUT_TOO_LARGE;
+	}
+
+	res = toAscii
+			? URI_FUNC(HostToAsciiEngine)(dest, first, afterLast, maxChars,
+				&written)
+			: URI_FUNC(HostToUnicodeEngine)(dest, first, afterLast, maxChars,
+				&written);
+	if (res != URI_SUCCESS) {
+		dest[0] = _UT('\0');
+		return res;
+	}
+
+	dest[written] = _UT('\0');
+	result->first = dest;
+	result->afterLast = dest + written;
+	return URI_SUCCESS;
+}
+
+
+
+int URI_FUNC(HostToAscii)(URI_CHAR * dest, const URI_CHAR * first,
+		const URI_CHAR * afterLast, int maxChars,
+		URI_TYPE(TextRange) * asciiHost) {
+	return URI_FUNC(ConvertHost)(dest, first, afterLast, maxChars,
+			asciiHost, URI_TRUE);
+}
+
+
+
+int URI_FUNC(HostToUnicode)(URI_CHAR * dest, const URI_CHAR * first,
+		const URI_CHAR * afterLast, int maxChars,
+		URI_TYPE(TextRange) * unicodeHost) {
+	return URI_FUNC(ConvertHost)(dest, first, afterLast, maxChars,
+			unicodeHost, URI_FALSE);
+}
+
+
+
+#endif
@@ -68,22 +68,13 @@
 
 #ifndef URI_DOXYGEN
 # include <uriparser/UriIp4.h>
-# include "UriIp4Base.h"
 # include <uriparser/UriBase.h>
 #endif
 
 
 
 /* Prototypes */
-static const URI_CHAR * URI_FUNC(ParseDecOctet)(UriIp4Parser * parser,
-		const URI_CHAR * first, const URI_CHAR * afterLast);
-static const URI_CHAR * URI_FUNC(ParseDecOctetOne)(UriIp4Parser * parser,
-		const URI_CHAR * first, const URI_CHAR * afterLast);
-static const URI_CHAR * URI_FUNC(ParseDecOctetTwo)(UriIp4Parser * parser,
-		const URI_CHAR * first, const URI_CHAR * afterLast);
-static const URI_CHAR * URI_FUNC(ParseDecOctetThree)(UriIp4Parser * parser,
-		const URI_CHAR * first, const URI_CHAR * afterLast);
-static const URI_CHAR * URI_FUNC(ParseDecOctetFour)(UriIp4Parser * parser,
+static URI_INLINE const URI_CHAR * URI_FUNC(ParseDecOctet)(unsigned char * octet,
 		const URI_CHAR * first, const URI_CHAR * afterLast);
 
 
@@ -94,7 +85,7 @@ static const URI_CHAR * URI_FUNC(ParseDecOctetFour)(UriIp4Parser * parser,
 int URI_FUNC(ParseIpFourAddress)(unsigned char * octetOutput,
 		const URI_CHAR * first, const URI_CHAR * afterLast) {
 	const URI_CHAR * after;
-	UriIp4Parser parser;
+	int octetIndex;
 
 	/* Essential checks */
 	if ((octetOutput == NULL) || (first == NULL)
@@ -102,226 +93,87 @@ int URI_FUNC(ParseIpFourAddress)(unsigned char * octetOutput,
 		return URI_ERROR_SYNTAX;
 	}
 
-	/* Reset parser */
-	parser.stackCount = 0;
-
-	/* Octet #1 */
-	after = URI_FUNC(ParseDecOctet)(&parser, first, afterLast);
-	if ((after == NULL) || (after >= afterLast) || (*after != _UT('.'))) {
-		return URI_ERROR_SYNTAX;
+	after = first;
+	for (octetIndex = 0; octetIndex < 4; octetIndex++) {
+		if (octetIndex > 0) {
+			/* Octets #2 to #4 follow a dot */
+			if ((after >= afterLast) || (*after != _UT('.'))) {
+				return URI_ERROR_SYNTAX;
+			}
+			after++;
+		}
+
+		after = URI_FUNC(ParseDecOctet)(octetOutput + octetIndex,
+				after, afterLast);
+		if (after == NULL) {
+			return URI_ERROR_SYNTAX;
+		}
 	}
-	uriStackToOctet(&parser, octetOutput);
 
-	/* Octet #2 */
-	after = URI_FUNC(ParseDecOctet)(&parser, after + 1, afterLast);
-	if ((after == NULL) || (after >= afterLast) || (*after != _UT('.'))) {
-		return URI_ERROR_SYNTAX;
-	}
-	uriStackToOctet(&parser, octetOutput + 1);
-
-	/* Octet #3 */
-	after = URI_FUNC(ParseDecOctet)(&parser, after + 1, afterLast);
-	if ((after == NULL) || (after >= afterLast) || (*after != _UT('.'))) {
-		return URI_ERROR_SYNTAX;
-	}
-	uriStackToOctet(&parser, octetOutput + 2);
-
-	/* Octet #4 */
-	after = URI_FUNC(ParseDecOctet)(&parser, after + 1, afterLast);
 	if (after != afterLast) {
 		return URI_ERROR_SYNTAX;
 	}
-	uriStackToOctet(&parser, octetOutput + 3);
 
 	return URI_SUCCESS;
 }
 
 
 
-/*
- * [decOctet]-><0>
- * [decOctet]-><1>[decOctetOne]
- * [decOctet]-><2>[decOctetTwo]
- * [decOctet]-><3>[decOctetThree]
- * [decOctet]-><4>[decOctetThree]
- * [decOctet]-><5>[decOctetThree]
- * [decOctet]-><6>[decOctetThree]
- * [decOctet]-><7>[decOctetThree]
- * [decOctet]-><8>[decOctetThree]
- * [decOctet]-><9>[decOctetThree]
- */
-static URI_INLINE const URI_CHAR * URI_FUNC(ParseDecOctet)(UriIp4Parser * parser,
-		const URI_CHAR * first, const URI_CHAR * afterLast) {
-	if (first >= afterLast) {
-		return NULL;
-	}
-
-	switch (*first) {
-	case _UT('0'):
-		uriPushToStack(parser, 0);
-		return first + 1;
-
-	case _UT('1'):
-		uriPushToStack(parser, 1);
-		return (const URI_CHAR *)URI_FUNC(ParseDecOctetOne)(parser, first + 1, afterLast);
-
-	case _UT('2'):
-		uriPushToStack(parser, 2);
-		return (const URI_CHAR *)URI_FUNC(ParseDecOctetTwo)(parser, first + 1, afterLast);
-
-	case _UT('3'):
-	case _UT('4'):
-	case _UT('5'):
-	case _UT('6'):
-	case _UT('7'):
-	case _UT('8'):
-	case _UT('9'):
-		uriPushToStack(parser, (unsigned char)(9 + *first - _UT('9')));
-		return (const URI_CHAR *)URI_FUNC(ParseDecOctetThree)(parser, first + 1, afterLast);
-
-	default:
-		return NULL;
-	}
-}
-
-
-
-/*
- * [decOctetOne]-><NULL>
- * [decOctetOne]->[DIGIT][decOctetThree]
- */
-static URI_INLINE const URI_CHAR * URI_FUNC(ParseDecOctetOne)(UriIp4Parser * parser,
-		const URI_CHAR * first, const URI_CHAR * afterLast) {
-	if (first >= afterLast) {
-		return afterLast;
-	}
+int URI_FUNC(ParseIpFourAddresses)(unsigned char * octetOutput,
+		int * results, const URI_CHAR * const * firsts,
+		const URI_CHAR * const * afterLasts, int count) {
+	int i;
 
-	switch (*first) {
-	case _UT('0'):
-	case _UT('1'):
-	case _UT('2'):
-	case _UT('3'):
-	case _UT('4'):
-	case _UT('5'):
-	case _UT('6'):
-	case _UT('7'):
-	case _UT('8'):
-	case _UT('9'):
-		uriPushToStack(parser, (unsigned char)(9 + *first - _UT('9')));
-		return (const URI_CHAR *)URI_FUNC(ParseDecOctetThree)(parser, first + 1, afterLast);
-
-	default:
-		return first;
+	if ((octetOutput == NULL) || (results == NULL)
+			|| (firsts == NULL) || (afterLasts == NULL)) {
+		return URI_ERROR_NULL;
 	}
-}
-
-
 
-/*
- * [decOctetTwo]-><NULL>
- * [decOctetTwo]-><0>[decOctetThree]
- * [decOctetTwo]-><1>[decOctetThree]
- * [decOctetTwo]-><2>[decOctetThree]
- * [decOctetTwo]-><3>[decOctetThree]
- * [decOctetTwo]-><4>[decOctetThree]
- * [decOctetTwo]-><5>[decOctetFour]
- * [decOctetTwo]-><6>
- * [decOctetTwo]-><7>
- * [decOctetTwo]-><8>
- * [decOctetTwo]-><9>
-*/
-static URI_INLINE const URI_CHAR * URI_FUNC(ParseDecOctetTwo)(UriIp4Parser * parser,
-		const URI_CHAR * first, const URI_CHAR * afterLast) {
-	if (first >= afterLast) {
-		return afterLast;
+	for (i = 0; i < count; i++) {
+		results[i] = URI_FUNC(ParseIpFourAddress)(octetOutput + 4 * i,
+				firsts[i], afterLasts[i]);
 	}
 
-	switch (*first) {
-	case _UT('0'):
-	case _UT('1'):
-	case _UT('2'):
-	case _UT('3'):
-	case _UT('4'):
-		uriPushToStack(parser, (unsigned char)(9 + *first - _UT('9')));
-		return (const URI_CHAR *)URI_FUNC(ParseDecOctetThree)(parser, first + 1, afterLast);
-
-	case _UT('5'):
-		uriPushToStack(parser, 5);
-		return (const URI_CHAR *)URI_FUNC(ParseDecOctetFour)(parser, first + 1, afterLast);
-
-	case _UT('6'):
-	case _UT('7'):
-	case _UT('8'):
-	case _UT('9'):
-		uriPushToStack(parser, (unsigned char)(9 + *first - _UT('9')));
-		return first + 1;
-
-	default:
-		return first;
-	}
+	return URI_SUCCESS;
 }
 
 
 
 /*
- * [decOctetThree]-><NULL>
- * [decOctetThree]->[DIGIT]
+ * [decOctet]-><0>
+ * [decOctet]->[1-9]
+ * [decOctet]->[1-9][DIGIT]
+ * [decOctet]-><1>[DIGIT][DIGIT]
+ * [decOctet]-><2>[0-4][DIGIT]
+ * [decOctet]-><2><5>[0-5]
+ *
+ * Rather than descending through one function per digit position
+ * this reads up to three digits in a single pass and then rejects
+ * empty octets, leading zeros and values above 255 in one go.
+ * Returns the position after the octet or NULL on error.
  */
-static URI_INLINE const URI_CHAR * URI_FUNC(ParseDecOctetThree)(UriIp4Parser * parser,
+static URI_INLINE const URI_CHAR * URI_FUNC(ParseDecOctet)(unsigned char * octet,
 		const URI_CHAR * first, const URI_CHAR * afterLast) {
-	if (first >= afterLast) {
-		return afterLast;
+	const URI_CHAR * const stop = (afterLast - first > 3)
+			? first + 3
+			: afterLast;
+	const URI_CHAR * walker = first;
+	unsigned int value = 0;
+
+	while ((walker < stop)
+			&& ((unsigned int)(*walker - _UT('0')) <= 9u)) {
+		value = value * 10 + (unsigned int)(*walker - _UT('0'));
+		walker++;
 	}
 
-	switch (*first) {
-	case _UT('0'):
-	case _UT('1'):
-	case _UT('2'):
-	case _UT('3'):
-	case _UT('4'):
-	case _UT('5'):
-	case _UT('6'):
-	case _UT('7'):
-	case _UT('8'):
-	case _UT('9'):
-		uriPushToStack(parser, (unsigned char)(9 + *first - _UT('9')));
-		return first + 1;
-
-	default:
-		return first;
-	}
-}
-
-
-
-/*
- * [decOctetFour]-><NULL>
- * [decOctetFour]-><0>
- * [decOctetFour]-><1>
- * [decOctetFour]-><2>
- * [decOctetFour]-><3>
- * [decOctetFour]-><4>
- * [decOctetFour]-><5>
- */
-static URI_INLINE const URI_CHAR * URI_FUNC(ParseDecOctetFour)(UriIp4Parser * parser,
-		const URI_CHAR * first, const URI_CHAR * afterLast) {
-	if (first >= afterLast) {
-		return afterLast;
+	if ((walker == first)
+			|| ((walker - first > 1) && (*first == _UT('0')))
+			|| (value > 255)) {
+		return NULL;
 	}
 
-	switch (*first) {
-	case _UT('0'):
-	case _UT('1'):
-	case _UT('2'):
-	case _UT('3'):
-	case _UT('4'):
-	case _UT('5'):
-		uriPushToStack(parser, (unsigned char)(9 + *first - _UT('9')));
-		return first + 1;
-
-	default:
-		return first;
-	}
+	*octet = (unsigned char)value;
+	return walker;
 }
 
 
@@ -458,6 +458,248 @@ int uriTestMemoryManager(UriMemoryManager * memory) {
 
 
 
+/* Blocks carry their requested size in front, like with
+ * uriCompleteMemoryManager; small blocks of the same size class
+ * are kept on a freelist for reuse rather than freed */
+static size_t uriFreelistClassOf(size_t size) {
+	return (size == 0) ? 0 : (size - 1) / URI_FREELIST_CLASS_STEP;
+}
+
+
+
+static void * uriFreelistMalloc(UriMemoryManager * memory, size_t size) {
+	UriFreelist * const freelist = (UriFreelist *)memory->userData;
+	const size_t extraBytes = sizeof(size_t);
+	const size_t sizeClass = uriFreelistClassOf(size);
+	void * buffer;
+
+	if (sizeClass < URI_FREELIST_CLASS_COUNT) {
+		buffer = freelist->heads[sizeClass];
+		if (buffer != NULL) {
+			freelist->heads[sizeClass] = *(void **)((char *)buffer + extraBytes);
+		} else {
+			buffer = freelist->backend->malloc(freelist->backend,
+					extraBytes + (sizeClass + 1) * URI_FREELIST_CLASS_STEP);
+			if (buffer == NULL) {
+				return NULL;
+			}
+		}
+	} else {
+		/* check for unsigned overflow */
+		if (size > ((size_t)-1) - extraBytes) {
+			errno = ENOMEM;
+			return NULL;
+		}
+		buffer = freelist->backend->malloc(freelist->backend, extraBytes + size);
+		if (buffer == NULL) {
+			return NULL;
+		}
+	}
+
+	*(size_t *)buffer = size;
+	return (char *)buffer + extraBytes;
+}
+
+
+
+static void uriFreelistFree(UriMemoryManager * memory, void * ptr) {
+	UriFreelist * const freelist = (UriFreelist *)memory->userData;
+	char * buffer;
+	size_t sizeClass;
+
+	if (ptr == NULL) {
+		return;
+	}
+
+	buffer = (char *)ptr - sizeof(size_t);
+	sizeClass = uriFreelistClassOf(*(size_t *)buffer);
+	if (sizeClass < URI_FREELIST_CLASS_COUNT) {
+		*(void **)ptr = freelist->heads[sizeClass];
+		freelist->heads[sizeClass] = buffer;
+	} else {
+		freelist->backend->free(freelist->backend, buffer);
+	}
+}
+
+
+
+static void * uriFreelistRealloc(UriMemoryManager * memory,
+		void * ptr, size_t size) {
+	size_t * prevSize;
+	size_t capacity;
+	void * newBuffer;
+
+	/* man realloc: "If ptr is NULL, then the call is equivalent to
+	 * malloc(size), for *all* values of size" */
+	if (ptr == NULL) {
+		return memory->malloc(memory, size);
+	}
+
+	/* man realloc: "If size is equal to zero, and ptr is *not* NULL,
+	 * then the call is equivalent to free(ptr)." */
+	if (size == 0) {
+		memory->free(memory, ptr);
+		return NULL;
+	}
+
+	/* Anything to do?  Small blocks can grow within their class */
+	prevSize = (size_t *)((char *)ptr - sizeof(size_t));
+	capacity = (uriFreelistClassOf(*prevSize) < URI_FREELIST_CLASS_COUNT)
+			? (uriFreelistClassOf(*prevSize) + 1) * URI_FREELIST_CLASS_STEP
+			: *prevSize;
+	if (size <= capacity) {
+		if (size > *prevSize) {
+			*prevSize = size;
+		}
+		return ptr;
+	}
+
+	newBuffer = memory->malloc(memory, size);
+	if (newBuffer == NULL) {
+		/* errno set by malloc */
+		return NULL;
+	}
+
+	memcpy(newBuffer, ptr, *prevSize);
+
+	memory->free(memory, ptr);
+
+	return newBuffer;
+}
+
+
+
+void uriFreelistInit(UriMemoryManager * memory, UriFreelist * freelist,
+		UriMemoryManager * backend) {
+	size_t i = 0;
+	for (; i < URI_FREELIST_CLASS_COUNT; i++) {
+		freelist->heads[i] = NULL;
+	}
+	freelist->backend = backend;
+
+	memory->malloc = uriFreelistMalloc;
+	memory->calloc = uriEmulateCalloc;
+	memory->realloc = uriFreelistRealloc;
+	memory->reallocarray = uriEmulateReallocarray;
+	memory->free = uriFreelistFree;
+	memory->userData = freelist;
+}
+
+
+
+/* Hands all blocks kept for reuse back to the backend */
+void uriFreelistRelease(UriFreelist * freelist) {
+	size_t i = 0;
+	for (; i < URI_FREELIST_CLASS_COUNT; i++) {
+		char * buffer = (char *)freelist->heads[i];
+		while (buffer != NULL) {
+			char * const next = *(char **)(buffer + sizeof(size_t));
+			freelist->backend->free(freelist->backend, buffer);
+			buffer = next;
+		}
+		freelist->heads[i] = NULL;
+	}
+}
+
+
+
+/* Heap block behind uriCreateFreelistMemoryManager */
+typedef struct UriFreelistManagerStruct {
+	UriMemoryManager memory;  /* must be first */
+	UriFreelist freelist;
+} UriFreelistManager;
+
+
+
+int uriCreateFreelistMemoryManager(UriMemoryManager ** memory,
+		UriMemoryManager * backend) {
+	UriFreelistManager * result;
+
+	if (memory == NULL) {
+		return URI_ERROR_NULL;
+	}
+
+	URI_CHECK_MEMORY_MANAGER(backend);  /* may return */
+
+	result = backend->malloc(backend, sizeof(UriFreelistManager));
+	if (result == NULL) {
+		return URI_ERROR_MALLOC;
+	}
+	uriFreelistInit(&(result->memory), &(result->freelist), backend);
+
+	*memory = &(result->memory);
+	return URI_SUCCESS;
+}
+
+
+
+void uriReleaseFreelistMemoryManager(UriMemoryManager * memory) {
+	if ((memory == NULL) || (memory->malloc != uriFreelistMalloc)) {
+		return;
+	}
+
+	uriFreelistRelease((UriFreelist *)memory->userData);
+}
+
+
+
+void uriFreeFreelistMemoryManager(UriMemoryManager * memory) {
+	UriMemoryManager * backend;
+
+	if ((memory == NULL) || (memory->malloc != uriFreelistMalloc)) {
+		return;
+	}
+
+	backend = ((UriFreelist *)memory->userData)->backend;
+	uriFreelistRelease((UriFreelist *)memory->userData);
+	backend->free(backend, (UriFreelistManager *)memory);
+}
+
+
+
+int uriCreateParserContext(UriParserContext ** context,
+		UriMemoryManager * memory) {
+	UriParserContext * result;
+
+	if (context == NULL) {
+		return URI_ERROR_NULL;
+	}
+
+	URI_CHECK_MEMORY_MANAGER(memory);  /* may return */
+
+	result = memory->malloc(memory, sizeof(UriParserContext));
+	if (result == NULL) {
+		return URI_ERROR_MALLOC;
+	}
+	uriFreelistInit(&(result->memory), &(result->freelist), memory);
+
+	*context = result;
+	return URI_SUCCESS;
+}
+
+
+
+void uriFreeParserContext(UriParserContext * context) {
+	UriMemoryManager * backend;
+
+	if (context == NULL) {
+		return;
+	}
+
+	backend = context->freelist.backend;
+	uriFreelistRelease(&(context->freelist));
+	backend->free(backend, context);
+}
+
+
+
+UriMemoryManager * uriGetParserContextMemoryManager(
+		UriParserContext * context) {
+	return (context != NULL) ? &(context->memory) : NULL;
+}
+
+
+
 /*extern*/ UriMemoryManager defaultMemoryManager = {
 	uriDefaultMalloc,
 	uriDefaultCalloc,
@@ -75,4 +75,27 @@ UriBool uriMemoryManagerIsComplete(const UriMemoryManager * memory);
 
 
 
+/* Size classes of the freelist memory manager, 16 to 64 bytes, enough
+ * for path segments, query list nodes and IP address structs */
+#define URI_FREELIST_CLASS_STEP   16
+#define URI_FREELIST_CLASS_COUNT  4
+
+typedef struct UriFreelistStruct {
+	UriMemoryManager * backend;
+	void * heads[URI_FREELIST_CLASS_COUNT];
+} UriFreelist;
+
+void uriFreelistInit(UriMemoryManager * memory, UriFreelist * freelist,
+		UriMemoryManager * backend);
+void uriFreelistRelease(UriFreelist * freelist);
+
+
+
+struct UriParserContextStruct {
+	UriMemoryManager memory;  /* freelist front end, validated */
+	UriFreelist freelist;
+};
+
+
+
 #endif /* URI_MEMORY_H */
@@ -81,13 +81,19 @@
 
 
 static int URI_FUNC(NormalizeSyntaxEngine)(URI_TYPE(Uri) * uri, unsigned int inMask,
-		unsigned int * outMask, UriMemoryManager * memory);
+		unsigned int * outMask, const UriSchemeProfile * profile,
+		UriMemoryManager * memory);
 
 static UriBool URI_FUNC(MakeRangeOwner)(unsigned int * doneMask,
 		unsigned int maskTest, URI_TYPE(TextRange) * range,
 		UriMemoryManager * memory);
 static UriBool URI_FUNC(MakeOwnerEngine)(URI_TYPE(Uri) * uri,
 		unsigned int * doneMask, UriMemoryManager * memory);
+static int URI_FUNC(CompactRangeLength)(const URI_TYPE(TextRange) * range);
+static void URI_FUNC(CompactRange)(URI_TYPE(TextRange) * range,
+		URI_CHAR ** write);
+static UriBool URI_FUNC(MakeOwnerCompactEngine)(URI_TYPE(Uri) * uri,
+		UriMemoryManager * memory);
 
 static void URI_FUNC(FixPercentEncodingInplace)(const URI_CHAR * first,
 		const URI_CHAR ** afterLast);
@@ -109,6 +115,10 @@ static UriBool URI_FUNC(LowercaseMalloc)(const URI_CHAR ** first,
 
 static void URI_FUNC(PreventLeakage)(URI_TYPE(Uri) * uri,
 		unsigned int revertMask, UriMemoryManager * memory);
+static UriBool URI_FUNC(IsCanonicalIpSixHost)(const URI_TYPE(Uri) * uri,
+		URI_CHAR * text, int * lenInChars);
+static UriBool URI_FUNC(IsLocalhost)(const URI_CHAR * first,
+		const URI_CHAR * afterLast);
 
 
 
@@ -134,10 +144,8 @@ static URI_INLINE void URI_FUNC(PreventLeakage)(URI_TYPE(Uri) * uri,
 			uri->hostData.ipFuture.afterLast = NULL;
 			uri->hostText.first = NULL;
 			uri->hostText.afterLast = NULL;
-		} else if ((uri->hostText.first != NULL)
-				&& (uri->hostData.ip4 == NULL)
-				&& (uri->hostData.ip6 == NULL)) {
-			/* Regname */
+		} else if (uri->hostText.first != NULL) {
+			/* Regname or text of IPv4/IPv6 */
 			memory->free(memory, (URI_CHAR *)uri->hostText.first);
 			uri->hostText.first = NULL;
 			uri->hostText.afterLast = NULL;
@@ -175,6 +183,42 @@ static URI_INLINE void URI_FUNC(PreventLeakage)(URI_TYPE(Uri) * uri,
 
 
 
+/* Writes the canonical text of an IPv6 host to text (see
+ * WriteIpSixAddress) and tells if the host text matches it already */
+static URI_INLINE UriBool URI_FUNC(IsCanonicalIpSixHost)(const URI_TYPE(Uri) * uri,
+		URI_CHAR * text, int * lenInChars) {
+	*lenInChars = URI_FUNC(WriteIpSixAddress)(text, uri->hostData.ip6->data);
+	if ((uri->hostText.first == NULL)
+			|| (uri->hostText.afterLast - uri->hostText.first != *lenInChars)) {
+		return URI_FALSE;
+	}
+	return (memcmp(uri->hostText.first, text, *lenInChars * sizeof(URI_CHAR)) == 0)
+			? URI_TRUE : URI_FALSE;
+}
+
+
+
+static URI_INLINE UriBool URI_FUNC(IsLocalhost)(const URI_CHAR * first,
+		const URI_CHAR * afterLast) {
+	const char * const localhost = "localhost";
+	int i = 0;
+	if ((first == NULL) || (afterLast - first != 9)) {
+		return URI_FALSE;
+	}
+	for (; i < 9; i++) {
+		URI_CHAR c = first[i];
+		if ((c >= _UT('A')) && (c <= _UT('Z'))) {
+			c = (URI_CHAR)(c + (_UT('a') - _UT('A')));
+		}
+		if (c != (URI_CHAR)localhost[i]) {
+			return URI_FALSE;
+		}
+	}
+	return URI_TRUE;
+}
+
+
+
 static URI_INLINE UriBool URI_FUNC(ContainsUppercaseLetters)(const URI_CHAR * first,
 		const URI_CHAR * afterLast) {
 	if ((first != NULL) && (afterLast != NULL) && (afterLast > first)) {
@@ -407,22 +451,19 @@ static URI_INLINE UriBool URI_FUNC(MakeOwnerEngine)(URI_TYPE(Uri) * uri,
 
 	/* Host */
 	if ((*doneMask & URI_NORMALIZE_HOST) == 0) {
-		if ((uri->hostData.ip4 == NULL)
-				&& (uri->hostData.ip6 == NULL)) {
-			if (uri->hostData.ipFuture.first != NULL) {
-				/* IPvFuture */
-				if (!URI_FUNC(MakeRangeOwner)(doneMask, URI_NORMALIZE_HOST,
-						&(uri->hostData.ipFuture), memory)) {
-					return URI_FALSE; /* Raises malloc error */
-				}
-				uri->hostText.first = uri->hostData.ipFuture.first;
-				uri->hostText.afterLast = uri->hostData.ipFuture.afterLast;
-			} else if (uri->hostText.first != NULL) {
-				/* Regname */
-				if (!URI_FUNC(MakeRangeOwner)(doneMask, URI_NORMALIZE_HOST,
-						&(uri->hostText), memory)) {
-					return URI_FALSE; /* Raises malloc error */
-				}
+		if (uri->hostData.ipFuture.first != NULL) {
+			/* IPvFuture */
+			if (!URI_FUNC(MakeRangeOwner)(doneMask, URI_NORMALIZE_HOST,
+					&(uri->hostData.ipFuture), memory)) {
+				return URI_FALSE; /* Raises malloc error */
+			}
+			uri->hostText.first = uri->hostData.ipFuture.first;
+			uri->hostText.afterLast = uri->hostData.ipFuture.afterLast;
+		} else if (uri->hostText.first != NULL) {
+			/* Regname or text of IPv4/IPv6 */
+			if (!URI_FUNC(MakeRangeOwner)(doneMask, URI_NORMALIZE_HOST,
+					&(uri->hostText), memory)) {
+				return URI_FALSE; /* Raises malloc error */
 			}
 		}
 	}
@@ -474,6 +515,95 @@ static URI_INLINE UriBool URI_FUNC(MakeOwnerEngine)(URI_TYPE(Uri) * uri,
 
 
 
+static URI_INLINE int URI_FUNC(CompactRangeLength)(
+		const URI_TYPE(TextRange) * range) {
+	if ((range->first == NULL) || (range->afterLast == NULL)
+			|| (range->afterLast <= range->first)) {
+		return 0;
+	}
+	return (int)(range->afterLast - range->first);
+}
+
+
+
+static URI_INLINE void URI_FUNC(CompactRange)(URI_TYPE(TextRange) * range,
+		URI_CHAR ** write) {
+	const int lenInChars = URI_FUNC(CompactRangeLength)(range);
+
+	/* NULL ranges stay NULL, empty ones move into the block, too */
+	if (range->first == NULL) {
+		return;
+	}
+
+	if (lenInChars > 0) {
+		memcpy(*write, range->first, lenInChars * sizeof(URI_CHAR));
+	}
+	range->first = *write;
+	range->afterLast = *write + lenInChars;
+	*write += lenInChars;
+}
+
+
+
+static URI_INLINE UriBool URI_FUNC(MakeOwnerCompactEngine)(URI_TYPE(Uri) * uri,
+		UriMemoryManager * memory) {
+	const UriBool ipFuture = (uri->hostData.ipFuture.first != NULL)
+			? URI_TRUE : URI_FALSE;
+	URI_TYPE(PathSegment) * walker;
+	URI_CHAR * block;
+	URI_CHAR * write;
+	int lenInChars = 0;
+
+	/* Measure */
+	lenInChars += URI_FUNC(CompactRangeLength)(&(uri->scheme));
+	lenInChars += URI_FUNC(CompactRangeLength)(&(uri->userInfo));
+	lenInChars += URI_FUNC(CompactRangeLength)(&(uri->hostText));
+	if (uri->hostData.ip6 != NULL) {
+		/* Room for rewriting to canonical form in place, see
+		 * URI_NORMALIZE_IP6 in NormalizeSyntaxEngine */
+		lenInChars += URI_IP6_TEXT_MAX_CHARS;
+	}
+	lenInChars += URI_FUNC(CompactRangeLength)(&(uri->portText));
+	for (walker = uri->pathHead; walker != NULL; walker = walker->next) {
+		lenInChars += URI_FUNC(CompactRangeLength)(&(walker->text));
+	}
+	lenInChars += URI_FUNC(CompactRangeLength)(&(uri->query));
+	lenInChars += URI_FUNC(CompactRangeLength)(&(uri->fragment));
+
+	/* Allocate at least one character so that the block pointer
+	 * can tell a compact owner apart from a regular one */
+	block = memory->malloc(memory,
+			((lenInChars > 0) ? lenInChars : 1) * sizeof(URI_CHAR));
+	if (block == NULL) {
+		return URI_FALSE; /* Raises malloc error */
+	}
+
+	/* Copy in URI order; unlike with uriMakeOwner* this includes
+	 * the host text of IPv4 and IPv6 hosts */
+	write = block;
+	URI_FUNC(CompactRange)(&(uri->scheme), &write);
+	URI_FUNC(CompactRange)(&(uri->userInfo), &write);
+	URI_FUNC(CompactRange)(&(uri->hostText), &write);
+	if (uri->hostData.ip6 != NULL) {
+		write += URI_IP6_TEXT_MAX_CHARS;
+	}
+	if (ipFuture) {
+		uri->hostData.ipFuture.first = uri->hostText.first;
+		uri->hostData.ipFuture.afterLast = uri->hostText.afterLast;
+	}
+	URI_FUNC(CompactRange)(&(uri->portText), &write);
+	for (walker = uri->pathHead; walker != NULL; walker = walker->next) {
+		URI_FUNC(CompactRange)(&(walker->text), &write);
+	}
+	URI_FUNC(CompactRange)(&(uri->query), &write);
+	URI_FUNC(CompactRange)(&(uri->fragment), &write);
+
+	uri->reserved = block;
+	return URI_TRUE;
+}
+
+
+
 unsigned int URI_FUNC(NormalizeSyntaxMaskRequired)(const URI_TYPE(Uri) * uri) {
 	unsigned int outMask = URI_NORMALIZED;  /* for NULL uri */
 	URI_FUNC(NormalizeSyntaxMaskRequiredEx)(uri, &outMask);
@@ -500,9 +630,10 @@ int URI_FUNC(NormalizeSyntaxMaskRequiredEx)(const URI_TYPE(Uri) * uri,
 		|| ((__GNUC__ == 4) && defined(__GNUC_MINOR__) && (__GNUC_MINOR__ >= 2)))
 	/* Slower code that fixes a warning, not sure if this is a smart idea */
 	memcpy(&writeableClone, uri, 1 * sizeof(URI_TYPE(Uri)));
-	URI_FUNC(NormalizeSyntaxEngine)(&writeableClone, 0, outMask, memory);
+	URI_FUNC(NormalizeSyntaxEngine)(&writeableClone, 0, outMask, NULL, memory);
 #else
-	URI_FUNC(NormalizeSyntaxEngine)((URI_TYPE(Uri) *)uri, 0, outMask, memory);
+	URI_FUNC(NormalizeSyntaxEngine)((URI_TYPE(Uri) *)uri, 0, outMask, NULL,
+			memory);
 #endif
 	return URI_SUCCESS;
 }
@@ -518,7 +649,39 @@ int URI_FUNC(NormalizeSyntaxEx)(URI_TYPE(Uri) * uri, unsigned int mask) {
 int URI_FUNC(NormalizeSyntaxExMm)(URI_TYPE(Uri) * uri, unsigned int mask,
 		UriMemoryManager * memory) {
 	URI_CHECK_MEMORY_MANAGER(memory);  /* may return */
-	return URI_FUNC(NormalizeSyntaxEngine)(uri, mask, NULL, memory);
+	if ((mask & ~(unsigned int)URI_NORMALIZE_ALL_DEFINED) != 0) {
+		/* Masks like (unsigned int)-1 predate URI_NORMALIZE_IP6 */
+		mask &= ~(unsigned int)URI_NORMALIZE_IP6;
+	}
+	return URI_FUNC(NormalizeSyntaxEngine)(uri,
+			mask & ~(unsigned int)URI_NORMALIZE_SCHEME_BASED, NULL, NULL,
+			memory);
+}
+
+
+
+int URI_FUNC(NormalizeSyntaxProfiled)(URI_TYPE(Uri) * uri, unsigned int mask,
+		const UriSchemeProfile * profiles, int profileCount) {
+	return URI_FUNC(NormalizeSyntaxProfiledMm)(uri, mask, profiles,
+			profileCount, NULL);
+}
+
+
+
+int URI_FUNC(NormalizeSyntaxProfiledMm)(URI_TYPE(Uri) * uri, unsigned int mask,
+		const UriSchemeProfile * profiles, int profileCount,
+		UriMemoryManager * memory) {
+	const UriSchemeProfile * profile;
+
+	if (uri == NULL) {
+		return URI_ERROR_NULL;
+	}
+
+	URI_CHECK_MEMORY_MANAGER(memory);  /* may return */
+
+	profile = URI_FUNC(FindSchemeProfile)(&(uri->scheme), profiles,
+			profileCount);
+	return URI_FUNC(NormalizeSyntaxEngine)(uri, mask, NULL, profile, memory);
 }
 
 
@@ -531,7 +694,7 @@ int URI_FUNC(NormalizeSyntax)(URI_TYPE(Uri) * uri) {
 
 static URI_INLINE int URI_FUNC(NormalizeSyntaxEngine)(URI_TYPE(Uri) * uri,
 		unsigned int inMask, unsigned int * outMask,
-		UriMemoryManager * memory) {
+		const UriSchemeProfile * profile, UriMemoryManager * memory) {
 	unsigned int doneMask = URI_NORMALIZED;
 
 	/* Not just doing inspection? -> memory manager required! */
@@ -556,6 +719,11 @@ static URI_INLINE int URI_FUNC(NormalizeSyntaxEngine)(URI_TYPE(Uri) * uri,
 		return URI_SUCCESS;
 	}
 
+	/* Dot segment removal needs the path split up */
+	if ((outMask == NULL) && !URI_FUNC(MaterializePath)(uri, memory)) {
+		return URI_ERROR_MALLOC;
+	}
+
 	/* Scheme, host */
 	if (outMask != NULL) {
 		const UriBool normalizeScheme = URI_FUNC(ContainsUppercaseLetters)(
@@ -575,6 +743,7 @@ static URI_INLINE int URI_FUNC(NormalizeSyntaxEngine)(URI_TYPE(Uri) * uri,
 				*outMask |= URI_NORMALIZE_HOST;
 			}
 		}
+
 	} else {
 		/* Scheme */
 		if ((inMask & URI_NORMALIZE_SCHEME) && (uri->scheme.first != NULL)) {
@@ -628,6 +797,37 @@ static URI_INLINE int URI_FUNC(NormalizeSyntaxEngine)(URI_TYPE(Uri) * uri,
 						uri->hostText.afterLast);
 			}
 		}
+
+		/* IPv6 host text */
+		if ((inMask & URI_NORMALIZE_IP6) && (uri->hostData.ip6 != NULL)) {
+			URI_CHAR text[URI_IP6_TEXT_MAX_CHARS];
+			int lenInChars;
+			if (!URI_FUNC(IsCanonicalIpSixHost)(uri, text, &lenInChars)) {
+				const int oldLenInChars = (int)(uri->hostText.afterLast
+						- uri->hostText.first);
+				if (uri->owner && ((lenInChars <= oldLenInChars)
+						|| URI_FUNC(IsCompactOwner)(uri))) {
+					/* Compact owners have room for the longest form */
+					memcpy((URI_CHAR *)uri->hostText.first, text,
+							lenInChars * sizeof(URI_CHAR));
+				} else {
+					URI_CHAR * const dup = memory->malloc(memory,
+							lenInChars * sizeof(URI_CHAR));
+					if (dup == NULL) {
+						URI_FUNC(PreventLeakage)(uri, doneMask, memory);
+						return URI_ERROR_MALLOC;
+					}
+					memcpy(dup, text, lenInChars * sizeof(URI_CHAR));
+					if (uri->owner) {
+						memory->free(memory, (URI_CHAR *)uri->hostText.first);
+					} else {
+						doneMask |= URI_NORMALIZE_HOST;
+					}
+					uri->hostText.first = dup;
+				}
+				uri->hostText.afterLast = uri->hostText.first + lenInChars;
+			}
+		}
 	}
 
 	/* User info */
@@ -654,10 +854,12 @@ static URI_INLINE int URI_FUNC(NormalizeSyntaxEngine)(URI_TYPE(Uri) * uri,
 
 	/* Path */
 	if (outMask != NULL) {
-		const URI_TYPE(PathSegment) * walker = uri->pathHead;
-		while (walker != NULL) {
-			const URI_CHAR * const first = walker->text.first;
-			const URI_CHAR * const afterLast = walker->text.afterLast;
+		URI_TYPE(PathIterator) iterator;
+		const URI_TYPE(TextRange) * walker;
+		URI_FUNC(PathIteratorBegin)(&iterator, uri);
+		while ((walker = URI_FUNC(PathIteratorNext)(&iterator)) != NULL) {
+			const URI_CHAR * const first = walker->first;
+			const URI_CHAR * const afterLast = walker->afterLast;
 			if ((first != NULL)
 					&& (afterLast != NULL)
 					&& (afterLast > first)
@@ -674,7 +876,6 @@ static URI_INLINE int URI_FUNC(NormalizeSyntaxEngine)(URI_TYPE(Uri) * uri,
 				*outMask |= URI_NORMALIZE_PATH;
 				break;
 			}
-			walker = walker->next;
 		}
 	} else if (inMask & URI_NORMALIZE_PATH) {
 		URI_TYPE(PathSegment) * walker;
@@ -702,7 +903,7 @@ static URI_INLINE int URI_FUNC(NormalizeSyntaxEngine)(URI_TYPE(Uri) * uri,
 
 		/* 6.2.2.3 Path Segment Normalization */
 		if (!URI_FUNC(RemoveDotSegmentsEx)(uri, relative,
-				(uri->owner == URI_TRUE)
+				((uri->owner == URI_TRUE) && !URI_FUNC(IsCompactOwner)(uri))
 				|| ((doneMask & URI_NORMALIZE_PATH) != 0),
 				memory)) {
 			URI_FUNC(PreventLeakage)(uri, doneMask, memory);
@@ -754,6 +955,71 @@ static URI_INLINE int URI_FUNC(NormalizeSyntaxEngine)(URI_TYPE(Uri) * uri,
 		}
 	}
 
+	/* Scheme-based normalization, section 6.2.3 of RFC 3986 */
+	if ((outMask == NULL) && (inMask & URI_NORMALIZE_SCHEME_BASED)) {
+		const UriBool ownsPieces = uri->owner && !URI_FUNC(IsCompactOwner)(uri);
+		const unsigned int flags = (profile != NULL) ? profile->flags : 0;
+
+		/* Port, empty or default */
+		if ((inMask & URI_NORMALIZE_PORT)
+				&& (uri->portText.first != NULL)
+				&& ((uri->portText.first == uri->portText.afterLast)
+					|| ((profile != NULL) && (profile->defaultPort >= 0)
+						&& (URI_FUNC(ParsePortNumber)(&(uri->portText))
+							== profile->defaultPort)))) {
+			if (ownsPieces && (uri->portText.first != uri->portText.afterLast)) {
+				memory->free(memory, (URI_CHAR *)uri->portText.first);
+			}
+			uri->portText.first = NULL;
+			uri->portText.afterLast = NULL;
+		}
+
+		/* Host "localhost" */
+		if ((inMask & URI_NORMALIZE_LOCALHOST)
+				&& (flags & URI_SCHEME_LOCALHOST_IS_EMPTY)
+				&& (uri->userInfo.first == NULL)
+				&& (uri->portText.first == NULL)
+				&& (uri->hostData.ipFuture.first == NULL)
+				&& URI_FUNC(IsLocalhost)(uri->hostText.first,
+					uri->hostText.afterLast)) {
+			if (ownsPieces || (doneMask & URI_NORMALIZE_HOST)) {
+				memory->free(memory, (URI_CHAR *)uri->hostText.first);
+				doneMask &= ~(unsigned int)URI_NORMALIZE_HOST;
+			}
+			uri->hostText.first = URI_FUNC(SafeToPointTo);
+			uri->hostText.afterLast = URI_FUNC(SafeToPointTo);
+		}
+
+		/* Empty path */
+		if ((inMask & URI_NORMALIZE_EMPTY_PATH)
+				&& (flags & URI_SCHEME_EMPTY_PATH_IS_SLASH)
+				&& (uri->pathHead == NULL)
+				&& URI_FUNC(IsHostSet)(uri)) {
+			URI_TYPE(PathSegment) * const segment = memory->malloc(memory,
+					1 * sizeof(URI_TYPE(PathSegment)));
+			if (segment == NULL) {
+				URI_FUNC(PreventLeakage)(uri, doneMask, memory);
+				return URI_ERROR_MALLOC;
+			}
+			segment->text.first = URI_FUNC(SafeToPointTo);
+			segment->text.afterLast = URI_FUNC(SafeToPointTo);
+			segment->next = NULL;
+			segment->reserved = NULL;
+			uri->pathHead = segment;
+			uri->pathTail = segment;
+		}
+
+		/* Empty query */
+		if ((inMask & URI_NORMALIZE_EMPTY_QUERY)
+				&& (flags & URI_SCHEME_EMPTY_QUERY_IS_NONE)
+				&& (uri->query.first != NULL)
+				&& (uri->query.first == uri->query.afterLast)) {
+			uri->query.first = NULL;
+			uri->query.afterLast = NULL;
+			doneMask &= ~(unsigned int)URI_NORMALIZE_QUERY;
+		}
+	}
+
 	/* Dup all not duped yet */
 	if ((outMask == NULL) && !uri->owner) {
 		if (!URI_FUNC(MakeOwnerEngine)(uri, &doneMask, memory)) {
@@ -799,4 +1065,33 @@ int URI_FUNC(MakeOwner)(URI_TYPE(Uri) * uri) {
 
 
 
+int URI_FUNC(MakeOwnerCompactMm)(URI_TYPE(Uri) * uri,
+		UriMemoryManager * memory) {
+	URI_CHECK_MEMORY_MANAGER(memory);  /* may return */
+
+	if (uri == NULL) {
+		return URI_ERROR_NULL;
+	}
+
+	if (uri->owner == URI_TRUE) {
+		return URI_SUCCESS;
+	}
+
+	if (! URI_FUNC(MakeOwnerCompactEngine)(uri, memory)) {
+		return URI_ERROR_MALLOC;
+	}
+
+	uri->owner = URI_TRUE;
+
+	return URI_SUCCESS;
+}
+
+
+
+int URI_FUNC(MakeOwnerCompact)(URI_TYPE(Uri) * uri) {
+	return URI_FUNC(MakeOwnerCompactMm)(uri, NULL);
+}
+
+
+
 #endif
@@ -43,6 +43,32 @@
 
 
 
+static const UriSchemeProfile uriDefaultSchemeProfiles[] = {
+	{ "file", -1, URI_SCHEME_EMPTY_PATH_IS_SLASH
+			| URI_SCHEME_LOCALHOST_IS_EMPTY },
+	{ "ftp", 21, URI_SCHEME_EMPTY_PATH_IS_SLASH },
+	{ "http", 80, URI_SCHEME_EMPTY_PATH_IS_SLASH
+			| URI_SCHEME_EMPTY_QUERY_IS_NONE },
+	{ "https", 443, URI_SCHEME_EMPTY_PATH_IS_SLASH
+			| URI_SCHEME_EMPTY_QUERY_IS_NONE },
+	{ "ws", 80, URI_SCHEME_EMPTY_PATH_IS_SLASH
+			| URI_SCHEME_EMPTY_QUERY_IS_NONE },
+	{ "wss", 443, URI_SCHEME_EMPTY_PATH_IS_SLASH
+			| URI_SCHEME_EMPTY_QUERY_IS_NONE }
+};
+
+
+
+const UriSchemeProfile * uriGetDefaultSchemeProfiles(int * count) {
+	if (count != NULL) {
+		*count = (int)(sizeof(uriDefaultSchemeProfiles)
+				/ sizeof(uriDefaultSchemeProfiles[0]));
+	}
+	return uriDefaultSchemeProfiles;
+}
+
+
+
 UriBool uriIsUnreserved(int code) {
 	switch (code) {
 	case L'a': /* ALPHA */
@@ -46,6 +46,18 @@
 
 
 
+/* Mask bits only honored with a scheme profile */
+#define URI_NORMALIZE_SCHEME_BASED  (URI_NORMALIZE_PORT \
+		| URI_NORMALIZE_EMPTY_PATH \
+		| URI_NORMALIZE_EMPTY_QUERY \
+		| URI_NORMALIZE_LOCALHOST)
+
+/* All mask bits defined so far */
+#define URI_NORMALIZE_ALL_DEFINED  ((((unsigned int)URI_NORMALIZE_LOCALHOST) \
+		<< 1) - 1)
+
+
+
 UriBool uriIsUnreserved(int code);
 
 
@@ -164,6 +164,7 @@ static const URI_CHAR * URI_FUNC(ParseIpFutLoop)(URI_TYPE(ParserState) * state,
 static const URI_CHAR * URI_FUNC(ParseIpFutStopGo)(URI_TYPE(ParserState) * state, const URI_CHAR * first, const URI_CHAR * afterLast, UriMemoryManager * memory);
 static const URI_CHAR * URI_FUNC(ParseIpLit2)(URI_TYPE(ParserState) * state, const URI_CHAR * first, const URI_CHAR * afterLast, UriMemoryManager * memory);
 static const URI_CHAR * URI_FUNC(ParseIPv6address2)(URI_TYPE(ParserState) * state, const URI_CHAR * first, const URI_CHAR * afterLast, UriMemoryManager * memory);
+static const URI_CHAR * URI_FUNC(ParseIpSixAddressEngine)(unsigned char * octetOutput, const URI_CHAR * first, const URI_CHAR * afterLast, const URI_CHAR ** errorPos);
 static const URI_CHAR * URI_FUNC(ParseMustBeSegmentNzNc)(URI_TYPE(ParserState) * state, const URI_CHAR * first, const URI_CHAR * afterLast, UriMemoryManager * memory);
 static const URI_CHAR * URI_FUNC(ParseOwnHost)(URI_TYPE(ParserState) * state, const URI_CHAR * first, const URI_CHAR * afterLast, UriMemoryManager * memory);
 static const URI_CHAR * URI_FUNC(ParseOwnHost2)(URI_TYPE(ParserState) * state, const URI_CHAR * first, const URI_CHAR * afterLast, UriMemoryManager * memory);
@@ -188,6 +189,7 @@ static const URI_CHAR * URI_FUNC(ParseUriTail)(URI_TYPE(ParserState) * state, co
 static const URI_CHAR * URI_FUNC(ParseUriTailTwo)(URI_TYPE(ParserState) * state, const URI_CHAR * first, const URI_CHAR * afterLast, UriMemoryManager * memory);
 static const URI_CHAR * URI_FUNC(ParseZeroMoreSlashSegs)(URI_TYPE(ParserState) * state, const URI_CHAR * first, const URI_CHAR * afterLast, UriMemoryManager * memory);
 
+static UriBool URI_FUNC(OnExitHostIpFour)(URI_TYPE(ParserState) * state, UriMemoryManager * memory);
 static UriBool URI_FUNC(OnExitOwnHost2)(URI_TYPE(ParserState) * state, const URI_CHAR * first, UriMemoryManager * memory);
 static UriBool URI_FUNC(OnExitOwnHostUserInfo)(URI_TYPE(ParserState) * state, const URI_CHAR * first, UriMemoryManager * memory);
 static UriBool URI_FUNC(OnExitOwnPortUserInfo)(URI_TYPE(ParserState) * state, const URI_CHAR * first, UriMemoryManager * memory);
@@ -205,13 +207,19 @@ static void URI_FUNC(StopMalloc)(URI_TYPE(ParserState) * state, UriMemoryManager
 
 static int URI_FUNC(ParseUriExMm)(URI_TYPE(ParserState) * state,
 		const URI_CHAR * first, const URI_CHAR * afterLast,
+		UriBool lazyPath, UriMemoryManager * memory);
+static int URI_FUNC(ParseSingleUriEngine)(URI_TYPE(Uri) * uri,
+		const URI_CHAR * first, const URI_CHAR * afterLast,
+		const URI_CHAR ** errorPos, UriBool lazyPath,
+		UriMemoryManager * memory);
+static void URI_FUNC(FreeUriMembersEngine)(URI_TYPE(Uri) * uri,
 		UriMemoryManager * memory);
 
 
 
 static URI_INLINE void URI_FUNC(StopSyntax)(URI_TYPE(ParserState) * state,
 		const URI_CHAR * errorPos, UriMemoryManager * memory) {
-	URI_FUNC(FreeUriMembersMm)(state->uri, memory);
+	URI_FUNC(FreeUriMembersEngine)(state->uri, memory);
 	state->errorPos = errorPos;
 	state->errorCode = URI_ERROR_SYNTAX;
 }
@@ -219,7 +227,7 @@ static URI_INLINE void URI_FUNC(StopSyntax)(URI_TYPE(ParserState) * state,
 
 
 static URI_INLINE void URI_FUNC(StopMalloc)(URI_TYPE(ParserState) * state, UriMemoryManager * memory) {
-	URI_FUNC(FreeUriMembersMm)(state->uri, memory);
+	URI_FUNC(FreeUriMembersEngine)(state->uri, memory);
 	state->errorPos = NULL;
 	state->errorCode = URI_ERROR_MALLOC;
 }
@@ -561,11 +569,6 @@ static URI_INLINE const URI_CHAR * URI_FUNC(ParseIpLit2)(
 	case _UT(':'):
 	case _UT(']'):
 	case URI_SET_HEXDIG:
-		state->uri->hostData.ip6 = memory->malloc(memory, 1 * sizeof(UriIp6)); /* Freed when stopping on parse error */
-		if (state->uri->hostData.ip6 == NULL) {
-			URI_FUNC(StopMalloc)(state, memory);
-			return NULL;
-		}
 		return URI_FUNC(ParseIPv6address2)(state, first, afterLast, memory);
 
 	default:
@@ -583,6 +586,39 @@ static const URI_CHAR * URI_FUNC(ParseIPv6address2)(
 		URI_TYPE(ParserState) * state,
 		const URI_CHAR * first, const URI_CHAR * afterLast,
 		UriMemoryManager * memory) {
+	unsigned char octets[16];
+	const URI_CHAR * errorPos = NULL;
+	const URI_CHAR * const closingBracket = URI_FUNC(ParseIpSixAddressEngine)(
+			octets, first, afterLast, &errorPos);
+	if (closingBracket == NULL) {
+		URI_FUNC(StopSyntax)(state, errorPos, memory);
+		return NULL;
+	}
+
+	/* Allocate only once the address is known to be valid */
+	state->uri->hostData.ip6 = memory->malloc(memory, 1 * sizeof(UriIp6)); /* Freed when stopping on parse error */
+	if (state->uri->hostData.ip6 == NULL) {
+		URI_FUNC(StopMalloc)(state, memory);
+		return NULL;
+	}
+	memcpy(state->uri->hostData.ip6->data, octets, sizeof(octets));
+
+	state->uri->hostText.afterLast = closingBracket; /* HOST END */
+	return closingBracket + 1;
+}
+
+
+
+/*
+ * Parses IPv6 address text up to and excluding the closing bracket
+ * into octetOutput, without touching any parser state.
+ * Returns the position of the closing bracket, or NULL
+ * with *errorPos pointing to the offending character.
+ */
+static const URI_CHAR * URI_FUNC(ParseIpSixAddressEngine)(
+		unsigned char * octetOutput,
+		const URI_CHAR * first, const URI_CHAR * afterLast,
+		const URI_CHAR ** errorPos) {
 	int zipperEver = 0;
 	int quadsDone = 0;
 	int digitCount = 0;
@@ -595,7 +631,7 @@ static const URI_CHAR * URI_FUNC(ParseIPv6address2)(
 
 	for (;;) {
 		if (first >= afterLast) {
-			URI_FUNC(StopSyntax)(state, afterLast, memory);
+			*errorPos = afterLast;
 			return NULL;
 		}
 
@@ -606,7 +642,7 @@ static const URI_CHAR * URI_FUNC(ParseIPv6address2)(
 				switch (*first) {
 				case URI_SET_DIGIT:
 					if (digitCount == 4) {
-						URI_FUNC(StopSyntax)(state, first, memory);
+						*errorPos = first;
 						return NULL;
 					}
 					digitHistory[digitCount++] = (unsigned char)(9 + *first - _UT('9'));
@@ -617,17 +653,17 @@ static const URI_CHAR * URI_FUNC(ParseIPv6address2)(
 							|| (digitCount == 0)
 							|| (digitCount == 4)) {
 						/* Invalid digit or octet count */
-						URI_FUNC(StopSyntax)(state, first, memory);
+						*errorPos = first;
 						return NULL;
 					} else if ((digitCount > 1)
 							&& (digitHistory[0] == 0)) {
 						/* Leading zero */
-						URI_FUNC(StopSyntax)(state, first - digitCount, memory);
+						*errorPos = first - digitCount;
 						return NULL;
 					} else if ((digitCount > 2)
 							&& (digitHistory[1] == 0)) {
 						/* Leading zero */
-						URI_FUNC(StopSyntax)(state, first - digitCount + 1, memory);
+						*errorPos = first - digitCount + 1;
 						return NULL;
 					} else if ((digitCount == 3)
 							&& (100 * digitHistory[0]
@@ -635,17 +671,17 @@ static const URI_CHAR * URI_FUNC(ParseIPv6address2)(
 								+ digitHistory[2] > 255)) {
 						/* Octet value too large */
 						if (digitHistory[0] > 2) {
-							URI_FUNC(StopSyntax)(state, first - 3, memory);
+							*errorPos = first - 3;
 						} else if (digitHistory[1] > 5) {
-							URI_FUNC(StopSyntax)(state, first - 2, memory);
+							*errorPos = first - 2;
 						} else {
-							URI_FUNC(StopSyntax)(state, first - 1, memory);
+							*errorPos = first - 1;
 						}
 						return NULL;
 					}
 
 					/* Copy IPv4 octet */
-					state->uri->hostData.ip6->data[16 - 4 + ip4OctetsDone] = uriGetOctetValue(digitHistory, digitCount);
+					octetOutput[16 - 4 + ip4OctetsDone] = uriGetOctetValue(digitHistory, digitCount);
 					digitCount = 0;
 					ip4OctetsDone++;
 					break;
@@ -655,17 +691,17 @@ static const URI_CHAR * URI_FUNC(ParseIPv6address2)(
 							|| (digitCount == 0)
 							|| (digitCount == 4)) {
 						/* Invalid digit or octet count */
-						URI_FUNC(StopSyntax)(state, first, memory);
+						*errorPos = first;
 						return NULL;
 					} else if ((digitCount > 1)
 							&& (digitHistory[0] == 0)) {
 						/* Leading zero */
-						URI_FUNC(StopSyntax)(state, first - digitCount, memory);
+						*errorPos = first - digitCount;
 						return NULL;
 					} else if ((digitCount > 2)
 							&& (digitHistory[1] == 0)) {
 						/* Leading zero */
-						URI_FUNC(StopSyntax)(state, first - digitCount + 1, memory);
+						*errorPos = first - digitCount + 1;
 						return NULL;
 					} else if ((digitCount == 3)
 							&& (100 * digitHistory[0]
@@ -673,34 +709,32 @@ static const URI_CHAR * URI_FUNC(ParseIPv6address2)(
 								+ digitHistory[2] > 255)) {
 						/* Octet value too large */
 						if (digitHistory[0] > 2) {
-							URI_FUNC(StopSyntax)(state, first - 3, memory);
+							*errorPos = first - 3;
 						} else if (digitHistory[1] > 5) {
-							URI_FUNC(StopSyntax)(state, first - 2, memory);
+							*errorPos = first - 2;
 						} else {
-							URI_FUNC(StopSyntax)(state, first - 1, memory);
+							*errorPos = first - 1;
 						}
 						return NULL;
 					}
 
-					state->uri->hostText.afterLast = first; /* HOST END */
-
 					/* Copy missing quads right before IPv4 */
-					memcpy(state->uri->hostData.ip6->data + 16 - 4 - 2 * quadsAfterZipperCount,
+					memcpy(octetOutput + 16 - 4 - 2 * quadsAfterZipperCount,
 								quadsAfterZipper, 2 * quadsAfterZipperCount);
 
 					/* Copy last IPv4 octet */
-					state->uri->hostData.ip6->data[16 - 4 + 3] = uriGetOctetValue(digitHistory, digitCount);
+					octetOutput[16 - 4 + 3] = uriGetOctetValue(digitHistory, digitCount);
 
-					return first + 1;
+					return first;
 
 				default:
-					URI_FUNC(StopSyntax)(state, first, memory);
+					*errorPos = first;
 					return NULL;
 				}
 				first++;
 
 				if (first >= afterLast) {
-					URI_FUNC(StopSyntax)(state, afterLast, memory);
+					*errorPos = afterLast;
 					return NULL;
 				}
 			}
@@ -713,7 +747,7 @@ static const URI_CHAR * URI_FUNC(ParseIPv6address2)(
 				case URI_SET_HEX_LETTER_LOWER:
 					letterAmong = 1;
 					if (digitCount == 4) {
-						URI_FUNC(StopSyntax)(state, first, memory);
+						*errorPos = first;
 						return NULL;
 					}
 					digitHistory[digitCount] = (unsigned char)(15 + *first - _UT('f'));
@@ -723,7 +757,7 @@ static const URI_CHAR * URI_FUNC(ParseIPv6address2)(
 				case URI_SET_HEX_LETTER_UPPER:
 					letterAmong = 1;
 					if (digitCount == 4) {
-						URI_FUNC(StopSyntax)(state, first, memory);
+						*errorPos = first;
 						return NULL;
 					}
 					digitHistory[digitCount] = (unsigned char)(15 + *first - _UT('F'));
@@ -732,7 +766,7 @@ static const URI_CHAR * URI_FUNC(ParseIPv6address2)(
 
 				case URI_SET_DIGIT:
 					if (digitCount == 4) {
-						URI_FUNC(StopSyntax)(state, first, memory);
+						*errorPos = first;
 						return NULL;
 					}
 					digitHistory[digitCount] = (unsigned char)(9 + *first - _UT('9'));
@@ -748,7 +782,7 @@ static const URI_CHAR * URI_FUNC(ParseIPv6address2)(
 								uriWriteQuadToDoubleByte(digitHistory, digitCount, quadsAfterZipper + 2 * quadsAfterZipperCount);
 								quadsAfterZipperCount++;
 							} else {
-								uriWriteQuadToDoubleByte(digitHistory, digitCount, state->uri->hostData.ip6->data + 2 * quadsDone);
+								uriWriteQuadToDoubleByte(digitHistory, digitCount, octetOutput + 2 * quadsDone);
 							}
 							quadsDone++;
 							digitCount = 0;
@@ -757,13 +791,13 @@ static const URI_CHAR * URI_FUNC(ParseIPv6address2)(
 
 						/* Too many quads? */
 						if (quadsDone >= 8 - zipperEver) {
-							URI_FUNC(StopSyntax)(state, first, memory);
+							*errorPos = first;
 							return NULL;
 						}
 
 						/* "::"? */
 						if (first + 1 >= afterLast) {
-							URI_FUNC(StopSyntax)(state, afterLast, memory);
+							*errorPos = afterLast;
 							return NULL;
 						}
 						if (first[1] == _UT(':')) {
@@ -771,21 +805,21 @@ static const URI_CHAR * URI_FUNC(ParseIPv6address2)(
 
 							first++;
 							if (zipperEver) {
-								URI_FUNC(StopSyntax)(state, first, memory);
+								*errorPos = first;
 								return NULL; /* "::.+::" */
 							}
 
 							/* Zero everything after zipper */
-							memset(state->uri->hostData.ip6->data + resetOffset, 0, 16 - resetOffset);
+							memset(octetOutput + resetOffset, 0, 16 - resetOffset);
 							setZipper = 1;
 
 							/* ":::+"? */
 							if (first + 1 >= afterLast) {
-								URI_FUNC(StopSyntax)(state, afterLast, memory);
+								*errorPos = afterLast;
 								return NULL; /* No ']' yet */
 							}
 							if (first[1] == _UT(':')) {
-								URI_FUNC(StopSyntax)(state, first + 1, memory);
+								*errorPos = first + 1;
 								return NULL; /* ":::+ "*/
 							}
 						}
@@ -803,17 +837,17 @@ static const URI_CHAR * URI_FUNC(ParseIPv6address2)(
 							|| (digitCount == 0)
 							|| (digitCount == 4)) {
 						/* Invalid octet before */
-						URI_FUNC(StopSyntax)(state, first, memory);
+						*errorPos = first;
 						return NULL;
 					} else if ((digitCount > 1)
 							&& (digitHistory[0] == 0)) {
 						/* Leading zero */
-						URI_FUNC(StopSyntax)(state, first - digitCount, memory);
+						*errorPos = first - digitCount;
 						return NULL;
 					} else if ((digitCount > 2)
 							&& (digitHistory[1] == 0)) {
 						/* Leading zero */
-						URI_FUNC(StopSyntax)(state, first - digitCount + 1, memory);
+						*errorPos = first - digitCount + 1;
 						return NULL;
 					} else if ((digitCount == 3)
 							&& (100 * digitHistory[0]
@@ -821,17 +855,17 @@ static const URI_CHAR * URI_FUNC(ParseIPv6address2)(
 								+ digitHistory[2] > 255)) {
 						/* Octet value too large */
 						if (digitHistory[0] > 2) {
-							URI_FUNC(StopSyntax)(state, first - 3, memory);
+							*errorPos = first - 3;
 						} else if (digitHistory[1] > 5) {
-							URI_FUNC(StopSyntax)(state, first - 2, memory);
+							*errorPos = first - 2;
 						} else {
-							URI_FUNC(StopSyntax)(state, first - 1, memory);
+							*errorPos = first - 1;
 						}
 						return NULL;
 					}
 
 					/* Copy first IPv4 octet */
-					state->uri->hostData.ip6->data[16 - 4] = uriGetOctetValue(digitHistory, digitCount);
+					octetOutput[16 - 4] = uriGetOctetValue(digitHistory, digitCount);
 					digitCount = 0;
 
 					/* Switch over to IPv4 loop */
@@ -842,7 +876,7 @@ static const URI_CHAR * URI_FUNC(ParseIPv6address2)(
 				case _UT(']'):
 					/* Too little quads? */
 					if (!zipperEver && !((quadsDone == 7) && (digitCount > 0))) {
-						URI_FUNC(StopSyntax)(state, first, memory);
+						*errorPos = first;
 						return NULL;
 					}
 
@@ -851,7 +885,7 @@ static const URI_CHAR * URI_FUNC(ParseIPv6address2)(
 							uriWriteQuadToDoubleByte(digitHistory, digitCount, quadsAfterZipper + 2 * quadsAfterZipperCount);
 							quadsAfterZipperCount++;
 						} else {
-							uriWriteQuadToDoubleByte(digitHistory, digitCount, state->uri->hostData.ip6->data + 2 * quadsDone);
+							uriWriteQuadToDoubleByte(digitHistory, digitCount, octetOutput + 2 * quadsDone);
 						}
 						/*
 						quadsDone++;
@@ -860,20 +894,19 @@ static const URI_CHAR * URI_FUNC(ParseIPv6address2)(
 					}
 
 					/* Copy missing quads to the end */
-					memcpy(state->uri->hostData.ip6->data + 16 - 2 * quadsAfterZipperCount,
+					memcpy(octetOutput + 16 - 2 * quadsAfterZipperCount,
 								quadsAfterZipper, 2 * quadsAfterZipperCount);
 
-					state->uri->hostText.afterLast = first; /* HOST END */
-					return first + 1; /* Fine */
+					return first; /* Fine */
 
 				default:
-					URI_FUNC(StopSyntax)(state, first, memory);
+					*errorPos = first;
 					return NULL;
 				}
 				first++;
 
 				if (first >= afterLast) {
-					URI_FUNC(StopSyntax)(state, afterLast, memory);
+					*errorPos = afterLast;
 					return NULL; /* No ']' yet */
 				}
 			} while (walking);
@@ -1002,27 +1035,41 @@ static URI_INLINE const URI_CHAR * URI_FUNC(ParseOwnHost)(
 
 
 
-static URI_INLINE UriBool URI_FUNC(OnExitOwnHost2)(
-		URI_TYPE(ParserState) * state, const URI_CHAR * first,
-		UriMemoryManager * memory) {
-	state->uri->hostText.afterLast = first; /* HOST END */
+/*
+ * Checks whether the host text is a valid IPv4 address and
+ * if so stores its octets. Memory is only allocated for actual
+ * IPv4 addresses so that reg-names come at no allocation cost.
+ */
+static URI_INLINE UriBool URI_FUNC(OnExitHostIpFour)(
+		URI_TYPE(ParserState) * state, UriMemoryManager * memory) {
+	unsigned char octets[4];
 
 	/* Valid IPv4 or just a regname? */
+	if (URI_FUNC(ParseIpFourAddress)(octets,
+			state->uri->hostText.first, state->uri->hostText.afterLast)) {
+		return URI_TRUE; /* Not IPv4 */
+	}
+
 	state->uri->hostData.ip4 = memory->malloc(memory, 1 * sizeof(UriIp4)); /* Freed when stopping on parse error */
 	if (state->uri->hostData.ip4 == NULL) {
 		return URI_FALSE; /* Raises malloc error */
 	}
-	if (URI_FUNC(ParseIpFourAddress)(state->uri->hostData.ip4->data,
-			state->uri->hostText.first, state->uri->hostText.afterLast)) {
-		/* Not IPv4 */
-		memory->free(memory, state->uri->hostData.ip4);
-		state->uri->hostData.ip4 = NULL;
-	}
+	memcpy(state->uri->hostData.ip4->data, octets, sizeof(octets));
 	return URI_TRUE; /* Success */
 }
 
 
 
+static URI_INLINE UriBool URI_FUNC(OnExitOwnHost2)(
+		URI_TYPE(ParserState) * state, const URI_CHAR * first,
+		UriMemoryManager * memory) {
+	state->uri->hostText.afterLast = first; /* HOST END */
+
+	return URI_FUNC(OnExitHostIpFour)(state, memory);
+}
+
+
+
 /*
  * [ownHost2]->[authorityTwo] // can take <NULL>
  * [ownHost2]->[pctSubUnres][ownHost2]
@@ -1084,18 +1131,7 @@ static URI_INLINE UriBool URI_FUNC(OnExitOwnHostUserInfo)(
 	state->uri->userInfo.first = NULL; /* Not a userInfo, reset */
 	state->uri->hostText.afterLast = first; /* HOST END */
 
-	/* Valid IPv4 or just a regname? */
-	state->uri->hostData.ip4 = memory->malloc(memory, 1 * sizeof(UriIp4)); /* Freed when stopping on parse error */
-	if (state->uri->hostData.ip4 == NULL) {
-		return URI_FALSE; /* Raises malloc error */
-	}
-	if (URI_FUNC(ParseIpFourAddress)(state->uri->hostData.ip4->data,
-			state->uri->hostText.first, state->uri->hostText.afterLast)) {
-		/* Not IPv4 */
-		memory->free(memory, state->uri->hostData.ip4);
-		state->uri->hostData.ip4 = NULL;
-	}
-	return URI_TRUE; /* Success */
+	return URI_FUNC(OnExitHostIpFour)(state, memory);
 }
 
 
@@ -1215,18 +1251,7 @@ static URI_INLINE UriBool URI_FUNC(OnExitOwnPortUserInfo)(
 	state->uri->userInfo.first = NULL; /* Not a userInfo, reset */
 	state->uri->portText.afterLast = first; /* PORT END */
 
-	/* Valid IPv4 or just a regname? */
-	state->uri->hostData.ip4 = memory->malloc(memory, 1 * sizeof(UriIp4)); /* Freed when stopping on parse error */
-	if (state->uri->hostData.ip4 == NULL) {
-		return URI_FALSE; /* Raises malloc error */
-	}
-	if (URI_FUNC(ParseIpFourAddress)(state->uri->hostData.ip4->data,
-			state->uri->hostText.first, state->uri->hostText.afterLast)) {
-		/* Not IPv4 */
-		memory->free(memory, state->uri->hostData.ip4);
-		state->uri->hostData.ip4 = NULL;
-	}
-	return URI_TRUE; /* Success */
+	return URI_FUNC(OnExitHostIpFour)(state, memory);
 }
 
 
@@ -2125,11 +2150,24 @@ static URI_INLINE void URI_FUNC(ResetParserStateExceptUri)(URI_TYPE(ParserState)
 static URI_INLINE UriBool URI_FUNC(PushPathSegment)(
 		URI_TYPE(ParserState) * state, const URI_CHAR * first,
 		const URI_CHAR * afterLast, UriMemoryManager * memory) {
-	URI_TYPE(PathSegment) * segment = memory->calloc(memory, 1, sizeof(URI_TYPE(PathSegment)));
+	URI_TYPE(PathSegment) * segment;
+
+	/* Lazy mode: grow the single node over the whole path */
+	if ((state->reserved != NULL) && (state->uri->pathHead != NULL)) {
+		state->uri->pathTail->text.afterLast = afterLast;
+		return URI_TRUE;
+	}
+
+	segment = memory->calloc(memory, 1, sizeof(URI_TYPE(PathSegment)));
 	if (segment == NULL) {
 		return URI_FALSE; /* Raises malloc error */
 	}
-	if (first == afterLast) {
+	if (state->reserved != NULL) {
+		/* Keep the position even if empty, more text may follow */
+		segment->text.first = first;
+		segment->text.afterLast = afterLast;
+		segment->reserved = (void *)URI_FUNC(ConstLazyPath);
+	} else if (first == afterLast) {
 		segment->text.first = URI_FUNC(SafeToPointTo);
 		segment->text.afterLast = URI_FUNC(SafeToPointTo);
 	} else {
@@ -2155,14 +2193,16 @@ static URI_INLINE UriBool URI_FUNC(PushPathSegment)(
 
 int URI_FUNC(ParseUriEx)(URI_TYPE(ParserState) * state,
 		const URI_CHAR * first, const URI_CHAR * afterLast) {
-	return URI_FUNC(ParseUriExMm)(state, first, afterLast, NULL);
+	return URI_FUNC(ParseUriExMm)(state, first, afterLast, URI_FALSE,
+			&defaultMemoryManager);
 }
 
 
 
+/* NOTE: Expects a complete memory manager, callers check */
 static int URI_FUNC(ParseUriExMm)(URI_TYPE(ParserState) * state,
 		const URI_CHAR * first, const URI_CHAR * afterLast,
-		UriMemoryManager * memory) {
+		UriBool lazyPath, UriMemoryManager * memory) {
 	const URI_CHAR * afterUriReference;
 	URI_TYPE(Uri) * uri;
 
@@ -2170,13 +2210,16 @@ static int URI_FUNC(ParseUriExMm)(URI_TYPE(ParserState) * state,
 	if ((state == NULL) || (first == NULL) || (afterLast == NULL)) {
 		return URI_ERROR_NULL;
 	}
-	URI_CHECK_MEMORY_MANAGER(memory);  /* may return */
 
 	uri = state->uri;
 
 	/* Init parser */
 	URI_FUNC(ResetParserStateExceptUri)(state);
 	URI_FUNC(ResetUri)(uri);
+	if (lazyPath) {
+		/* Read by PushPathSegment */
+		state->reserved = (void *)URI_FUNC(ConstLazyPath);
+	}
 
 	/* Parse */
 	afterUriReference = URI_FUNC(ParseUriReference)(state, first, afterLast, memory);
@@ -2230,24 +2273,81 @@ int URI_FUNC(ParseSingleUriEx)(URI_TYPE(Uri) * uri,
 int URI_FUNC(ParseSingleUriExMm)(URI_TYPE(Uri) * uri,
 		const URI_CHAR * first, const URI_CHAR * afterLast,
 		const URI_CHAR ** errorPos, UriMemoryManager * memory) {
-	URI_TYPE(ParserState) state;
-	int res;
+	/* Check params */
+	if ((uri == NULL) || (first == NULL) || (afterLast == NULL)) {
+		return URI_ERROR_NULL;
+	}
+	URI_CHECK_MEMORY_MANAGER(memory);  /* may return */
+
+	return URI_FUNC(ParseSingleUriEngine)(uri, first, afterLast, errorPos,
+			URI_FALSE, memory);
+}
+
 
+
+int URI_FUNC(ParseSingleUriLazyExMm)(URI_TYPE(Uri) * uri,
+		const URI_CHAR * first, const URI_CHAR * afterLast,
+		const URI_CHAR ** errorPos, UriMemoryManager * memory) {
 	/* Check params */
 	if ((uri == NULL) || (first == NULL) || (afterLast == NULL)) {
 		return URI_ERROR_NULL;
 	}
 	URI_CHECK_MEMORY_MANAGER(memory);  /* may return */
 
+	return URI_FUNC(ParseSingleUriEngine)(uri, first, afterLast, errorPos,
+			URI_TRUE, memory);
+}
+
+
+
+int URI_FUNC(MaterializePathMm)(URI_TYPE(Uri) * uri,
+		UriMemoryManager * memory) {
+	if (uri == NULL) {
+		return URI_ERROR_NULL;
+	}
+	URI_CHECK_MEMORY_MANAGER(memory);  /* may return */
+
+	return URI_FUNC(MaterializePath)(uri, memory)
+			? URI_SUCCESS
+			: URI_ERROR_MALLOC;
+}
+
+
+
+int URI_FUNC(ParseSingleUriContext)(URI_TYPE(Uri) * uri,
+		const URI_CHAR * first, const URI_CHAR * afterLast,
+		const URI_CHAR ** errorPos, UriParserContext * context) {
+	/* Check params */
+	if ((uri == NULL) || (first == NULL) || (context == NULL)) {
+		return URI_ERROR_NULL;
+	}
+	if (afterLast == NULL) {
+		afterLast = first + URI_STRLEN(first);
+	}
+
+	/* The context's memory manager was checked on creation */
+	return URI_FUNC(ParseSingleUriEngine)(uri, first, afterLast, errorPos,
+			URI_FALSE, &(context->memory));
+}
+
+
+
+static int URI_FUNC(ParseSingleUriEngine)(URI_TYPE(Uri) * uri,
+		const URI_CHAR * first, const URI_CHAR * afterLast,
+		const URI_CHAR ** errorPos, UriBool lazyPath,
+		UriMemoryManager * memory) {
+	URI_TYPE(ParserState) state;
+	int res;
+
 	state.uri = uri;
 
-	res = URI_FUNC(ParseUriExMm)(&state, first, afterLast, memory);
+	res = URI_FUNC(ParseUriExMm)(&state, first, afterLast, lazyPath, memory);
 
 	if (res != URI_SUCCESS) {
 		if (errorPos != NULL) {
 			*errorPos = state.errorPos;
 		}
-		URI_FUNC(FreeUriMembersMm)(uri, memory);
+		URI_FUNC(FreeUriMembersEngine)(uri, memory);
 	}
 
 	return res;
@@ -2268,7 +2368,32 @@ int URI_FUNC(FreeUriMembersMm)(URI_TYPE(Uri) * uri, UriMemoryManager * memory) {
 
 	URI_CHECK_MEMORY_MANAGER(memory);  /* may return */
 
-	if (uri->owner) {
+	URI_FUNC(FreeUriMembersEngine)(uri, memory);
+	return URI_SUCCESS;
+}
+
+
+
+int URI_FUNC(FreeUriMembersContext)(URI_TYPE(Uri) * uri,
+		UriParserContext * context) {
+	if ((uri == NULL) || (context == NULL)) {
+		return URI_ERROR_NULL;
+	}
+
+	URI_FUNC(FreeUriMembersEngine)(uri, &(context->memory));
+	return URI_SUCCESS;
+}
+
+
+
+static void URI_FUNC(FreeUriMembersEngine)(URI_TYPE(Uri) * uri,
+		UriMemoryManager * memory) {
+	UriBool ownsPieces;
+
+	/* Text of a compact owner lives in a single block, see below */
+	ownsPieces = uri->owner && !URI_FUNC(IsCompactOwner)(uri);
+
+	if (ownsPieces) {
 		/* Scheme */
 		if (uri->scheme.first != NULL) {
 			if (uri->scheme.first != uri->scheme.afterLast) {
@@ -2298,11 +2423,8 @@ int URI_FUNC(FreeUriMembersMm)(URI_TYPE(Uri) * uri, UriMemoryManager * memory) {
 			uri->hostText.afterLast = NULL;
 		}
 
-		/* Host text (if regname, after IPvFuture!) */
-		if ((uri->hostText.first != NULL)
-				&& (uri->hostData.ip4 == NULL)
-				&& (uri->hostData.ip6 == NULL)) {
-			/* Real regname */
+		/* Host text (if regname or IP address, after IPvFuture!) */
+		if (uri->hostText.first != NULL) {
 			if (uri->hostText.first != uri->hostText.afterLast) {
 				memory->free(memory, (URI_CHAR *)uri->hostText.first);
 			}
@@ -2324,7 +2446,7 @@ int URI_FUNC(FreeUriMembersMm)(URI_TYPE(Uri) * uri, UriMemoryManager * memory) {
 	}
 
 	/* Port text */
-	if (uri->owner && (uri->portText.first != NULL)) {
+	if (ownsPieces && (uri->portText.first != NULL)) {
 		if (uri->portText.first != uri->portText.afterLast) {
 			memory->free(memory, (URI_CHAR *)uri->portText.first);
 		}
@@ -2337,7 +2459,7 @@ int URI_FUNC(FreeUriMembersMm)(URI_TYPE(Uri) * uri, UriMemoryManager * memory) {
 		URI_TYPE(PathSegment) * segWalk = uri->pathHead;
 		while (segWalk != NULL) {
 			URI_TYPE(PathSegment) * const next = segWalk->next;
-			if (uri->owner && (segWalk->text.first != NULL)
+			if (ownsPieces && (segWalk->text.first != NULL)
 					&& (segWalk->text.first < segWalk->text.afterLast)) {
 				memory->free(memory, (URI_CHAR *)segWalk->text.first);
 			}
@@ -2348,7 +2470,7 @@ int URI_FUNC(FreeUriMembersMm)(URI_TYPE(Uri) * uri, UriMemoryManager * memory) {
 		uri->pathTail = NULL;
 	}
 
-	if (uri->owner) {
+	if (ownsPieces) {
 		/* Query */
 		if (uri->query.first != NULL) {
 			if (uri->query.first != uri->query.afterLast) {
@@ -2368,6 +2490,84 @@ int URI_FUNC(FreeUriMembersMm)(URI_TYPE(Uri) * uri, UriMemoryManager * memory) {
 		}
 	}
 
+	/* Compact owner */
+	if (URI_FUNC(IsCompactOwner)(uri)) {
+		memory->free(memory, uri->reserved);
+		uri->reserved = NULL;
+
+		uri->scheme.first = NULL;
+		uri->scheme.afterLast = NULL;
+		uri->userInfo.first = NULL;
+		uri->userInfo.afterLast = NULL;
+		uri->hostText.first = NULL;
+		uri->hostText.afterLast = NULL;
+		uri->hostData.ipFuture.first = NULL;
+		uri->hostData.ipFuture.afterLast = NULL;
+		uri->portText.first = NULL;
+		uri->portText.afterLast = NULL;
+		uri->query.first = NULL;
+		uri->query.afterLast = NULL;
+		uri->fragment.first = NULL;
+		uri->fragment.afterLast = NULL;
+	}
+}
+
+
+
+int URI_FUNC(ParseIpSixAddress)(unsigned char * octetOutput,
+		const URI_CHAR * first, const URI_CHAR * afterLast) {
+	/* Longest valid text is "ffff:ffff:ffff:ffff:ffff:ffff:255.255.255.255" */
+	URI_CHAR bracketed[45 + 1];
+	unsigned char octets[16];
+	const URI_CHAR * errorPos = NULL;
+	size_t len;
+
+	/* Essential checks */
+	if ((octetOutput == NULL) || (first == NULL)
+			|| (afterLast <= first)) {
+		return URI_ERROR_SYNTAX;
+	}
+
+	len = (size_t)(afterLast - first);
+	if (len > 45) {
+		return URI_ERROR_SYNTAX;
+	}
+
+	/* Terminate with the closing bracket the engine expects */
+	memcpy(bracketed, first, len * sizeof(URI_CHAR));
+	bracketed[len] = _UT(']');
+
+	if (URI_FUNC(ParseIpSixAddressEngine)(octets, bracketed,
+			bracketed + len + 1, &errorPos) != bracketed + len) {
+		return URI_ERROR_SYNTAX;
+	}
+
+	memcpy(octetOutput, octets, sizeof(octets));
+	return URI_SUCCESS;
+}
+
+
+
+int URI_FUNC(GetPort)(const URI_TYPE(Uri) * uri, UriBool useDefault,
+		int * port, UriBool * valid) {
+	int value;
+
+	if ((uri == NULL) || (port == NULL)) {
+		return URI_ERROR_NULL;
+	}
+
+	value = URI_FUNC(ParsePortNumber)(&(uri->portText));
+	if (valid != NULL) {
+		*valid = (value == -2) ? URI_FALSE : URI_TRUE;
+	}
+	if (value == -2) {
+		*port = -1;
+		return URI_SUCCESS;
+	}
+	if ((value == -1) && useDefault) {
+		value = URI_FUNC(GetDefaultPort)(&(uri->scheme));
+	}
+	*port = value;
 	return URI_SUCCESS;
 }
 
@@ -2383,7 +2583,6 @@ UriBool URI_FUNC(_TESTING_ONLY_ParseIpSix)(const URI_CHAR * text) {
 	URI_FUNC(ResetUri)(&uri);
 	parser.uri = &uri;
 	URI_FUNC(ResetParserStateExceptUri)(&parser);
-	parser.uri->hostData.ip6 = memory->malloc(memory, 1 * sizeof(UriIp6));
 	res = URI_FUNC(ParseIPv6address2)(&parser, text, afterIpSix, memory);
 	URI_FUNC(FreeUriMembersMm)(&uri, memory);
 	return res == afterIpSix ? URI_TRUE : URI_FALSE;
@@ -0,0 +1,253 @@
+/*
+ * uriparser - RFC 3986 URI parsing library
+ *
+ * Copyright (C) 2020, Weijia Song <songweijia@gmail.com>
+ * Copyright (C) 2020, Sebastian Pipping <sebastian@pipping.org>
+ * All rights reserved.
+ *
+ * Redistribution and use in source  and binary forms, with or without
+ * modification, are permitted provided  that the following conditions
+ * are met:
+ *
+ *     1. Redistributions  of  source  code   must  retain  the  above
+ *        copyright notice, this list  of conditions and the following
+ *        disclaimer.
+ *
+ *     2. Redistributions  in binary  form  must  reproduce the  above
+ *        copyright notice, this list  of conditions and the following
+ *        disclaimer  in  the  documentation  and/or  other  materials
+ *        provided with the distribution.
+ *
+ *     3. Neither the  name of the  copyright holder nor the  names of
+ *        its contributors may be used  to endorse or promote products
+ *        derived from  this software  without specific  prior written
+ *        permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND  ANY EXPRESS OR IMPLIED WARRANTIES,  INCLUDING, BUT NOT
+ * LIMITED TO,  THE IMPLIED WARRANTIES OF  MERCHANTABILITY AND FITNESS
+ * FOR  A  PARTICULAR  PURPOSE  ARE  DISCLAIMED.  IN  NO  EVENT  SHALL
+ * THE  COPYRIGHT HOLDER  OR CONTRIBUTORS  BE LIABLE  FOR ANY  DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL,  EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO,  PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA,  OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT  LIABILITY,  OR  TORT (INCLUDING  NEGLIGENCE  OR  OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file UriPath.c
+ * Holds the iteration over path segments.
+ * NOTE: This source file includes itself twice.
+ */
+
+/* What encodings are enabled? */
+#include <uriparser/UriDefsConfig.h>
+#if (!defined(URI_PASS_ANSI) && !defined(URI_PASS_UNICODE))
+/* Include SELF twice */
+# ifdef URI_ENABLE_ANSI
+#  define URI_PASS_ANSI 1
+#  include "UriPath.c"
+#  undef URI_PASS_ANSI
+# endif
+# ifdef URI_ENABLE_UNICODE
+#  define URI_PASS_UNICODE 1
+#  include "UriPath.c"
+#  undef URI_PASS_UNICODE
+# endif
+#else
+# ifdef URI_PASS_ANSI
+#  include <uriparser/UriDefsAnsi.h>
+# else
+#  include <uriparser/UriDefsUnicode.h>
+#  include <wchar.h>
+# endif
+
+
+
+#ifndef URI_DOXYGEN
+# include <uriparser/Uri.h>
+# include "UriCommon.h"
+#endif
+
+
+
+static void URI_FUNC(PathIteratorInit)(URI_TYPE(PathIterator) * iterator,
+		const URI_TYPE(Uri) * uri);
+static void URI_FUNC(SetSegment)(URI_TYPE(PathIterator) * iterator,
+		const URI_CHAR * first, const URI_CHAR * afterLast);
+
+
+
+static void URI_FUNC(PathIteratorInit)(URI_TYPE(PathIterator) * iterator,
+		const URI_TYPE(Uri) * uri) {
+	iterator->head = (uri != NULL) ? uri->pathHead : NULL;
+	iterator->node = NULL;
+	iterator->lazy = URI_FUNC(IsPathLazy)(uri);
+	iterator->done = (iterator->head == NULL) ? URI_TRUE : URI_FALSE;
+	iterator->segment.first = NULL;
+	iterator->segment.afterLast = NULL;
+
+	/* A lazy path is read from its text, see uriParseSingleUriLazyExMmA */
+	if (iterator->lazy) {
+		iterator->first = iterator->head->text.first;
+		iterator->afterLast = iterator->head->text.afterLast;
+	} else {
+		iterator->first = NULL;
+		iterator->afterLast = NULL;
+	}
+	iterator->read = NULL;
+}
+
+
+
+/* Empty segments point to SafeToPointTo, as after regular parsing */
+static URI_INLINE void URI_FUNC(SetSegment)(URI_TYPE(PathIterator) * iterator,
+		const URI_CHAR * first, const URI_CHAR * afterLast) {
+	if (first == afterLast) {
+		iterator->segment.first = URI_FUNC(SafeToPointTo);
+		iterator->segment.afterLast = URI_FUNC(SafeToPointTo);
+	} else {
+		iterator->segment.first = first;
+		iterator->segment.afterLast = afterLast;
+	}
+}
+
+
+
+void URI_FUNC(PathIteratorBegin)(URI_TYPE(PathIterator) * iterator,
+		const URI_TYPE(Uri) * uri) {
+	if (iterator == NULL) {
+		return;
+	}
+
+	URI_FUNC(PathIteratorInit)(iterator, uri);
+	iterator->node = iterator->head;
+	iterator->read = iterator->first;
+}
+
+
+
+const URI_TYPE(TextRange) * URI_FUNC(PathIteratorNext)(
+		URI_TYPE(PathIterator) * iterator) {
+	if ((iterator == NULL) || iterator->done) {
+		return NULL;
+	}
+
+	if (iterator->lazy) {
+		const URI_CHAR * afterSegment = iterator->read;
+		while ((afterSegment < iterator->afterLast)
+				&& (afterSegment[0] != _UT('/'))) {
+			afterSegment++;
+		}
+		URI_FUNC(SetSegment)(iterator, iterator->read, afterSegment);
+		if (afterSegment >= iterator->afterLast) {
+			iterator->done = URI_TRUE;
+		} else {
+			iterator->read = afterSegment + 1;
+		}
+	} else {
+		iterator->segment = iterator->node->text;
+		iterator->node = iterator->node->next;
+		if (iterator->node == NULL) {
+			iterator->done = URI_TRUE;
+		}
+	}
+	return &(iterator->segment);
+}
+
+
+
+void URI_FUNC(PathIteratorBeginReverse)(URI_TYPE(PathIterator) * iterator,
+		const URI_TYPE(Uri) * uri) {
+	if (iterator == NULL) {
+		return;
+	}
+
+	URI_FUNC(PathIteratorInit)(iterator, uri);
+	iterator->node = NULL;  /* i.e. behind the last node */
+	iterator->read = iterator->afterLast;
+}
+
+
+
+const URI_TYPE(TextRange) * URI_FUNC(PathIteratorPrev)(
+		URI_TYPE(PathIterator) * iterator) {
+	if ((iterator == NULL) || iterator->done) {
+		return NULL;
+	}
+
+	if (iterator->lazy) {
+		const URI_CHAR * segmentFirst = iterator->read;
+		while ((segmentFirst > iterator->first)
+				&& (segmentFirst[-1] != _UT('/'))) {
+			segmentFirst--;
+		}
+		URI_FUNC(SetSegment)(iterator, segmentFirst, iterator->read);
+		if (segmentFirst <= iterator->first) {
+			iterator->done = URI_TRUE;
+		} else {
+			iterator->read = segmentFirst - 1;
+		}
+	} else {
+		/* Singly linked, so find the node before the one last returned */
+		const URI_TYPE(PathSegment) * walker = iterator->head;
+		while (walker->next != iterator->node) {
+			walker = walker->next;
+		}
+		iterator->node = walker;
+		iterator->segment = walker->text;
+		if (walker == iterator->head) {
+			iterator->done = URI_TRUE;
+		}
+	}
+	return &(iterator->segment);
+}
+
+
+
+int URI_FUNC(GetPathSegmentCount)(const URI_TYPE(Uri) * uri, int * count) {
+	URI_TYPE(PathIterator) iterator;
+	int segments = 0;
+
+	if ((uri == NULL) || (count == NULL)) {
+		return URI_ERROR_NULL;
+	}
+
+	URI_FUNC(PathIteratorBegin)(&iterator, uri);
+	while (URI_FUNC(PathIteratorNext)(&iterator) != NULL) {
+		segments++;
+	}
+	*count = segments;
+	return URI_SUCCESS;
+}
+
+
+
+int URI_FUNC(GetPathSegment)(const URI_TYPE(Uri) * uri, int index,
+		URI_TYPE(TextRange) * segment) {
+	URI_TYPE(PathIterator) iterator;
+	const URI_TYPE(TextRange) * walker;
+
+	if ((uri == NULL) || (segment == NULL)) {
+		return URI_ERROR_NULL;
+	}
+	if (index < 0) {
+		return URI_ERROR_RANGE_INVALID;
+	}
+
+	URI_FUNC(PathIteratorBegin)(&iterator, uri);
+	while ((walker = URI_FUNC(PathIteratorNext)(&iterator)) != NULL) {
+		if (index-- == 0) {
+			*segment = *walker;
+			return URI_SUCCESS;
+		}
+	}
+	return URI_ERROR_RANGE_INVALID;
+}
+
+
+
+#endif
@@ -0,0 +1,330 @@
+/*
+ * uriparser - RFC 3986 URI parsing library
+ *
+ * Copyright (C) 2020, Weijia Song <songweijia@gmail.com>
+ * Copyright (C) 2020, Sebastian Pipping <sebastian@pipping.org>
+ * All rights reserved.
+ *
+ * Redistribution and use in source  and binary forms, with or without
+ * modification, are permitted provided  that the following conditions
+ * are met:
+ *
+ *     1. Redistributions  of  source  code   must  retain  the  above
+ *        copyright notice, this list  of conditions and the following
+ *        disclaimer.
+ *
+ *     2. Redistributions  in binary  form  must  reproduce the  above
+ *        copyright notice, this list  of conditions and the following
+ *        disclaimer  in  the  documentation  and/or  other  materials
+ *        provided with the distribution.
+ *
+ *     3. Neither the  name of the  copyright holder nor the  names of
+ *        its contributors may be used  to endorse or promote products
+ *        derived from  this software  without specific  prior written
+ *        permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND  ANY EXPRESS OR IMPLIED WARRANTIES,  INCLUDING, BUT NOT
+ * LIMITED TO,  THE IMPLIED WARRANTIES OF  MERCHANTABILITY AND FITNESS
+ * FOR  A  PARTICULAR  PURPOSE  ARE  DISCLAIMED.  IN  NO  EVENT  SHALL
+ * THE  COPYRIGHT HOLDER  OR CONTRIBUTORS  BE LIABLE  FOR ANY  DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL,  EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO,  PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA,  OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT  LIABILITY,  OR  TORT (INCLUDING  NEGLIGENCE  OR  OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file UriPunycodeBase.c
+ * Holds the Punycode (RFC 3492) implementation,
+ * independent of the encoding pass.
+ */
+
+#include <uriparser/UriDefsConfig.h>
+
+#ifndef URI_DOXYGEN
+# include <uriparser/UriBase.h>
+#endif
+
+#include <string.h>
+
+
+
+/* Bootstring parameters for Punycode, RFC 3492 section 5 */
+#define URI_PUNY_BASE          36
+#define URI_PUNY_TMIN          1
+#define URI_PUNY_TMAX          26
+#define URI_PUNY_SKEW          38
+#define URI_PUNY_DAMP          700
+#define URI_PUNY_INITIAL_BIAS  72
+#define URI_PUNY_INITIAL_N     0x80
+#define URI_PUNY_DELIMITER     '-'
+#define URI_PUNY_MAX_INT       ((unsigned int)-1)
+#define URI_PUNY_MAX_CODE_POINT  0x10ffff
+
+
+
+static unsigned int uriPunycodeAdapt(unsigned int delta,
+		unsigned int numPoints, UriBool firstTime);
+static char uriPunycodeEncodeDigit(unsigned int digit);
+static unsigned int uriPunycodeDecodeDigit(char c);
+static int uriPunycodeEncodeEngine(char * dest,
+		const unsigned int * codePoints, int codePointCount, int maxChars,
+		int * written);
+
+
+
+/* Bias adaptation, RFC 3492 section 6.1 */
+static URI_INLINE unsigned int uriPunycodeAdapt(unsigned int delta,
+		unsigned int numPoints, UriBool firstTime) {
+	unsigned int k = 0;
+	delta = firstTime ? delta / URI_PUNY_DAMP : delta / 2;
+	delta += delta / numPoints;
+	while (delta > ((URI_PUNY_BASE - URI_PUNY_TMIN) * URI_PUNY_TMAX) / 2) {
+		delta /= URI_PUNY_BASE - URI_PUNY_TMIN;
+		k += URI_PUNY_BASE;
+	}
+	return k + (URI_PUNY_BASE - URI_PUNY_TMIN + 1) * delta
+			/ (delta + URI_PUNY_SKEW);
+}
+
+
+
+static URI_INLINE char uriPunycodeEncodeDigit(unsigned int digit) {
+	/* 0..25 map to 'a'..'z', 26..35 map to '0'..'9' */
+	return (char)((digit < 26) ? ('a' + digit) : ('0' + digit - 26));
+}
+
+
+
+/* Returns URI_PUNY_BASE for characters that are not a digit */
+static URI_INLINE unsigned int uriPunycodeDecodeDigit(char c) {
+	if ((c >= '0') && (c <= '9')) {
+		return (unsigned int)(c - '0') + 26;
+	} else if ((c >= 'a') && (c <= 'z')) {
+		return (unsigned int)(c - 'a');
+	} else if ((c >= 'A') && (c <= 'Z')) {
+		return (unsigned int)(c - 'A');
+	}
+	return URI_PUNY_BASE;
+}
+
+
+
+int uriPunycodeEncode(char * dest, const unsigned int * codePoints,
+		int codePointCount, int maxChars, int * charsWritten) {
+	int written = 0;
+	int res;
+
+	if ((dest == NULL) || ((codePoints == NULL) && (codePointCount > 0))) {
+		return URI_ERROR_NULL;
+	}
+	if (codePointCount < 0) {
+		return URI_ERROR_RANGE_INVALID;
+	}
+	if (maxChars < 1) {
+		return URI_ERROR_OUTPUT_TOO_LARGE;
+	}
+
+	res = uriPunycodeEncodeEngine(dest, codePoints, codePointCount,
+			maxChars, &written);
+	if (res != URI_SUCCESS) {
+		dest[0] = '\0';
+		if (charsWritten != NULL) {
+			*charsWritten = 0;
+		}
+		return res;
+	}
+
+	dest[written] = '\0';
+	if (charsWritten != NULL) {
+		*charsWritten = written + 1;
+	}
+	return URI_SUCCESS;
+}
+
+
+
+/* Encoder of RFC 3492 section 6.3; leaves room for a terminator */
+static int uriPunycodeEncodeEngine(char * dest,
+		const unsigned int * codePoints, int codePointCount, int maxChars,
+		int * written) {
+	unsigned int n = URI_PUNY_INITIAL_N;
+	unsigned int delta = 0;
+	unsigned int bias = URI_PUNY_INITIAL_BIAS;
+	unsigned int handled;
+	unsigned int basicCount;
+	int i;
+
+	/* Basic code points are copied as they are */
+	for (i = 0; i < codePointCount; i++) {
+		if ((codePoints[i] > URI_PUNY_MAX_CODE_POINT)
+				|| ((codePoints[i] >= 0xd800) && (codePoints[i] <= 0xdfff))) {
+			return URI_ERROR_SYNTAX;
+		}
+		if (codePoints[i] < 0x80) {
+			if (*written + 1 >= maxChars) {
+				return URI_ERROR_OUTPUT_TOO_LARGE;
+			}
+			dest[(*written)++] = (char)codePoints[i];
+		}
+	}
+	handled = basicCount = (unsigned int)*written;
+	if (basicCount > 0) {
+		if (*written + 1 >= maxChars) {
+			return URI_ERROR_OUTPUT_TOO_LARGE;
+		}
+		dest[(*written)++] = URI_PUNY_DELIMITER;
+	}
+
+	/* Deltas for the remaining code points, in order of value */
+	while (handled < (unsigned int)codePointCount) {
+		unsigned int m = URI_PUNY_MAX_INT;
+		for (i = 0; i < codePointCount; i++) {
+			if ((codePoints[i] >= n) && (codePoints[i] < m)) {
+				m = codePoints[i];
+			}
+		}
+
+		if (m - n > (URI_PUNY_MAX_INT - delta) / (handled + 1)) {
+			return URI_ERROR_OUTPUT_TOO_LARGE;
+		}
+		delta += (m - n) * (handled + 1);
+		n = m;
+
+		for (i = 0; i < codePointCount; i++) {
+			if (codePoints[i] < n) {
+				if (++delta == 0) {
+					return URI_ERROR_OUTPUT_TOO_LARGE;
+				}
+			} else if (codePoints[i] == n) {
+				unsigned int q = delta;
+				unsigned int k = URI_PUNY_BASE;
+				for (;; k += URI_PUNY_BASE) {
+					const unsigned int t = (k <= bias)
+							? URI_PUNY_TMIN
+							: (k >= bias + URI_PUNY_TMAX)
+								? URI_PUNY_TMAX
+								: k - bias;
+					if (q < t) {
+						break;
+					}
+					if (*written + 1 >= maxChars) {
+						return URI_ERROR_OUTPUT_TOO_LARGE;
+					}
+					dest[(*written)++] = uriPunycodeEncodeDigit(
+							t + (q - t) % (URI_PUNY_BASE - t));
+					q = (q - t) / (URI_PUNY_BASE - t);
+				}
+				if (*written + 1 >= maxChars) {
+					return URI_ERROR_OUTPUT_TOO_LARGE;
+				}
+				dest[(*written)++] = uriPunycodeEncodeDigit(q);
+				bias = uriPunycodeAdapt(delta, handled + 1,
+						(handled == basicCount) ? URI_TRUE : URI_FALSE);
+				delta = 0;
+				handled++;
+			}
+		}
+		delta++;
+		n++;
+	}
+	return URI_SUCCESS;
+}
+
+
+
+int uriPunycodeDecode(unsigned int * dest, const char * first,
+		const char * afterLast, int maxCodePoints, int * codePointsWritten) {
+	unsigned int n = URI_PUNY_INITIAL_N;
+	unsigned int i = 0;
+	unsigned int bias = URI_PUNY_INITIAL_BIAS;
+	unsigned int written = 0;
+	const char * basicAfterLast = first;
+	const char * walker;
+
+	if ((dest == NULL) || (first == NULL) || (afterLast == NULL)) {
+		return URI_ERROR_NULL;
+	}
+	if ((afterLast < first) || (maxCodePoints < 0)) {
+		return URI_ERROR_RANGE_INVALID;
+	}
+
+	/* Basic code points are everything before the last delimiter */
+	for (walker = first; walker < afterLast; walker++) {
+		if (*walker == URI_PUNY_DELIMITER) {
+			basicAfterLast = walker;
+		}
+	}
+	for (walker = first; walker < basicAfterLast; walker++) {
+		if ((unsigned char)*walker >= 0x80) {
+			return URI_ERROR_SYNTAX;
+		}
+		if (written >= (unsigned int)maxCodePoints) {
+			return URI_ERROR_OUTPUT_TOO_LARGE;
+		}
+		dest[written++] = (unsigned char)*walker;
+	}
+	if (basicAfterLast > first) {
+		walker++;  /* skip delimiter */
+	}
+
+	while (walker < afterLast) {
+		const unsigned int oldI = i;
+		unsigned int w = 1;
+		unsigned int k = URI_PUNY_BASE;
+		for (;; k += URI_PUNY_BASE) {
+			unsigned int digit;
+			unsigned int t;
+			if (walker >= afterLast) {
+				return URI_ERROR_SYNTAX;
+			}
+			digit = uriPunycodeDecodeDigit(*walker++);
+			if (digit >= URI_PUNY_BASE) {
+				return URI_ERROR_SYNTAX;
+			}
+			if (digit > (URI_PUNY_MAX_INT - i) / w) {
+				return URI_ERROR_SYNTAX;
+			}
+			i += digit * w;
+			t = (k <= bias)
+					? URI_PUNY_TMIN
+					: (k >= bias + URI_PUNY_TMAX)
+						? URI_PUNY_TMAX
+						: k - bias;
+			if (digit < t) {
+				break;
+			}
+			if (w > URI_PUNY_MAX_INT / (URI_PUNY_BASE - t)) {
+				return URI_ERROR_SYNTAX;
+			}
+			w *= URI_PUNY_BASE - t;
+		}
+
+		bias = uriPunycodeAdapt(i - oldI, written + 1,
+				(oldI == 0) ? URI_TRUE : URI_FALSE);
+		if (i / (written + 1) > URI_PUNY_MAX_CODE_POINT - n) {
+			return URI_ERROR_SYNTAX;
+		}
+		n += i / (written + 1);
+		i %= written + 1;
+		if ((n < 0x80) || ((n >= 0xd800) && (n <= 0xdfff))) {
+			return URI_ERROR_SYNTAX;
+		}
+
+		if (written >= (unsigned int)maxCodePoints) {
+			return URI_ERROR_OUTPUT_TOO_LARGE;
+		}
+		memmove(dest + i + 1, dest + i, (written - i) * sizeof(unsigned int));
+		dest[i++] = n;
+		written++;
+	}
+
+	if (codePointsWritten != NULL) {
+		*codePointsWritten = (int)written;
+	}
+	return URI_SUCCESS;
+}
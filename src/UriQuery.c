@@ -75,6 +75,8 @@
 
 static int URI_FUNC(ComposeQueryEngine)(URI_CHAR * dest,
 		const URI_TYPE(QueryList) * queryList,
+		const URI_TYPE(TextRange) * keys, const URI_TYPE(TextRange) * values,
+		int itemCount,
 		int maxChars, int * charsWritten, int * charsRequired,
 		UriBool spaceToPlus, UriBool normalizeBreaks);
 
@@ -103,8 +105,22 @@ int URI_FUNC(ComposeQueryCharsRequiredEx)(const URI_TYPE(QueryList) * queryList,
 		return URI_ERROR_NULL;
 	}
 
-	return URI_FUNC(ComposeQueryEngine)(NULL, queryList, 0, NULL,
-			charsRequired, spaceToPlus, normalizeBreaks);
+	return URI_FUNC(ComposeQueryEngine)(NULL, queryList, NULL, NULL, 0,
+			0, NULL, charsRequired, spaceToPlus, normalizeBreaks);
+}
+
+
+
+int URI_FUNC(ComposeQueryRangesCharsRequired)(
+		const URI_TYPE(TextRange) * keys, const URI_TYPE(TextRange) * values,
+		int itemCount, int * charsRequired,
+		UriBool spaceToPlus, UriBool normalizeBreaks) {
+	if (((keys == NULL) && (itemCount > 0)) || (charsRequired == NULL)) {
+		return URI_ERROR_NULL;
+	}
+
+	return URI_FUNC(ComposeQueryEngine)(NULL, NULL, keys, values, itemCount,
+			0, NULL, charsRequired, spaceToPlus, normalizeBreaks);
 }
 
 
@@ -131,8 +147,26 @@ int URI_FUNC(ComposeQueryEx)(URI_CHAR * dest,
 		return URI_ERROR_OUTPUT_TOO_LARGE;
 	}
 
-	return URI_FUNC(ComposeQueryEngine)(dest, queryList, maxChars,
-			charsWritten, NULL, spaceToPlus, normalizeBreaks);
+	return URI_FUNC(ComposeQueryEngine)(dest, queryList, NULL, NULL, 0,
+			maxChars, charsWritten, NULL, spaceToPlus, normalizeBreaks);
+}
+
+
+
+int URI_FUNC(ComposeQueryRanges)(URI_CHAR * dest,
+		const URI_TYPE(TextRange) * keys, const URI_TYPE(TextRange) * values,
+		int itemCount, int maxChars, int * charsWritten,
+		UriBool spaceToPlus, UriBool normalizeBreaks) {
+	if ((dest == NULL) || ((keys == NULL) && (itemCount > 0))) {
+		return URI_ERROR_NULL;
+	}
+
+	if (maxChars < 1) {
+		return URI_ERROR_OUTPUT_TOO_LARGE;
+	}
+
+	return URI_FUNC(ComposeQueryEngine)(dest, NULL, keys, values, itemCount,
+			maxChars, charsWritten, NULL, spaceToPlus, normalizeBreaks);
 }
 
 
@@ -199,13 +233,20 @@ int URI_FUNC(ComposeQueryMallocExMm)(URI_CHAR ** dest,
 
 
 
+/*
+ * Composes either the query list or, with queryList NULL,
+ * the itemCount key and value ranges; values can be NULL.
+ */
 int URI_FUNC(ComposeQueryEngine)(URI_CHAR * dest,
 		const URI_TYPE(QueryList) * queryList,
+		const URI_TYPE(TextRange) * keys, const URI_TYPE(TextRange) * values,
+		int itemCount,
 		int maxChars, int * charsWritten, int * charsRequired,
 		UriBool spaceToPlus, UriBool normalizeBreaks) {
 	UriBool firstItem = URI_TRUE;
 	int ampersandLen = 0;  /* increased to 1 from second item on */
 	URI_CHAR * write = dest;
+	int itemIndex = 0;
 
 	/* Subtract terminator */
 	if (dest == NULL) {
@@ -214,20 +255,39 @@ int URI_FUNC(ComposeQueryEngine)(URI_CHAR * dest,
 		maxChars--;
 	}
 
-	while (queryList != NULL) {
-		const URI_CHAR * const key = queryList->key;
-		const URI_CHAR * const value = queryList->value;
+	for (;;) {
+		const URI_CHAR * key;
+		const URI_CHAR * value;
 		const int worstCase = (normalizeBreaks == URI_TRUE ? 6 : 3);
-		const int keyLen = (key == NULL) ? 0 : (int)URI_STRLEN(key);
+		size_t keyLen;
 		int keyRequiredChars;
-		const int valueLen = (value == NULL) ? 0 : (int)URI_STRLEN(value);
+		size_t valueLen;
 		int valueRequiredChars;
 
-		if ((keyLen >= INT_MAX / worstCase) || (valueLen >= INT_MAX / worstCase)) {
+		if (queryList != NULL) {
+			key = queryList->key;
+			value = queryList->value;
+			keyLen = (key == NULL) ? 0 : URI_STRLEN(key);
+			valueLen = (value == NULL) ? 0 : URI_STRLEN(value);
+			queryList = queryList->next;
+		} else if (itemIndex < itemCount) {
+			key = keys[itemIndex].first;
+			value = (values == NULL) ? NULL : values[itemIndex].first;
+			keyLen = (key == NULL)
+					? 0 : (size_t)(keys[itemIndex].afterLast - key);
+			valueLen = (value == NULL)
+					? 0 : (size_t)(values[itemIndex].afterLast - value);
+			itemIndex++;
+		} else {
+			break;
+		}
+
+		if ((keyLen >= (size_t)(INT_MAX / worstCase))
+				|| (valueLen >= (size_t)(INT_MAX / worstCase))) {
 			return URI_ERROR_OUTPUT_TOO_LARGE;
 		}
-		keyRequiredChars = worstCase * keyLen;
-		valueRequiredChars = worstCase * valueLen;
+		keyRequiredChars = worstCase * (int)keyLen;
+		valueRequiredChars = worstCase * (int)valueLen;
 
 		if (dest == NULL) {
 			(*charsRequired) += ampersandLen + keyRequiredChars + ((value == NULL)
@@ -266,8 +326,6 @@ int URI_FUNC(ComposeQueryEngine)(URI_CHAR * dest,
 						write, spaceToPlus, normalizeBreaks);
 			}
 		}
-
-		queryList = queryList->next;
 	}
 
 	if (dest != NULL) {
@@ -73,6 +73,29 @@ static int URI_FUNC(ToStringEngine)(URI_CHAR * dest, const URI_TYPE(Uri) * uri,
 
 
 
+/* Output of ToReverseHostKeyEngine, counts only if dest is NULL */
+typedef struct URI_TYPE(KeyWriterStruct) {
+	URI_CHAR * dest;
+	int maxChars;
+	int written;
+	UriBool tooLong;
+} URI_TYPE(KeyWriter);
+
+static void URI_FUNC(KeyWriterAppend)(URI_TYPE(KeyWriter) * writer,
+		URI_CHAR c);
+static void URI_FUNC(KeyWriterAppendRange)(URI_TYPE(KeyWriter) * writer,
+		const URI_CHAR * first, const URI_CHAR * afterLast,
+		UriBool lowercase, UriBool fixPercent);
+static void URI_FUNC(KeyWriterAppendNumber)(URI_TYPE(KeyWriter) * writer,
+		unsigned int value);
+static void URI_FUNC(KeyWriterAppendReversedHost)(URI_TYPE(KeyWriter) * writer,
+		const URI_CHAR * first, const URI_CHAR * afterLast);
+static int URI_FUNC(ToReverseHostKeyEngine)(URI_CHAR * dest,
+		const URI_TYPE(Uri) * uri, int maxChars, int * charsWritten,
+		int * charsRequired);
+
+
+
 int URI_FUNC(ToStringCharsRequired)(const URI_TYPE(Uri) * uri,
 		int * charsRequired) {
 	const int MAX_CHARS = ((unsigned int)-1) >> 1;
@@ -250,68 +273,25 @@ static URI_INLINE int URI_FUNC(ToStringEngine)(URI_CHAR * dest,
 							}
 						}
 					} else if (uri->hostData.ip6 != NULL) {
-						/* IPv6 */
-						int i = 0;
-						if (dest != NULL) {
-							if (written + 1 <= maxChars) {
-								memcpy(dest + written, _UT("["),
-										1 * sizeof(URI_CHAR));
-								written += 1;
-							} else {
-								dest[0] = _UT('\0');
-								if (charsWritten != NULL) {
-									*charsWritten = 0;
-								}
-								return URI_ERROR_TOSTRING_TOO_LONG;
-							}
+						/* IPv6, as in the host text (see URI_NORMALIZE_IP6),
+						 * in canonical form (RFC 5952) if there is none */
+						URI_CHAR text[URI_IP6_TEXT_MAX_CHARS];
+						const URI_CHAR * first = uri->hostText.first;
+						int charsToWrite;
+						if (first != NULL) {
+							charsToWrite = (int)(uri->hostText.afterLast - first);
 						} else {
-							(*charsRequired) += 1;
+							charsToWrite = URI_FUNC(WriteIpSixAddress)(text,
+									uri->hostData.ip6->data);
+							first = text;
 						}
-
-						for (; i < 16; i++) {
-							const unsigned char value = uri->hostData.ip6->data[i];
-							if (dest != NULL) {
-								if (written + 2 <= maxChars) {
-									URI_CHAR text[3];
-									text[0] = URI_FUNC(HexToLetterEx)(value / 16, URI_FALSE);
-									text[1] = URI_FUNC(HexToLetterEx)(value % 16, URI_FALSE);
-									text[2] = _UT('\0');
-									memcpy(dest + written, text, 2 * sizeof(URI_CHAR));
-									written += 2;
-								} else {
-									dest[0] = _UT('\0');
-									if (charsWritten != NULL) {
-										*charsWritten = 0;
-									}
-									return URI_ERROR_TOSTRING_TOO_LONG;
-								}
-							} else {
-								(*charsRequired) += 2;
-							}
-							if (((i & 1) == 1) && (i < 15)) {
-								if (dest != NULL) {
-									if (written + 1 <= maxChars) {
-										memcpy(dest + written, _UT(":"),
-												1 * sizeof(URI_CHAR));
-										written += 1;
-									} else {
-										dest[0] = _UT('\0');
-										if (charsWritten != NULL) {
-											*charsWritten = 0;
-										}
-										return URI_ERROR_TOSTRING_TOO_LONG;
-									}
-								} else {
-									(*charsRequired) += 1;
-								}
-							}
-						}
-
 						if (dest != NULL) {
-							if (written + 1 <= maxChars) {
-								memcpy(dest + written, _UT("]"),
-										1 * sizeof(URI_CHAR));
-								written += 1;
+							if (written + charsToWrite + 2 <= maxChars) {
+								dest[written] = _UT('[');
+								memcpy(dest + written + 1, first,
+										charsToWrite * sizeof(URI_CHAR));
+								dest[written + 1 + charsToWrite] = _UT(']');
+								written += charsToWrite + 2;
 							} else {
 								dest[0] = _UT('\0');
 								if (charsWritten != NULL) {
@@ -320,7 +300,7 @@ static URI_INLINE int URI_FUNC(ToStringEngine)(URI_CHAR * dest,
 								return URI_ERROR_TOSTRING_TOO_LONG;
 							}
 						} else {
-							(*charsRequired) += 1;
+							(*charsRequired) += charsToWrite + 2;
 						}
 					} else if (uri->hostData.ipFuture.first != NULL) {
 						/* IPvFuture */
@@ -441,12 +421,14 @@ static URI_INLINE int URI_FUNC(ToStringEngine)(URI_CHAR * dest,
 				}
 
 				if (uri->pathHead != NULL) {
-					URI_TYPE(PathSegment) * walker = uri->pathHead;
-					do {
-						const int charsToWrite = (int)(walker->text.afterLast - walker->text.first);
+					URI_TYPE(PathIterator) iterator;
+					const URI_TYPE(TextRange) * walker;
+					URI_FUNC(PathIteratorBegin)(&iterator, uri);
+					while ((walker = URI_FUNC(PathIteratorNext)(&iterator)) != NULL) {
+						const int charsToWrite = (int)(walker->afterLast - walker->first);
 						if (dest != NULL) {
 							if (written + charsToWrite <= maxChars) {
-								memcpy(dest + written, walker->text.first,
+								memcpy(dest + written, walker->first,
 										charsToWrite * sizeof(URI_CHAR));
 								written += charsToWrite;
 							} else {
@@ -461,7 +443,7 @@ static URI_INLINE int URI_FUNC(ToStringEngine)(URI_CHAR * dest,
 						}
 
 						/* Not last segment -> append slash */
-						if (walker->next != NULL) {
+						if (!iterator.done) {
 							if (dest != NULL) {
 								if (written + 1 <= maxChars) {
 									memcpy(dest + written, _UT("/"),
@@ -478,9 +460,7 @@ static URI_INLINE int URI_FUNC(ToStringEngine)(URI_CHAR * dest,
 								(*charsRequired) += 1;
 							}
 						}
-
-						walker = walker->next;
-					} while (walker != NULL);
+					}
 				}
 	/* [11/19]	if defined(query) then */
 				if (uri->query.first != NULL) {
@@ -574,4 +554,263 @@ static URI_INLINE int URI_FUNC(ToStringEngine)(URI_CHAR * dest,
 
 
 
+static URI_INLINE void URI_FUNC(KeyWriterAppend)(URI_TYPE(KeyWriter) * writer,
+		URI_CHAR c) {
+	if (writer->dest != NULL) {
+		if (writer->written >= writer->maxChars) {
+			writer->tooLong = URI_TRUE;
+			return;
+		}
+		writer->dest[writer->written] = c;
+	}
+	writer->written++;
+}
+
+
+
+static URI_INLINE void URI_FUNC(KeyWriterAppendRange)(
+		URI_TYPE(KeyWriter) * writer,
+		const URI_CHAR * first, const URI_CHAR * afterLast,
+		UriBool lowercase, UriBool fixPercent) {
+	URI_TYPE(TextRange) range;
+	URI_TYPE(NormalizedCursor) cursor;
+	int c;
+
+	range.first = first;
+	range.afterLast = afterLast;
+	URI_FUNC(NormalizedCursorInit)(&cursor, &range, lowercase, fixPercent);
+	while ((c = URI_FUNC(NormalizedCursorNext)(&cursor)) != -1) {
+		URI_FUNC(KeyWriterAppend)(writer, (URI_CHAR)c);
+	}
+}
+
+
+
+static URI_INLINE void URI_FUNC(KeyWriterAppendNumber)(
+		URI_TYPE(KeyWriter) * writer, unsigned int value) {
+	URI_CHAR digits[10];
+	int count = 0;
+	do {
+		digits[count++] = (URI_CHAR)(_UT('0') + (value % 10));
+		value /= 10;
+	} while (value > 0);
+	while (count > 0) {
+		URI_FUNC(KeyWriterAppend)(writer, digits[--count]);
+	}
+}
+
+
+
+/* Writes the labels of a registered name in reverse order, lowercased
+ * and with percent-encoding normalized; as normalization decodes
+ * "%2E" to ".", such triplets separate labels, too */
+static URI_INLINE void URI_FUNC(KeyWriterAppendReversedHost)(
+		URI_TYPE(KeyWriter) * writer,
+		const URI_CHAR * first, const URI_CHAR * afterLast) {
+	const URI_CHAR * labelAfterLast = afterLast;
+	for (;;) {
+		const URI_CHAR * labelFirst = labelAfterLast;
+		int separatorLen = 0;
+		while (labelFirst > first) {
+			if (labelFirst[-1] == _UT('.')) {
+				separatorLen = 1;
+				break;
+			} else if ((labelFirst - first >= 3)
+					&& (labelFirst[-3] == _UT('%'))
+					&& (labelFirst[-2] == _UT('2'))
+					&& ((labelFirst[-1] == _UT('E'))
+						|| (labelFirst[-1] == _UT('e')))) {
+				separatorLen = 3;
+				break;
+			}
+			labelFirst--;
+		}
+
+		URI_FUNC(KeyWriterAppendRange)(writer, labelFirst, labelAfterLast,
+				URI_TRUE, URI_TRUE);
+		if (separatorLen == 0) {
+			break;
+		}
+		URI_FUNC(KeyWriterAppend)(writer, _UT('.'));
+		labelAfterLast = labelFirst - separatorLen;
+	}
+}
+
+
+
+static int URI_FUNC(ToReverseHostKeyEngine)(URI_CHAR * dest,
+		const URI_TYPE(Uri) * uri, int maxChars, int * charsWritten,
+		int * charsRequired) {
+	URI_TYPE(KeyWriter) writer;
+	URI_TYPE(NormalizedPathWalker) walker;
+	const URI_TYPE(TextRange) * segment;
+	UriBool firstSegment = URI_TRUE;
+	int port;
+
+	if ((uri == NULL) || ((dest == NULL) && (charsRequired == NULL))) {
+		if (charsWritten != NULL) {
+			*charsWritten = 0;
+		}
+		return URI_ERROR_NULL;
+	}
+
+	if (maxChars < 1) {
+		if (charsWritten != NULL) {
+			*charsWritten = 0;
+		}
+		return URI_ERROR_OUTPUT_TOO_LARGE;
+	}
+
+	writer.dest = dest;
+	writer.maxChars = maxChars - 1;  /* for the terminator */
+	writer.written = 0;
+	writer.tooLong = URI_FALSE;
+
+	/* Host */
+	if (uri->hostData.ip4 != NULL) {
+		int i = 0;
+		for (; i < 4; i++) {
+			if (i > 0) {
+				URI_FUNC(KeyWriterAppend)(&writer, _UT('.'));
+			}
+			URI_FUNC(KeyWriterAppendNumber)(&writer, uri->hostData.ip4->data[i]);
+		}
+	} else if (uri->hostData.ip6 != NULL) {
+		URI_CHAR text[URI_IP6_TEXT_MAX_CHARS];
+		const int lenInChars = URI_FUNC(WriteIpSixAddress)(text,
+				uri->hostData.ip6->data);
+		URI_FUNC(KeyWriterAppend)(&writer, _UT('['));
+		URI_FUNC(KeyWriterAppendRange)(&writer, text, text + lenInChars,
+				URI_FALSE, URI_FALSE);
+		URI_FUNC(KeyWriterAppend)(&writer, _UT(']'));
+	} else if (uri->hostData.ipFuture.first != NULL) {
+		URI_FUNC(KeyWriterAppend)(&writer, _UT('['));
+		URI_FUNC(KeyWriterAppendRange)(&writer, uri->hostData.ipFuture.first,
+				uri->hostData.ipFuture.afterLast, URI_TRUE, URI_FALSE);
+		URI_FUNC(KeyWriterAppend)(&writer, _UT(']'));
+	} else if (uri->hostText.first != NULL) {
+		URI_FUNC(KeyWriterAppendReversedHost)(&writer, uri->hostText.first,
+				uri->hostText.afterLast);
+	}
+
+	/* Port, explicit or the scheme's default */
+	port = URI_FUNC(ParsePortNumber)(&(uri->portText));
+	if (port == -2) {
+		/* Beyond 65535, copied without leading zeros */
+		const URI_CHAR * digit = uri->portText.first;
+		while (*digit == _UT('0')) {
+			digit++;
+		}
+		URI_FUNC(KeyWriterAppend)(&writer, _UT(':'));
+		URI_FUNC(KeyWriterAppendRange)(&writer, digit, uri->portText.afterLast,
+				URI_FALSE, URI_FALSE);
+	} else {
+		if (port == -1) {
+			port = URI_FUNC(GetDefaultPort)(&(uri->scheme));
+		}
+		if (port != -1) {
+			URI_FUNC(KeyWriterAppend)(&writer, _UT(':'));
+			URI_FUNC(KeyWriterAppendNumber)(&writer, (unsigned int)port);
+		}
+	}
+
+	/* Path, with dot segments removed */
+	URI_FUNC(NormalizedPathWalkerInit)(&walker, uri, URI_TRUE);
+	while ((segment = URI_FUNC(NormalizedPathWalkerNext)(&walker)) != NULL) {
+		if (!firstSegment || walker.hostSet || uri->absolutePath) {
+			URI_FUNC(KeyWriterAppend)(&writer, _UT('/'));
+		}
+		URI_FUNC(KeyWriterAppendRange)(&writer, segment->first,
+				segment->afterLast, URI_FALSE, URI_TRUE);
+		firstSegment = URI_FALSE;
+	}
+	if (firstSegment && (walker.hostSet || uri->absolutePath)) {
+		/* Empty path equals "/" then */
+		URI_FUNC(KeyWriterAppend)(&writer, _UT('/'));
+	}
+
+	/* Query */
+	if (uri->query.first != NULL) {
+		URI_FUNC(KeyWriterAppend)(&writer, _UT('?'));
+		URI_FUNC(KeyWriterAppendRange)(&writer, uri->query.first,
+				uri->query.afterLast, URI_FALSE, URI_TRUE);
+	}
+
+	/* Scheme, last so that keys of a host stay next to each other.
+	 * No other part of the key can contain a '#'. */
+	if (uri->scheme.first != NULL) {
+		URI_FUNC(KeyWriterAppend)(&writer, _UT('#'));
+		URI_FUNC(KeyWriterAppendRange)(&writer, uri->scheme.first,
+				uri->scheme.afterLast, URI_TRUE, URI_FALSE);
+	}
+
+	if (dest == NULL) {
+		*charsRequired = writer.written;
+		return URI_SUCCESS;
+	}
+
+	if (writer.tooLong) {
+		dest[0] = _UT('\0');
+		if (charsWritten != NULL) {
+			*charsWritten = 0;
+		}
+		return URI_ERROR_OUTPUT_TOO_LARGE;
+	}
+
+	dest[writer.written++] = _UT('\0');
+	if (charsWritten != NULL) {
+		*charsWritten = writer.written;
+	}
+	return URI_SUCCESS;
+}
+
+
+
+int URI_FUNC(ToReverseHostKeyCharsRequired)(const URI_TYPE(Uri) * uri,
+		int * charsRequired) {
+	const int MAX_CHARS = ((unsigned int)-1) >> 1;
+	return URI_FUNC(ToReverseHostKeyEngine)(NULL, uri, MAX_CHARS, NULL,
+			charsRequired);
+}
+
+
+
+int URI_FUNC(ToReverseHostKey)(URI_CHAR * dest, const URI_TYPE(Uri) * uri,
+		int maxChars, int * charsWritten) {
+	return URI_FUNC(ToReverseHostKeyEngine)(dest, uri, maxChars, charsWritten,
+			NULL);
+}
+
+
+
+int URI_FUNC(ToStringIpSixAddress)(URI_CHAR * dest,
+		const unsigned char * octets, int maxChars, int * charsWritten) {
+	URI_CHAR text[URI_IP6_TEXT_MAX_CHARS];
+	int lenInChars;
+
+	if ((dest == NULL) || (octets == NULL)) {
+		return URI_ERROR_NULL;
+	}
+
+	lenInChars = URI_FUNC(WriteIpSixAddress)(text, octets);
+	if (lenInChars + 1 > maxChars) {
+		if (maxChars > 0) {
+			dest[0] = _UT('\0');
+		}
+		if (charsWritten != NULL) {
+			*charsWritten = 0;
+		}
+		return URI_ERROR_OUTPUT_TOO_LARGE;
+	}
+
+	memcpy(dest, text, lenInChars * sizeof(URI_CHAR));
+	dest[lenInChars] = _UT('\0');
+	if (charsWritten != NULL) {
+		*charsWritten = lenInChars + 1;
+	}
+	return URI_SUCCESS;
+}
+
+
+
 #endif
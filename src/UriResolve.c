@@ -73,12 +73,17 @@
  * the absolute URI is replaced. */
 static URI_INLINE UriBool URI_FUNC(MergePath)(URI_TYPE(Uri) * absWork,
 		const URI_TYPE(Uri) * relAppend, UriMemoryManager * memory) {
-	URI_TYPE(PathSegment) * sourceWalker;
-	URI_TYPE(PathSegment) * destPrev;
+	URI_TYPE(PathIterator) sourceIterator;
+	const URI_TYPE(TextRange) * sourceSegment;
 	if (relAppend->pathHead == NULL) {
 		return URI_TRUE;
 	}
 
+	/* The last segment is replaced below, so split up a lazy path first */
+	if (!URI_FUNC(MaterializePath)(absWork, memory)) {
+		return URI_FALSE; /* Raises malloc error */
+	}
+
 	/* Replace last segment ("" if trailing slash) with first of append chain */
 	if (absWork->pathHead == NULL) {
 		URI_TYPE(PathSegment) * const dup = memory->malloc(memory, sizeof(URI_TYPE(PathSegment)));
@@ -86,36 +91,25 @@ static URI_INLINE UriBool URI_FUNC(MergePath)(URI_TYPE(Uri) * absWork,
 			return URI_FALSE; /* Raises malloc error */
 		}
 		dup->next = NULL;
+		dup->reserved = NULL;
 		absWork->pathHead = dup;
 		absWork->pathTail = dup;
 	}
-	absWork->pathTail->text.first = relAppend->pathHead->text.first;
-	absWork->pathTail->text.afterLast = relAppend->pathHead->text.afterLast;
+	URI_FUNC(PathIteratorBegin)(&sourceIterator, relAppend);
+	sourceSegment = URI_FUNC(PathIteratorNext)(&sourceIterator);
+	absWork->pathTail->text = *sourceSegment;
 
 	/* Append all the others */
-	sourceWalker = relAppend->pathHead->next;
-	if (sourceWalker == NULL) {
-		return URI_TRUE;
-	}
-	destPrev = absWork->pathTail;
-
-	for (;;) {
+	while ((sourceSegment = URI_FUNC(PathIteratorNext)(&sourceIterator))
+			!= NULL) {
 		URI_TYPE(PathSegment) * const dup = memory->malloc(memory, sizeof(URI_TYPE(PathSegment)));
 		if (dup == NULL) {
-			destPrev->next = NULL;
-			absWork->pathTail = destPrev;
 			return URI_FALSE; /* Raises malloc error */
 		}
-		dup->text = sourceWalker->text;
-		destPrev->next = dup;
-
-		if (sourceWalker->next == NULL) {
-			absWork->pathTail = dup;
-			absWork->pathTail->next = NULL;
-			break;
-		}
-		destPrev = dup;
-		sourceWalker = sourceWalker->next;
+		dup->text = *sourceSegment;
+		dup->next = NULL;
+		absWork->pathTail->next = dup;
+		absWork->pathTail = dup;
 	}
 
 	return URI_TRUE;
@@ -138,6 +132,7 @@ static int URI_FUNC(ResolveAbsolutePathFlag)(URI_TYPE(Uri) * absWork,
 			segment->text.first = URI_FUNC(SafeToPointTo);
 			segment->text.afterLast = URI_FUNC(SafeToPointTo);
 			segment->next = NULL;
+			segment->reserved = NULL;
 
 			absWork->pathHead = segment;
 			absWork->pathTail = segment;
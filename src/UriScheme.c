@@ -0,0 +1,221 @@
+/*
+ * uriparser - RFC 3986 URI parsing library
+ *
+ * Copyright (C) 2020, Weijia Song <songweijia@gmail.com>
+ * Copyright (C) 2020, Sebastian Pipping <sebastian@pipping.org>
+ * All rights reserved.
+ *
+ * Redistribution and use in source  and binary forms, with or without
+ * modification, are permitted provided  that the following conditions
+ * are met:
+ *
+ *     1. Redistributions  of  source  code   must  retain  the  above
+ *        copyright notice, this list  of conditions and the following
+ *        disclaimer.
+ *
+ *     2. Redistributions  in binary  form  must  reproduce the  above
+ *        copyright notice, this list  of conditions and the following
+ *        disclaimer  in  the  documentation  and/or  other  materials
+ *        provided with the distribution.
+ *
+ *     3. Neither the  name of the  copyright holder nor the  names of
+ *        its contributors may be used  to endorse or promote products
+ *        derived from  this software  without specific  prior written
+ *        permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND  ANY EXPRESS OR IMPLIED WARRANTIES,  INCLUDING, BUT NOT
+ * LIMITED TO,  THE IMPLIED WARRANTIES OF  MERCHANTABILITY AND FITNESS
+ * FOR  A  PARTICULAR  PURPOSE  ARE  DISCLAIMED.  IN  NO  EVENT  SHALL
+ * THE  COPYRIGHT HOLDER  OR CONTRIBUTORS  BE LIABLE  FOR ANY  DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL,  EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO,  PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA,  OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT  LIABILITY,  OR  TORT (INCLUDING  NEGLIGENCE  OR  OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file UriScheme.c
+ * Holds the scheme classification implementation.
+ * NOTE: This source file includes itself twice.
+ */
+
+/* What encodings are enabled? */
+#include <uriparser/UriDefsConfig.h>
+#if (!defined(URI_PASS_ANSI) && !defined(URI_PASS_UNICODE))
+/* Include SELF twice */
+# ifdef URI_ENABLE_ANSI
+#  define URI_PASS_ANSI 1
+#  include "UriScheme.c"
+#  undef URI_PASS_ANSI
+# endif
+# ifdef URI_ENABLE_UNICODE
+#  define URI_PASS_UNICODE 1
+#  include "UriScheme.c"
+#  undef URI_PASS_UNICODE
+# endif
+#else
+# ifdef URI_PASS_ANSI
+#  include <uriparser/UriDefsAnsi.h>
+# else
+#  include <uriparser/UriDefsUnicode.h>
+#  include <wchar.h>
+# endif
+
+
+
+#ifndef URI_DOXYGEN
+# include <uriparser/Uri.h>
+#endif
+
+
+
+static UriBool URI_FUNC(SchemeEquals)(const URI_CHAR * first,
+		const URI_CHAR * afterLast, const char * name);
+static UriSchemeId URI_FUNC(ClassifyScheme)(const URI_CHAR * first,
+		const URI_CHAR * afterLast);
+
+
+
+/* Compares case-insensitively against a lowercase name */
+static URI_INLINE UriBool URI_FUNC(SchemeEquals)(const URI_CHAR * first,
+		const URI_CHAR * afterLast, const char * name) {
+	for (; first < afterLast; first++, name++) {
+		URI_CHAR c = *first;
+		if ((c >= _UT('A')) && (c <= _UT('Z'))) {
+			c = (URI_CHAR)(c + (_UT('a') - _UT('A')));
+		}
+		if ((*name == '\0') || (c != (URI_CHAR)*name)) {
+			return URI_FALSE;
+		}
+	}
+	return (*name == '\0') ? URI_TRUE : URI_FALSE;
+}
+
+
+
+/* Length and first letter select a single candidate (a perfect hash),
+ * so only one full comparison is needed */
+static URI_INLINE UriSchemeId URI_FUNC(ClassifyScheme)(const URI_CHAR * first,
+		const URI_CHAR * afterLast) {
+	UriSchemeId candidate = URI_SCHEME_UNKNOWN;
+	const char * name = NULL;
+
+	switch (afterLast - first) {
+	case 2:
+		switch (first[0]) {
+		case _UT('w'):
+		case _UT('W'):
+			candidate = URI_SCHEME_WS;
+			name = "ws";
+			break;
+		}
+		break;
+
+	case 3:
+		switch (first[0]) {
+		case _UT('w'):
+		case _UT('W'):
+			candidate = URI_SCHEME_WSS;
+			name = "wss";
+			break;
+
+		case _UT('f'):
+		case _UT('F'):
+			candidate = URI_SCHEME_FTP;
+			name = "ftp";
+			break;
+
+		case _UT('u'):
+		case _UT('U'):
+			candidate = URI_SCHEME_URN;
+			name = "urn";
+			break;
+		}
+		break;
+
+	case 4:
+		switch (first[0]) {
+		case _UT('h'):
+		case _UT('H'):
+			candidate = URI_SCHEME_HTTP;
+			name = "http";
+			break;
+
+		case _UT('f'):
+		case _UT('F'):
+			candidate = URI_SCHEME_FILE;
+			name = "file";
+			break;
+
+		case _UT('d'):
+		case _UT('D'):
+			candidate = URI_SCHEME_DATA;
+			name = "data";
+			break;
+		}
+		break;
+
+	case 5:
+		switch (first[0]) {
+		case _UT('h'):
+		case _UT('H'):
+			candidate = URI_SCHEME_HTTPS;
+			name = "https";
+			break;
+		}
+		break;
+
+	case 6:
+		switch (first[0]) {
+		case _UT('m'):
+		case _UT('M'):
+			candidate = URI_SCHEME_MAILTO;
+			name = "mailto";
+			break;
+		}
+		break;
+	}
+
+	if ((name == NULL) || !URI_FUNC(SchemeEquals)(first, afterLast, name)) {
+		return URI_SCHEME_UNKNOWN;
+	}
+	return candidate;
+}
+
+
+
+UriSchemeId URI_FUNC(GetSchemeId)(const URI_TYPE(Uri) * uri) {
+	if ((uri == NULL) || (uri->scheme.first == NULL)) {
+		return URI_SCHEME_NONE;
+	}
+	return URI_FUNC(ClassifyScheme)(uri->scheme.first, uri->scheme.afterLast);
+}
+
+
+
+int URI_FUNC(GetSchemeIdEx)(const URI_TYPE(Uri) * uri,
+		const char * const * customSchemes, int customCount) {
+	const UriSchemeId id = URI_FUNC(GetSchemeId)(uri);
+	int i = 0;
+
+	if ((id != URI_SCHEME_UNKNOWN) || (customSchemes == NULL)) {
+		return id;
+	}
+
+	for (; i < customCount; i++) {
+		if ((customSchemes[i] != NULL)
+				&& URI_FUNC(SchemeEquals)(uri->scheme.first,
+					uri->scheme.afterLast, customSchemes[i])) {
+			return URI_SCHEME_CUSTOM + i;
+		}
+	}
+	return URI_SCHEME_UNKNOWN;
+}
+
+
+
+#endif
@@ -78,6 +78,7 @@ static URI_INLINE UriBool URI_FUNC(AppendSegment)(URI_TYPE(Uri) * uri,
 		return URI_FALSE; /* Raises malloc error */
 	}
 	segment->next = NULL;
+	segment->reserved = NULL;
 	segment->text.first = first;
 	segment->text.afterLast = afterLast;
 
@@ -197,8 +198,10 @@ static int URI_FUNC(RemoveBaseUriImpl)(URI_TYPE(Uri) * dest,
 							}
 	/* [18/50]	      else */
 						} else {
-							const URI_TYPE(PathSegment) * sourceSeg = absSource->pathHead;
-							const URI_TYPE(PathSegment) * baseSeg = absBase->pathHead;
+							URI_TYPE(PathIterator) sourceIterator;
+							URI_TYPE(PathIterator) baseIterator;
+							const URI_TYPE(TextRange) * sourceSeg;
+							const URI_TYPE(TextRange) * baseSeg;
 	/* [19/50]	         bool pathNaked = true; */
 							UriBool pathNaked = URI_TRUE;
 	/* [20/50]	         undef(last(Base.path)); */
@@ -206,20 +209,24 @@ static int URI_FUNC(RemoveBaseUriImpl)(URI_TYPE(Uri) * dest,
 	/* [21/50]	         T.path = ""; */
 							dest->absolutePath = URI_FALSE;
 	/* [22/50]	         while (first(A.path) == first(Base.path)) do */
+							URI_FUNC(PathIteratorBegin)(&sourceIterator, absSource);
+							URI_FUNC(PathIteratorBegin)(&baseIterator, absBase);
+							sourceSeg = URI_FUNC(PathIteratorNext)(&sourceIterator);
+							baseSeg = URI_FUNC(PathIteratorNext)(&baseIterator);
 							while ((sourceSeg != NULL) && (baseSeg != NULL)
-									&& !URI_FUNC(CompareRange)(&sourceSeg->text, &baseSeg->text)
-									&& !((sourceSeg->text.first == sourceSeg->text.afterLast)
-										&& ((sourceSeg->next == NULL) != (baseSeg->next == NULL)))) {
+									&& !URI_FUNC(CompareRange)(sourceSeg, baseSeg)
+									&& !((sourceSeg->first == sourceSeg->afterLast)
+										&& (sourceIterator.done != baseIterator.done))) {
 	/* [23/50]	            A.path++; */
-								sourceSeg = sourceSeg->next;
+								sourceSeg = URI_FUNC(PathIteratorNext)(&sourceIterator);
 	/* [24/50]	            Base.path++; */
-								baseSeg = baseSeg->next;
+								baseSeg = URI_FUNC(PathIteratorNext)(&baseIterator);
 	/* [25/50]	         endwhile; */
 							}
 	/* [26/50]	         while defined(first(Base.path)) do */
-							while ((baseSeg != NULL) && (baseSeg->next != NULL)) {
+							while ((baseSeg != NULL) && !baseIterator.done) {
 	/* [27/50]	            Base.path++; */
-								baseSeg = baseSeg->next;
+								baseSeg = URI_FUNC(PathIteratorNext)(&baseIterator);
 	/* [28/50]	            T.path += "../"; */
 								if (!URI_FUNC(AppendSegment)(dest, URI_FUNC(ConstParent),
 										URI_FUNC(ConstParent) + 2, memory)) {
@@ -235,8 +242,8 @@ static int URI_FUNC(RemoveBaseUriImpl)(URI_TYPE(Uri) * dest,
 								if (pathNaked == URI_TRUE) {
 	/* [33/50]	               if (first(A.path) contains ":") then */
 									UriBool containsColon = URI_FALSE;
-									const URI_CHAR * ch = sourceSeg->text.first;
-									for (; ch < sourceSeg->text.afterLast; ch++) {
+									const URI_CHAR * ch = sourceSeg->first;
+									for (; ch < sourceSeg->afterLast; ch++) {
 										if (*ch == _UT(':')) {
 											containsColon = URI_TRUE;
 											break;
@@ -250,7 +257,7 @@ static int URI_FUNC(RemoveBaseUriImpl)(URI_TYPE(Uri) * dest,
 											return URI_ERROR_MALLOC;
 										}
 	/* [35/50]	               elseif (first(A.path) == "") then */
-									} else if (sourceSeg->text.first == sourceSeg->text.afterLast) {
+									} else if (sourceSeg->first == sourceSeg->afterLast) {
 	/* [36/50]	                  T.path += "/."; */
 										if (!URI_FUNC(AppendSegment)(dest, URI_FUNC(ConstPwd),
 												URI_FUNC(ConstPwd) + 1, memory)) {
@@ -261,14 +268,14 @@ static int URI_FUNC(RemoveBaseUriImpl)(URI_TYPE(Uri) * dest,
 	/* [38/50]	            endif; */
 								}
 	/* [39/50]	            T.path += first(A.path); */
-								if (!URI_FUNC(AppendSegment)(dest, sourceSeg->text.first,
-										sourceSeg->text.afterLast, memory)) {
+								if (!URI_FUNC(AppendSegment)(dest, sourceSeg->first,
+										sourceSeg->afterLast, memory)) {
 									return URI_ERROR_MALLOC;
 								}
 	/* [40/50]	            pathNaked = false; */
 								pathNaked = URI_FALSE;
 	/* [41/50]	            A.path++; */
-								sourceSeg = sourceSeg->next;
+								sourceSeg = URI_FUNC(PathIteratorNext)(&sourceIterator);
 	/* [42/50]	            if defined(first(A.path)) then */
 								/* NOOP */
 	/* [43/50]	               T.path += + "/"; */
@@ -293,6 +300,298 @@ static int URI_FUNC(RemoveBaseUriImpl)(URI_TYPE(Uri) * dest,
 
 
 
+/* Host kinds distinguished by EqualsAuthority */
+#ifndef URI_SHORTEN_HOST_KINDS_DEFINED
+# define URI_SHORTEN_HOST_KINDS_DEFINED 1
+enum {
+	URI_SHORTEN_HOST_REGNAME,
+	URI_SHORTEN_HOST_IP4,
+	URI_SHORTEN_HOST_IP6,
+	URI_SHORTEN_HOST_IP_FUTURE
+};
+#endif
+
+
+
+struct URI_TYPE(PrecompiledBaseStruct) {
+	const URI_TYPE(Uri) * uri; /* Base, not owned */
+	int hostKind; /* Cheap fingerprint of the authority.. */
+	int hostLength; /* ..to reject other hosts without comparing text */
+	URI_TYPE(TextRange) * segments; /* Path segments as array */
+	int segmentCount;
+	UriMemoryManager * memory;
+};
+
+
+
+/* Output of RemovePrecompiledBaseToString */
+typedef struct URI_TYPE(ShortenWriterStruct) {
+	URI_CHAR * dest;
+	int maxChars; /* excluding terminator */
+	int written;
+	UriBool tooLong;
+	UriBool segmentWritten;
+} URI_TYPE(ShortenWriter);
+
+
+
+static void URI_FUNC(HostFingerprint)(const URI_TYPE(Uri) * uri,
+		int * hostKind, int * hostLength) {
+	if (uri->hostData.ip4 != NULL) {
+		*hostKind = URI_SHORTEN_HOST_IP4;
+		*hostLength = 4;
+	} else if (uri->hostData.ip6 != NULL) {
+		*hostKind = URI_SHORTEN_HOST_IP6;
+		*hostLength = 16;
+	} else if (uri->hostData.ipFuture.first != NULL) {
+		*hostKind = URI_SHORTEN_HOST_IP_FUTURE;
+		*hostLength = (int)(uri->hostData.ipFuture.afterLast
+				- uri->hostData.ipFuture.first);
+	} else {
+		*hostKind = URI_SHORTEN_HOST_REGNAME;
+		*hostLength = (uri->hostText.first == NULL)
+				? -1
+				: (int)(uri->hostText.afterLast - uri->hostText.first);
+	}
+}
+
+
+
+static void URI_FUNC(ShortenWriterAppend)(URI_TYPE(ShortenWriter) * writer,
+		const URI_CHAR * first, const URI_CHAR * afterLast) {
+	const int charsToWrite = (int)(afterLast - first);
+	if (writer->tooLong) {
+		return;
+	}
+	if (charsToWrite > writer->maxChars - writer->written) {
+		writer->tooLong = URI_TRUE;
+		return;
+	}
+	memcpy(writer->dest + writer->written, first,
+			charsToWrite * sizeof(URI_CHAR));
+	writer->written += charsToWrite;
+}
+
+
+
+/* Appends a path segment, with a slash before all but the first */
+static void URI_FUNC(ShortenWriterAppendSegment)(
+		URI_TYPE(ShortenWriter) * writer,
+		const URI_CHAR * first, const URI_CHAR * afterLast) {
+	if (writer->segmentWritten) {
+		URI_FUNC(ShortenWriterAppend)(writer, _UT("/"), _UT("/") + 1);
+	}
+	URI_FUNC(ShortenWriterAppend)(writer, first, afterLast);
+	writer->segmentWritten = URI_TRUE;
+}
+
+
+
+int URI_FUNC(CreatePrecompiledBase)(URI_TYPE(PrecompiledBase) ** base,
+		const URI_TYPE(Uri) * absBase, UriMemoryManager * memory) {
+	URI_TYPE(PrecompiledBase) * precompiled;
+	URI_TYPE(PathIterator) iterator;
+	const URI_TYPE(TextRange) * walker;
+	int segmentCount = 0;
+	int i = 0;
+
+	if ((base == NULL) || (absBase == NULL)) {
+		return URI_ERROR_NULL;
+	}
+	*base = NULL;
+
+	URI_CHECK_MEMORY_MANAGER(memory);  /* may return */
+
+	if (absBase->scheme.first == NULL) {
+		return URI_ERROR_REMOVEBASE_REL_BASE;
+	}
+
+	URI_FUNC(GetPathSegmentCount)(absBase, &segmentCount);
+
+	precompiled = memory->malloc(memory, sizeof(URI_TYPE(PrecompiledBase)));
+	if (precompiled == NULL) {
+		return URI_ERROR_MALLOC;
+	}
+	precompiled->segments = NULL;
+	if (segmentCount > 0) {
+		precompiled->segments = memory->malloc(memory,
+				segmentCount * sizeof(URI_TYPE(TextRange)));
+		if (precompiled->segments == NULL) {
+			memory->free(memory, precompiled);
+			return URI_ERROR_MALLOC;
+		}
+	}
+
+	URI_FUNC(PathIteratorBegin)(&iterator, absBase);
+	while ((walker = URI_FUNC(PathIteratorNext)(&iterator)) != NULL) {
+		precompiled->segments[i++] = *walker;
+	}
+	precompiled->segmentCount = segmentCount;
+	precompiled->uri = absBase;
+	precompiled->memory = memory;
+	URI_FUNC(HostFingerprint)(absBase, &precompiled->hostKind,
+			&precompiled->hostLength);
+
+	*base = precompiled;
+	return URI_SUCCESS;
+}
+
+
+
+void URI_FUNC(FreePrecompiledBase)(URI_TYPE(PrecompiledBase) * base) {
+	UriMemoryManager * memory;
+
+	if (base == NULL) {
+		return;
+	}
+
+	memory = base->memory;
+	if (base->segments != NULL) {
+		memory->free(memory, base->segments);
+	}
+	memory->free(memory, base);
+}
+
+
+
+int URI_FUNC(RemovePrecompiledBaseToString)(URI_CHAR * dest,
+		const URI_TYPE(PrecompiledBase) * base,
+		const URI_TYPE(Uri) * absSource, UriBool domainRootMode,
+		int maxChars, int * charsWritten) {
+	URI_TYPE(ShortenWriter) writer;
+	int hostKind;
+	int hostLength;
+
+	if (charsWritten != NULL) {
+		*charsWritten = 0;
+	}
+	if ((dest == NULL) || (base == NULL) || (absSource == NULL)) {
+		return URI_ERROR_NULL;
+	}
+
+	if (absSource->scheme.first == NULL) {
+		return URI_ERROR_REMOVEBASE_REL_SOURCE;
+	}
+
+	/* Different scheme: the result is the source itself */
+	if (URI_FUNC(CompareRange)(&absSource->scheme, &base->uri->scheme)) {
+		return URI_FUNC(ToString)(dest, absSource, maxChars, charsWritten);
+	}
+
+	/* Different authority: the source without its scheme */
+	URI_FUNC(HostFingerprint)(absSource, &hostKind, &hostLength);
+	if ((hostKind != base->hostKind) || (hostLength != base->hostLength)
+			|| !URI_FUNC(EqualsAuthority)(absSource, base->uri)) {
+		URI_TYPE(Uri) withoutScheme = *absSource;
+		withoutScheme.scheme.first = NULL;
+		withoutScheme.scheme.afterLast = NULL;
+		return URI_FUNC(ToString)(dest, &withoutScheme, maxChars,
+				charsWritten);
+	}
+
+	if (maxChars < 1) {
+		return URI_ERROR_OUTPUT_TOO_LARGE;
+	}
+	writer.dest = dest;
+	writer.maxChars = maxChars - 1;
+	writer.written = 0;
+	writer.tooLong = URI_FALSE;
+	writer.segmentWritten = URI_FALSE;
+
+	/* Same steps as RemoveBaseUriImpl, writing rather than building a path */
+	if (domainRootMode == URI_TRUE) {
+		URI_TYPE(PathIterator) sourceIterator;
+		const URI_TYPE(TextRange) * sourceSeg;
+
+		URI_FUNC(ShortenWriterAppend)(&writer, _UT("/"), _UT("/") + 1);
+
+		URI_FUNC(PathIteratorBegin)(&sourceIterator, absSource);
+		sourceSeg = URI_FUNC(PathIteratorNext)(&sourceIterator);
+
+		/* As done by FixAmbiguity */
+		if ((sourceSeg != NULL) && (sourceSeg->first == sourceSeg->afterLast)) {
+			URI_FUNC(ShortenWriterAppendSegment)(&writer, URI_FUNC(ConstPwd),
+					URI_FUNC(ConstPwd) + 1);
+		}
+		for (; sourceSeg != NULL;
+				sourceSeg = URI_FUNC(PathIteratorNext)(&sourceIterator)) {
+			URI_FUNC(ShortenWriterAppendSegment)(&writer,
+					sourceSeg->first, sourceSeg->afterLast);
+		}
+	} else {
+		URI_TYPE(PathIterator) sourceIterator;
+		const URI_TYPE(TextRange) * sourceSeg;
+		const int segmentCount = base->segmentCount;
+		int baseIndex = 0;
+		UriBool pathNaked = URI_TRUE;
+
+		URI_FUNC(PathIteratorBegin)(&sourceIterator, absSource);
+		sourceSeg = URI_FUNC(PathIteratorNext)(&sourceIterator);
+		while ((sourceSeg != NULL) && (baseIndex < segmentCount)
+				&& !URI_FUNC(CompareRange)(sourceSeg,
+					&base->segments[baseIndex])
+				&& !((sourceSeg->first == sourceSeg->afterLast)
+					&& (sourceIterator.done
+						!= (baseIndex + 1 == segmentCount)))) {
+			sourceSeg = URI_FUNC(PathIteratorNext)(&sourceIterator);
+			baseIndex++;
+		}
+
+		while (baseIndex + 1 < segmentCount) {
+			baseIndex++;
+			URI_FUNC(ShortenWriterAppendSegment)(&writer,
+					URI_FUNC(ConstParent), URI_FUNC(ConstParent) + 2);
+			pathNaked = URI_FALSE;
+		}
+
+		for (; sourceSeg != NULL;
+				sourceSeg = URI_FUNC(PathIteratorNext)(&sourceIterator)) {
+			if (pathNaked == URI_TRUE) {
+				UriBool containsColon = URI_FALSE;
+				const URI_CHAR * ch = sourceSeg->first;
+				for (; ch < sourceSeg->afterLast; ch++) {
+					if (*ch == _UT(':')) {
+						containsColon = URI_TRUE;
+						break;
+					}
+				}
+
+				if (containsColon
+						|| (sourceSeg->first == sourceSeg->afterLast)) {
+					URI_FUNC(ShortenWriterAppendSegment)(&writer,
+							URI_FUNC(ConstPwd), URI_FUNC(ConstPwd) + 1);
+				}
+			}
+			URI_FUNC(ShortenWriterAppendSegment)(&writer,
+					sourceSeg->first, sourceSeg->afterLast);
+			pathNaked = URI_FALSE;
+		}
+	}
+
+	if (absSource->query.first != NULL) {
+		URI_FUNC(ShortenWriterAppend)(&writer, _UT("?"), _UT("?") + 1);
+		URI_FUNC(ShortenWriterAppend)(&writer, absSource->query.first,
+				absSource->query.afterLast);
+	}
+	if (absSource->fragment.first != NULL) {
+		URI_FUNC(ShortenWriterAppend)(&writer, _UT("#"), _UT("#") + 1);
+		URI_FUNC(ShortenWriterAppend)(&writer, absSource->fragment.first,
+				absSource->fragment.afterLast);
+	}
+
+	if (writer.tooLong) {
+		dest[0] = _UT('\0');
+		return URI_ERROR_OUTPUT_TOO_LARGE;
+	}
+	dest[writer.written] = _UT('\0');
+	if (charsWritten != NULL) {
+		*charsWritten = writer.written + 1;  /* .. for terminator */
+	}
+	return URI_SUCCESS;
+}
+
+
+
 int URI_FUNC(RemoveBaseUri)(URI_TYPE(Uri) * dest,
 		const URI_TYPE(Uri) * absSource,
 		const URI_TYPE(Uri) * absBase,
@@ -0,0 +1,257 @@
+/*
+ * uriparser - RFC 3986 URI parsing library
+ *
+ * Copyright (C) 2020, Weijia Song <songweijia@gmail.com>
+ * Copyright (C) 2020, Sebastian Pipping <sebastian@pipping.org>
+ * All rights reserved.
+ *
+ * Redistribution and use in source  and binary forms, with or without
+ * modification, are permitted provided  that the following conditions
+ * are met:
+ *
+ *     1. Redistributions  of  source  code   must  retain  the  above
+ *        copyright notice, this list  of conditions and the following
+ *        disclaimer.
+ *
+ *     2. Redistributions  in binary  form  must  reproduce the  above
+ *        copyright notice, this list  of conditions and the following
+ *        disclaimer  in  the  documentation  and/or  other  materials
+ *        provided with the distribution.
+ *
+ *     3. Neither the  name of the  copyright holder nor the  names of
+ *        its contributors may be used  to endorse or promote products
+ *        derived from  this software  without specific  prior written
+ *        permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND  ANY EXPRESS OR IMPLIED WARRANTIES,  INCLUDING, BUT NOT
+ * LIMITED TO,  THE IMPLIED WARRANTIES OF  MERCHANTABILITY AND FITNESS
+ * FOR  A  PARTICULAR  PURPOSE  ARE  DISCLAIMED.  IN  NO  EVENT  SHALL
+ * THE  COPYRIGHT HOLDER  OR CONTRIBUTORS  BE LIABLE  FOR ANY  DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL,  EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO,  PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA,  OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT  LIABILITY,  OR  TORT (INCLUDING  NEGLIGENCE  OR  OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file UriSuffix.c
+ * Holds the host classification and public suffix lookup implementation.
+ * NOTE: This source file includes itself twice.
+ */
+
+/* What encodings are enabled? */
+#include <uriparser/UriDefsConfig.h>
+#if (!defined(URI_PASS_ANSI) && !defined(URI_PASS_UNICODE))
+/* Include SELF twice */
+# ifdef URI_ENABLE_ANSI
+#  define URI_PASS_ANSI 1
+#  include "UriSuffix.c"
+#  undef URI_PASS_ANSI
+# endif
+# ifdef URI_ENABLE_UNICODE
+#  define URI_PASS_UNICODE 1
+#  include "UriSuffix.c"
+#  undef URI_PASS_UNICODE
+# endif
+#else
+# ifdef URI_PASS_ANSI
+#  include <uriparser/UriDefsAnsi.h>
+# else
+#  include <uriparser/UriDefsUnicode.h>
+#  include <wchar.h>
+# endif
+
+
+
+#ifndef URI_DOXYGEN
+# include <uriparser/Uri.h>
+# include "UriCommon.h"
+# include "UriSuffixBase.h"
+#endif
+
+
+
+static const URI_CHAR * URI_FUNC(LabelStart)(const URI_CHAR * first,
+		const URI_CHAR * labelAfterLast, int * separatorLen);
+static int URI_FUNC(DecodeLabel)(const URI_CHAR * first,
+		const URI_CHAR * afterLast, unsigned char * bytes);
+
+
+
+/* Finds the start of the label ending at labelAfterLast; as
+ * normalization decodes "%2E" to ".", such triplets separate labels,
+ * too.  separatorLen is set to the length of the separator in front
+ * of the label or to 0 for the leftmost label. */
+static URI_INLINE const URI_CHAR * URI_FUNC(LabelStart)(const URI_CHAR * first,
+		const URI_CHAR * labelAfterLast, int * separatorLen) {
+	const URI_CHAR * labelFirst = labelAfterLast;
+	*separatorLen = 0;
+	while (labelFirst > first) {
+		if (labelFirst[-1] == _UT('.')) {
+			*separatorLen = 1;
+			break;
+		} else if ((labelFirst - first >= 3)
+				&& (labelFirst[-3] == _UT('%'))
+				&& (labelFirst[-2] == _UT('2'))
+				&& ((labelFirst[-1] == _UT('E'))
+					|| (labelFirst[-1] == _UT('e')))) {
+			*separatorLen = 3;
+			break;
+		}
+		labelFirst--;
+	}
+	return labelFirst;
+}
+
+
+
+/* Writes the bytes of a label as matched against rules: lowercase,
+ * percent-encodings decoded and characters beyond ASCII as UTF-8.
+ * Returns the number of bytes or -1 if the label is too long. */
+static URI_INLINE int URI_FUNC(DecodeLabel)(const URI_CHAR * first,
+		const URI_CHAR * afterLast, unsigned char * bytes) {
+	int count = 0;
+	while (first < afterLast) {
+		unsigned long c;
+		if ((*first == _UT('%')) && (first + 2 < afterLast)) {
+			c = 16 * URI_FUNC(HexdigToInt)(first[1])
+					+ URI_FUNC(HexdigToInt)(first[2]);
+			first += 3;
+		} else {
+			c = (sizeof(URI_CHAR) == 1)
+					? (unsigned char)*first
+					: (unsigned long)*first;
+			first++;
+			if ((sizeof(URI_CHAR) > 1) && (c > 0x7f)) {
+				/* Wide character, as UTF-8 */
+				if (count + 4 > URI_SUFFIX_MAX_LABEL_BYTES) {
+					return -1;
+				}
+				if (c < 0x800) {
+					bytes[count++] = (unsigned char)(0xc0 | (c >> 6));
+				} else {
+					if (c < 0x10000) {
+						bytes[count++] = (unsigned char)(0xe0 | (c >> 12));
+					} else {
+						bytes[count++] = (unsigned char)(0xf0 | ((c >> 18) & 0x07));
+						bytes[count++] = (unsigned char)(0x80 | ((c >> 12) & 0x3f));
+					}
+					bytes[count++] = (unsigned char)(0x80 | ((c >> 6) & 0x3f));
+				}
+				bytes[count++] = (unsigned char)(0x80 | (c & 0x3f));
+				continue;
+			}
+		}
+
+		if (count + 1 > URI_SUFFIX_MAX_LABEL_BYTES) {
+			return -1;
+		}
+		if ((c >= 'A') && (c <= 'Z')) {
+			c += 'a' - 'A';
+		}
+		bytes[count++] = (unsigned char)c;
+	}
+	return count;
+}
+
+
+
+UriHostType URI_FUNC(GetHostType)(const URI_TYPE(Uri) * uri) {
+	if (uri == NULL) {
+		return URI_HOST_NONE;
+	} else if (uri->hostData.ip4 != NULL) {
+		return URI_HOST_IP4;
+	} else if (uri->hostData.ip6 != NULL) {
+		return URI_HOST_IP6;
+	} else if (uri->hostData.ipFuture.first != NULL) {
+		return URI_HOST_IP_FUTURE;
+	} else if (uri->hostText.first != NULL) {
+		return URI_HOST_REGNAME;
+	}
+	return URI_HOST_NONE;
+}
+
+
+
+int URI_FUNC(GetRegistrableDomain)(const URI_TYPE(Uri) * uri,
+		const UriSuffixList * list, URI_TYPE(TextRange) * publicSuffix,
+		URI_TYPE(TextRange) * registrableDomain) {
+	unsigned char bytes[URI_SUFFIX_MAX_LABEL_BYTES];
+	UriSuffixWalk walk;
+	const URI_CHAR * first;
+	const URI_CHAR * afterLast;
+	const URI_CHAR * labelFirst;
+	const URI_CHAR * labelAfterLast;
+	int separatorLen;
+	int i;
+
+	if ((uri == NULL) || (list == NULL) || (registrableDomain == NULL)) {
+		return URI_ERROR_NULL;
+	}
+
+	registrableDomain->first = NULL;
+	registrableDomain->afterLast = NULL;
+	if (publicSuffix != NULL) {
+		publicSuffix->first = NULL;
+		publicSuffix->afterLast = NULL;
+	}
+
+	if (URI_FUNC(GetHostType)(uri) != URI_HOST_REGNAME) {
+		return URI_SUCCESS;
+	}
+	first = uri->hostText.first;
+	afterLast = uri->hostText.afterLast;
+
+	/* Match labels from the right while rules can still match */
+	uriSuffixWalkInit(&walk);
+	labelAfterLast = afterLast;
+	while (!walk.done) {
+		labelFirst = URI_FUNC(LabelStart)(first, labelAfterLast, &separatorLen);
+		if (labelFirst == labelAfterLast) {
+			return URI_SUCCESS;  /* empty label, e.g. trailing dot */
+		}
+		uriSuffixWalkStep(list, &walk, bytes,
+				URI_FUNC(DecodeLabel)(labelFirst, labelAfterLast, bytes));
+		if (separatorLen == 0) {
+			break;
+		}
+		labelAfterLast = labelFirst - separatorLen;
+	}
+
+	/* Public suffix */
+	labelAfterLast = afterLast;
+	labelFirst = afterLast;
+	separatorLen = 0;
+	for (i = 0; i < walk.suffixLabels; i++) {
+		labelFirst = URI_FUNC(LabelStart)(first, labelAfterLast, &separatorLen);
+		if ((labelFirst == labelAfterLast)
+				|| ((separatorLen == 0) && (i + 1 < walk.suffixLabels))) {
+			return URI_SUCCESS;  /* empty label or not enough labels */
+		}
+		labelAfterLast = labelFirst - separatorLen;
+	}
+	if (publicSuffix != NULL) {
+		publicSuffix->first = labelFirst;
+		publicSuffix->afterLast = afterLast;
+	}
+
+	/* Plus one more label */
+	if (separatorLen == 0) {
+		return URI_SUCCESS;  /* host is a public suffix itself */
+	}
+	labelFirst = URI_FUNC(LabelStart)(first, labelAfterLast, &separatorLen);
+	if (labelFirst == labelAfterLast) {
+		return URI_SUCCESS;
+	}
+	registrableDomain->first = labelFirst;
+	registrableDomain->afterLast = afterLast;
+	return URI_SUCCESS;
+}
+
+
+
+#endif
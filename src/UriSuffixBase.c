@@ -0,0 +1,372 @@
+/*
+ * uriparser - RFC 3986 URI parsing library
+ *
+ * Copyright (C) 2020, Weijia Song <songweijia@gmail.com>
+ * Copyright (C) 2020, Sebastian Pipping <sebastian@pipping.org>
+ * All rights reserved.
+ *
+ * Redistribution and use in source  and binary forms, with or without
+ * modification, are permitted provided  that the following conditions
+ * are met:
+ *
+ *     1. Redistributions  of  source  code   must  retain  the  above
+ *        copyright notice, this list  of conditions and the following
+ *        disclaimer.
+ *
+ *     2. Redistributions  in binary  form  must  reproduce the  above
+ *        copyright notice, this list  of conditions and the following
+ *        disclaimer  in  the  documentation  and/or  other  materials
+ *        provided with the distribution.
+ *
+ *     3. Neither the  name of the  copyright holder nor the  names of
+ *        its contributors may be used  to endorse or promote products
+ *        derived from  this software  without specific  prior written
+ *        permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND  ANY EXPRESS OR IMPLIED WARRANTIES,  INCLUDING, BUT NOT
+ * LIMITED TO,  THE IMPLIED WARRANTIES OF  MERCHANTABILITY AND FITNESS
+ * FOR  A  PARTICULAR  PURPOSE  ARE  DISCLAIMED.  IN  NO  EVENT  SHALL
+ * THE  COPYRIGHT HOLDER  OR CONTRIBUTORS  BE LIABLE  FOR ANY  DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL,  EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO,  PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA,  OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT  LIABILITY,  OR  TORT (INCLUDING  NEGLIGENCE  OR  OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file UriSuffixBase.c
+ * Holds code independent of the encoding pass.
+ */
+
+#include <uriparser/UriDefsConfig.h>
+
+#ifndef URI_DOXYGEN
+# include "UriSuffixBase.h"
+# include "UriMemory.h"
+#endif
+
+#include <string.h>
+
+
+
+static unsigned long uriSuffixHash(unsigned int parent,
+		const unsigned char * label, int labelLength);
+static unsigned int uriSuffixFind(const UriSuffixList * list,
+		unsigned int parent, const unsigned char * label, int labelLength);
+static const char * uriSuffixNextRule(const char * first,
+		const char * afterLast, const char ** ruleFirst,
+		const char ** ruleAfterLast);
+static void uriSuffixAddRule(UriSuffixList * list, const char * first,
+		const char * afterLast, unsigned int * labelsUsed);
+
+
+
+/* FNV-1a over the parent node and the label */
+static URI_INLINE unsigned long uriSuffixHash(unsigned int parent,
+		const unsigned char * label, int labelLength) {
+	unsigned long hash = 2166136261UL;
+	int i = 0;
+	for (; i < 4; i++) {
+		hash ^= (parent >> (8 * i)) & 0xff;
+		hash = (hash * 16777619UL) & 0xffffffffUL;
+	}
+	for (i = 0; i < labelLength; i++) {
+		hash ^= label[i];
+		hash = (hash * 16777619UL) & 0xffffffffUL;
+	}
+	return hash;
+}
+
+
+
+/* Returns the child of parent for label or 0 if there is none;
+ * as the root is never a child, 0 is free to mean "none" */
+static URI_INLINE unsigned int uriSuffixFind(const UriSuffixList * list,
+		unsigned int parent, const unsigned char * label, int labelLength) {
+	unsigned long slot = uriSuffixHash(parent, label, labelLength)
+			& list->edgeMask;
+	for (;;) {
+		const UriSuffixEdge * const edge = list->edges + slot;
+		if (edge->labelLength == 0) {
+			return 0;
+		}
+		if ((edge->parent == parent)
+				&& (edge->labelLength == (unsigned int)labelLength)
+				&& (memcmp(list->labels + edge->labelOffset, label,
+					labelLength) == 0)) {
+			return edge->child;
+		}
+		slot = (slot + 1) & list->edgeMask;
+	}
+}
+
+
+
+/* Finds the next rule, i.e. the first whitespace-delimited token
+ * of the next line that is neither empty nor a comment.
+ * Returns where to continue or NULL if there are no more rules. */
+static const char * uriSuffixNextRule(const char * first,
+		const char * afterLast, const char ** ruleFirst,
+		const char ** ruleAfterLast) {
+	while (first < afterLast) {
+		const char * lineAfterLast = first;
+		const char * tokenAfterLast = first;
+		const char * next;
+
+		while ((lineAfterLast < afterLast) && (*lineAfterLast != '\n')) {
+			lineAfterLast++;
+		}
+		next = (lineAfterLast < afterLast) ? lineAfterLast + 1 : afterLast;
+
+		while ((tokenAfterLast < lineAfterLast)
+				&& (*tokenAfterLast != ' ')
+				&& (*tokenAfterLast != '\t')
+				&& (*tokenAfterLast != '\r')) {
+			tokenAfterLast++;
+		}
+
+		if ((tokenAfterLast > first)
+				&& !((tokenAfterLast - first >= 2)
+					&& (first[0] == '/') && (first[1] == '/'))) {
+			*ruleFirst = first;
+			*ruleAfterLast = tokenAfterLast;
+			return next;
+		}
+		first = next;
+	}
+	return NULL;
+}
+
+
+
+/* Adds the labels of a rule to the trie, right to left */
+static URI_INLINE void uriSuffixAddRule(UriSuffixList * list,
+		const char * first, const char * afterLast,
+		unsigned int * labelsUsed) {
+	const UriBool exception = (*first == '!') ? URI_TRUE : URI_FALSE;
+	const char * labelAfterLast = afterLast;
+	unsigned int node = 0;
+
+	if (exception) {
+		first++;
+	}
+
+	for (;;) {
+		const char * labelFirst = labelAfterLast;
+		unsigned char * const label = list->labels + *labelsUsed;
+		int labelLength;
+		unsigned int child;
+		int i;
+
+		while ((labelFirst > first) && (labelFirst[-1] != '.')) {
+			labelFirst--;
+		}
+
+		/* Lowercase into the label pool, reclaimed if the label is known */
+		labelLength = (int)(labelAfterLast - labelFirst);
+		for (i = 0; i < labelLength; i++) {
+			const unsigned char c = (unsigned char)labelFirst[i];
+			label[i] = ((c >= 'A') && (c <= 'Z'))
+					? (unsigned char)(c + ('a' - 'A'))
+					: c;
+		}
+
+		child = uriSuffixFind(list, node, label, labelLength);
+		if (child == 0) {
+			unsigned long slot = uriSuffixHash(node, label, labelLength)
+					& list->edgeMask;
+			while (list->edges[slot].labelLength != 0) {
+				slot = (slot + 1) & list->edgeMask;
+			}
+			child = list->nodeCount++;
+			list->flags[child] = 0;
+			list->edges[slot].parent = node;
+			list->edges[slot].labelOffset = *labelsUsed;
+			list->edges[slot].labelLength = (unsigned int)labelLength;
+			list->edges[slot].child = child;
+			*labelsUsed += (unsigned int)labelLength;
+		}
+		node = child;
+
+		if (labelFirst == first) {
+			break;
+		}
+		labelAfterLast = labelFirst - 1;
+	}
+
+	list->flags[node] |= exception ? URI_SUFFIX_EXCEPTION : URI_SUFFIX_RULE;
+}
+
+
+
+int uriLoadSuffixList(UriSuffixList ** list, const char * first,
+		const char * afterLast) {
+	return uriLoadSuffixListMm(list, first, afterLast, NULL);
+}
+
+
+
+int uriLoadSuffixListMm(UriSuffixList ** list, const char * first,
+		const char * afterLast, UriMemoryManager * memory) {
+	const char * ruleFirst;
+	const char * ruleAfterLast;
+	const char * walker;
+	unsigned long labelCount = 0;
+	unsigned long labelBytes = 0;
+	unsigned long edgeCount = 2;
+	size_t blockSize;
+	unsigned char * block;
+	UriSuffixList * result;
+	unsigned int labelsUsed = 0;
+
+	if ((list == NULL) || (first == NULL) || (afterLast == NULL)) {
+		return URI_ERROR_NULL;
+	}
+	if (afterLast < first) {
+		return URI_ERROR_RANGE_INVALID;
+	}
+
+	URI_CHECK_MEMORY_MANAGER(memory);  /* may return */
+
+	/* Skip UTF-8 byte order mark */
+	if ((afterLast - first >= 3)
+			&& ((unsigned char)first[0] == 0xef)
+			&& ((unsigned char)first[1] == 0xbb)
+			&& ((unsigned char)first[2] == 0xbf)) {
+		first += 3;
+	}
+
+	/* Measure and validate */
+	walker = first;
+	while ((walker = uriSuffixNextRule(walker, afterLast,
+			&ruleFirst, &ruleAfterLast)) != NULL) {
+		const char * c = ruleFirst;
+		if (*c == '!') {
+			c++;
+		}
+		if ((c == ruleAfterLast) || (*c == '.')
+				|| (ruleAfterLast[-1] == '.')) {
+			return URI_ERROR_SYNTAX;
+		}
+		labelCount++;
+		for (; c < ruleAfterLast; c++) {
+			if (*c == '.') {
+				if (c[-1] == '.') {
+					return URI_ERROR_SYNTAX;  /* empty label */
+				}
+				labelCount++;
+			} else {
+				labelBytes++;
+			}
+		}
+		if (labelCount + labelBytes > ((unsigned int)-1) / 4) {
+			return URI_ERROR_OUTPUT_TOO_LARGE;
+		}
+	}
+
+	/* One edge per label at most, table at most half full */
+	while (edgeCount < 2 * labelCount) {
+		edgeCount *= 2;
+	}
+
+	blockSize = sizeof(UriSuffixList)
+			+ edgeCount * sizeof(UriSuffixEdge)
+			+ (labelCount + 1)  /* flags, including root */
+			+ labelBytes + 1;
+	block = memory->malloc(memory, blockSize);
+	if (block == NULL) {
+		return URI_ERROR_MALLOC;
+	}
+
+	result = (UriSuffixList *)block;
+	result->edges = (UriSuffixEdge *)(block + sizeof(UriSuffixList));
+	result->edgeMask = (unsigned int)(edgeCount - 1);
+	result->flags = (unsigned char *)(result->edges + edgeCount);
+	result->nodeCount = 1;
+	result->labels = result->flags + labelCount + 1;
+	memset(result->edges, 0, edgeCount * sizeof(UriSuffixEdge));
+	result->flags[0] = 0;
+
+	/* Build */
+	walker = first;
+	while ((walker = uriSuffixNextRule(walker, afterLast,
+			&ruleFirst, &ruleAfterLast)) != NULL) {
+		uriSuffixAddRule(result, ruleFirst, ruleAfterLast, &labelsUsed);
+	}
+
+	*list = result;
+	return URI_SUCCESS;
+}
+
+
+
+void uriFreeSuffixList(UriSuffixList * list) {
+	uriFreeSuffixListMm(list, NULL);
+}
+
+
+
+int uriFreeSuffixListMm(UriSuffixList * list, UriMemoryManager * memory) {
+	URI_CHECK_MEMORY_MANAGER(memory);  /* may return */
+	memory->free(memory, list);
+	return URI_SUCCESS;
+}
+
+
+
+void uriSuffixWalkInit(UriSuffixWalk * walk) {
+	walk->node = 0;
+	walk->depth = 0;
+	walk->suffixLabels = 1;  /* implicit rule "*" */
+	walk->done = URI_FALSE;
+}
+
+
+
+/* Feeds the next label from the right; a label of negative length
+ * is one that cannot match any rule but wildcards */
+void uriSuffixWalkStep(const UriSuffixList * list, UriSuffixWalk * walk,
+		const unsigned char * label, int labelLength) {
+	unsigned int wildcard;
+	unsigned int exact;
+
+	if (walk->done) {
+		return;
+	}
+
+	wildcard = uriSuffixFind(list, walk->node,
+			(const unsigned char *)"*", 1);
+	if ((wildcard != 0) && (list->flags[wildcard] & URI_SUFFIX_RULE)
+			&& (walk->depth + 1 > walk->suffixLabels)) {
+		walk->suffixLabels = walk->depth + 1;
+	}
+
+	exact = (labelLength >= 0)
+			? uriSuffixFind(list, walk->node, label, labelLength)
+			: 0;
+	if (exact == 0) {
+		walk->done = URI_TRUE;
+		return;
+	}
+
+	if (list->flags[exact] & URI_SUFFIX_EXCEPTION) {
+		/* An exception prevails over all other rules; the public
+		 * suffix is the exception rule without its leftmost label */
+		if (walk->depth > 0) {
+			walk->suffixLabels = walk->depth;
+		}
+		walk->done = URI_TRUE;
+		return;
+	}
+
+	if ((list->flags[exact] & URI_SUFFIX_RULE)
+			&& (walk->depth + 1 > walk->suffixLabels)) {
+		walk->suffixLabels = walk->depth + 1;
+	}
+	walk->node = exact;
+	walk->depth++;
+}
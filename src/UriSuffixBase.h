@@ -1,8 +1,8 @@
 /*
  * uriparser - RFC 3986 URI parsing library
  *
- * Copyright (C) 2007, Weijia Song <songweijia@gmail.com>
- * Copyright (C) 2007, Sebastian Pipping <sebastian@pipping.org>
+ * Copyright (C) 2020, Weijia Song <songweijia@gmail.com>
+ * Copyright (C) 2020, Sebastian Pipping <sebastian@pipping.org>
  * All rights reserved.
  *
  * Redistribution and use in source  and binary forms, with or without
@@ -37,23 +37,63 @@
  * OF THE POSSIBILITY OF SUCH DAMAGE.
  */
 
-#ifndef URI_IP4_BASE_H
-#define URI_IP4_BASE_H 1
+#ifndef URI_SUFFIX_BASE_H
+#define URI_SUFFIX_BASE_H 1
 
 
 
-typedef struct UriIp4ParserStruct {
-	unsigned char stackCount;
-	unsigned char stackOne;
-	unsigned char stackTwo;
-	unsigned char stackThree;
-} UriIp4Parser;
+#ifndef URI_DOXYGEN
+# include <uriparser/UriBase.h>
+#endif
 
 
 
-void uriPushToStack(UriIp4Parser * parser, unsigned char digit);
-void uriStackToOctet(UriIp4Parser * parser, unsigned char * octet);
+/* Node flags */
+#define URI_SUFFIX_RULE       1  /* a rule ends at this node */
+#define URI_SUFFIX_EXCEPTION  2  /* an exception rule ("!") ends here */
 
+/* Labels longer than that cannot be part of a rule */
+#define URI_SUFFIX_MAX_LABEL_BYTES  255
 
 
-#endif /* URI_IP4_BASE_H */
+
+/* Trie edge from a parent node to a child node for one label,
+ * kept in an open addressing hash table; node 0 is the root */
+typedef struct UriSuffixEdgeStruct {
+	unsigned int parent;
+	unsigned int labelOffset;
+	unsigned int labelLength;  /* 0 for free slots */
+	unsigned int child;
+} UriSuffixEdge;
+
+
+
+/* Lives in a single allocation together with its arrays */
+struct UriSuffixListStruct {
+	UriSuffixEdge * edges;
+	unsigned int edgeMask;  /* edge slot count minus one */
+	unsigned char * flags;  /* one per node */
+	unsigned int nodeCount;
+	unsigned char * labels;
+};
+
+
+
+/* State of matching the labels of a host against the rules,
+ * from the rightmost label to the left */
+typedef struct UriSuffixWalkStruct {
+	unsigned int node;
+	int depth;  /* labels consumed */
+	int suffixLabels;  /* labels of the prevailing rule so far */
+	UriBool done;
+} UriSuffixWalk;
+
+
+
+void uriSuffixWalkInit(UriSuffixWalk * walk);
+void uriSuffixWalkStep(const UriSuffixList * list, UriSuffixWalk * walk,
+		const unsigned char * label, int labelLength);
+
+
+
+#endif /* URI_SUFFIX_BASE_H */
@@ -0,0 +1,314 @@
+/*
+ * uriparser - RFC 3986 URI parsing library
+ *
+ * Copyright (C) 2020, Weijia Song <songweijia@gmail.com>
+ * Copyright (C) 2020, Sebastian Pipping <sebastian@pipping.org>
+ * All rights reserved.
+ *
+ * Redistribution and use in source  and binary forms, with or without
+ * modification, are permitted provided  that the following conditions
+ * are met:
+ *
+ *     1. Redistributions  of  source  code   must  retain  the  above
+ *        copyright notice, this list  of conditions and the following
+ *        disclaimer.
+ *
+ *     2. Redistributions  in binary  form  must  reproduce the  above
+ *        copyright notice, this list  of conditions and the following
+ *        disclaimer  in  the  documentation  and/or  other  materials
+ *        provided with the distribution.
+ *
+ *     3. Neither the  name of the  copyright holder nor the  names of
+ *        its contributors may be used  to endorse or promote products
+ *        derived from  this software  without specific  prior written
+ *        permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND  ANY EXPRESS OR IMPLIED WARRANTIES,  INCLUDING, BUT NOT
+ * LIMITED TO,  THE IMPLIED WARRANTIES OF  MERCHANTABILITY AND FITNESS
+ * FOR  A  PARTICULAR  PURPOSE  ARE  DISCLAIMED.  IN  NO  EVENT  SHALL
+ * THE  COPYRIGHT HOLDER  OR CONTRIBUTORS  BE LIABLE  FOR ANY  DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL,  EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO,  PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA,  OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT  LIABILITY,  OR  TORT (INCLUDING  NEGLIGENCE  OR  OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file UriUtf16.c
+ * Holds the conversion of UTF-16 text to %URI strings.
+ * NOTE: This source file includes itself twice.
+ */
+
+/* What encodings are enabled? */
+#include <uriparser/UriDefsConfig.h>
+#if (!defined(URI_PASS_ANSI) && !defined(URI_PASS_UNICODE))
+/* Include SELF twice */
+# ifdef URI_ENABLE_ANSI
+#  define URI_PASS_ANSI 1
+#  include "UriUtf16.c"
+#  undef URI_PASS_ANSI
+# endif
+# ifdef URI_ENABLE_UNICODE
+#  define URI_PASS_UNICODE 1
+#  include "UriUtf16.c"
+#  undef URI_PASS_UNICODE
+# endif
+#else
+# ifdef URI_PASS_ANSI
+#  include <uriparser/UriDefsAnsi.h>
+# else
+#  include <uriparser/UriDefsUnicode.h>
+#  include <wchar.h>
+# endif
+
+
+
+#ifndef URI_DOXYGEN
+# include <uriparser/Uri.h>
+# include "UriCommon.h"
+# include "UriMemory.h"
+#endif
+
+#include <limits.h>
+
+
+
+/* Text shorter than this is converted on the stack for parsing */
+#ifndef URI_UTF16_STACK_CHARS
+# define URI_UTF16_STACK_CHARS  256
+#endif
+
+
+
+static int URI_FUNC(Utf16CharsFor)(const UriUtf16Char * walker,
+		const UriUtf16Char * afterLast, int * unitCount);
+static void URI_FUNC(AppendEscapedByte)(URI_CHAR * dest, unsigned int byte);
+static int URI_FUNC(Utf16ToUriStringEngine)(URI_CHAR * dest,
+		const UriUtf16Char * first, const UriUtf16Char * afterLast,
+		int maxChars, int * charsWritten, const UriUtf16Char ** errorPos);
+
+
+
+/*
+ * Returns how many characters the code point at walker takes
+ * in the %URI string, 0 for unpaired surrogates.
+ * The number of code units consumed goes to unitCount.
+ */
+static URI_INLINE int URI_FUNC(Utf16CharsFor)(const UriUtf16Char * walker,
+		const UriUtf16Char * afterLast, int * unitCount) {
+	const unsigned int unit = *walker;
+
+	*unitCount = 1;
+	if (unit < 0x80) {
+		return 1;
+	} else if (unit < 0x800) {
+		return 2 * 3;
+	} else if ((unit < 0xd800) || (unit > 0xdfff)) {
+		return 3 * 3;
+	} else if ((unit <= 0xdbff) && (walker + 1 < afterLast)
+			&& (walker[1] >= 0xdc00) && (walker[1] <= 0xdfff)) {
+		*unitCount = 2;
+		return 4 * 3;
+	}
+	return 0;
+}
+
+
+
+static URI_INLINE void URI_FUNC(AppendEscapedByte)(URI_CHAR * dest,
+		unsigned int byte) {
+	dest[0] = _UT('%');
+	dest[1] = URI_FUNC(HexToLetterEx)(byte >> 4, URI_TRUE);
+	dest[2] = URI_FUNC(HexToLetterEx)(byte & 0x0f, URI_TRUE);
+}
+
+
+
+/*
+ * Converts, or with dest NULL only measures, excluding the terminator.
+ * ASCII is copied as is, everything else is escaped as UTF-8.
+ */
+static int URI_FUNC(Utf16ToUriStringEngine)(URI_CHAR * dest,
+		const UriUtf16Char * first, const UriUtf16Char * afterLast,
+		int maxChars, int * charsWritten, const UriUtf16Char ** errorPos) {
+	const UriUtf16Char * walker = first;
+	int written = 0;
+
+	while (walker < afterLast) {
+		int unitCount;
+		const int chars = URI_FUNC(Utf16CharsFor)(walker, afterLast,
+				&unitCount);
+		if (chars == 0) {
+			if (errorPos != NULL) {
+				*errorPos = walker;
+			}
+			return URI_ERROR_SYNTAX;
+		}
+
+		if (written > maxChars - chars) {
+			return URI_ERROR_OUTPUT_TOO_LARGE;
+		}
+
+		if (dest != NULL) {
+			URI_CHAR * const out = dest + written;
+			unsigned int codePoint = *walker;
+			if (unitCount == 2) {
+				codePoint = 0x10000 + ((codePoint - 0xd800) << 10)
+						+ (walker[1] - 0xdc00);
+			}
+
+			switch (chars) {
+			case 1:
+				out[0] = (URI_CHAR)codePoint;
+				break;
+			case 2 * 3:
+				URI_FUNC(AppendEscapedByte)(out, 0xc0 | (codePoint >> 6));
+				URI_FUNC(AppendEscapedByte)(out + 3, 0x80 | (codePoint & 0x3f));
+				break;
+			case 3 * 3:
+				URI_FUNC(AppendEscapedByte)(out, 0xe0 | (codePoint >> 12));
+				URI_FUNC(AppendEscapedByte)(out + 3,
+						0x80 | ((codePoint >> 6) & 0x3f));
+				URI_FUNC(AppendEscapedByte)(out + 6, 0x80 | (codePoint & 0x3f));
+				break;
+			default:
+				URI_FUNC(AppendEscapedByte)(out, 0xf0 | (codePoint >> 18));
+				URI_FUNC(AppendEscapedByte)(out + 3,
+						0x80 | ((codePoint >> 12) & 0x3f));
+				URI_FUNC(AppendEscapedByte)(out + 6,
+						0x80 | ((codePoint >> 6) & 0x3f));
+				URI_FUNC(AppendEscapedByte)(out + 9, 0x80 | (codePoint & 0x3f));
+				break;
+			}
+		}
+
+		written += chars;
+		walker += unitCount;
+	}
+
+	*charsWritten = written;
+	return URI_SUCCESS;
+}
+
+
+
+int URI_FUNC(Utf16ToUriStringCharsRequired)(const UriUtf16Char * first,
+		const UriUtf16Char * afterLast, int * charsRequired) {
+	if ((first == NULL) || (afterLast == NULL) || (charsRequired == NULL)) {
+		return URI_ERROR_NULL;
+	}
+
+	return URI_FUNC(Utf16ToUriStringEngine)(NULL, first, afterLast,
+			INT_MAX - 1, charsRequired, NULL);
+}
+
+
+
+int URI_FUNC(Utf16ToUriString)(URI_CHAR * dest, const UriUtf16Char * first,
+		const UriUtf16Char * afterLast, int maxChars, int * charsWritten) {
+	int written = 0;
+	int res;
+
+	if ((dest == NULL) || (first == NULL) || (afterLast == NULL)) {
+		return URI_ERROR_NULL;
+	}
+
+	if (maxChars < 1) {
+		return URI_ERROR_OUTPUT_TOO_LARGE;
+	}
+
+	/* Reserve room for the terminator */
+	res = URI_FUNC(Utf16ToUriStringEngine)(dest, first, afterLast,
+			maxChars - 1, &written, NULL);
+	if (res != URI_SUCCESS) {
+		dest[0] = _UT('\0');
+		if (charsWritten != NULL) {
+			*charsWritten = 0;
+		}
+		return res;
+	}
+
+	dest[written] = _UT('\0');
+	if (charsWritten != NULL) {
+		*charsWritten = written + 1;
+	}
+	return URI_SUCCESS;
+}
+
+
+
+int URI_FUNC(ParseSingleUriUtf16Mm)(URI_TYPE(Uri) * uri,
+		const UriUtf16Char * first, const UriUtf16Char * afterLast,
+		const UriUtf16Char ** errorPos, UriMemoryManager * memory) {
+	URI_CHAR stackText[URI_UTF16_STACK_CHARS];
+	URI_CHAR * text = stackText;
+	const URI_CHAR * textErrorPos = NULL;
+	int len;
+	int res;
+
+	if ((uri == NULL) || (first == NULL)) {
+		return URI_ERROR_NULL;
+	}
+
+	URI_CHECK_MEMORY_MANAGER(memory);  /* may return */
+
+	if (afterLast == NULL) {
+		afterLast = first;
+		while (*afterLast != 0) {
+			afterLast++;
+		}
+	}
+
+	res = URI_FUNC(Utf16ToUriStringEngine)(NULL, first, afterLast,
+			INT_MAX - 1, &len, errorPos);
+	if (res != URI_SUCCESS) {
+		return res;
+	}
+
+	if (len >= URI_UTF16_STACK_CHARS) {
+		text = memory->malloc(memory, ((size_t)len + 1) * sizeof(URI_CHAR));
+		if (text == NULL) {
+			return URI_ERROR_MALLOC;
+		}
+	}
+	URI_FUNC(Utf16ToUriStringEngine)(text, first, afterLast, len, &len, NULL);
+
+	res = URI_FUNC(ParseSingleUriExMm)(uri, text, text + len, &textErrorPos,
+			memory);
+	if (res == URI_SUCCESS) {
+		/* The URI must not point into the converted text */
+		res = URI_FUNC(MakeOwnerCompactMm)(uri, memory);
+		if (res != URI_SUCCESS) {
+			URI_FUNC(FreeUriMembersMm)(uri, memory);
+		}
+	} else if ((res == URI_ERROR_SYNTAX) && (errorPos != NULL)) {
+		/* Map the error position back to UTF-16 */
+		const UriUtf16Char * walker = first;
+		const int target = (int)(textErrorPos - text);
+		int offset = 0;
+		while (walker < afterLast) {
+			int unitCount;
+			const int chars = URI_FUNC(Utf16CharsFor)(walker, afterLast,
+					&unitCount);
+			if (offset + chars > target) {
+				break;
+			}
+			offset += chars;
+			walker += unitCount;
+		}
+		*errorPos = walker;
+	}
+
+	if (text != stackText) {
+		memory->free(memory, text);
+	}
+	return res;
+}
+
+
+
+#endif
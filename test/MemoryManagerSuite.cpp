@@ -202,6 +202,60 @@ TEST(MemoryManagerTestingSuite, CompleteMemoryManager) {
 
 
 
+TEST(MemoryManagerTestingSuite, FreelistMemoryManager) {
+	UriMemoryManager * memory = NULL;
+
+	ASSERT_EQ(uriCreateFreelistMemoryManager(&memory, NULL), URI_SUCCESS);
+	ASSERT_EQ(uriTestMemoryManager(memory), URI_SUCCESS);
+	uriFreeFreelistMemoryManager(memory);
+}
+
+
+
+TEST(MemoryManagerTestingSuite, FreelistMemoryManagerReuseAndRelease) {
+	UriMemoryManager * memory = NULL;
+	UriMemoryManager backend;
+	CallCountLog callCountLog;
+
+	memcpy(&backend, &defaultMemoryManager, sizeof(UriMemoryManager));
+	backend.free = countingFree;
+	backend.userData = &callCountLog;
+
+	ASSERT_EQ(uriCreateFreelistMemoryManager(&memory, &backend),
+			URI_SUCCESS);
+
+	// Same size class, same block
+	void * const small = memory->malloc(memory, 24);
+	ASSERT_TRUE(small != NULL);
+	memory->free(memory, small);
+	ASSERT_EQ(memory->malloc(memory, 20), small);
+	memory->free(memory, small);
+
+	// Large blocks are not cached
+	void * const large = memory->malloc(memory, 1000);
+	ASSERT_TRUE(large != NULL);
+	memory->free(memory, large);
+	ASSERT_EQ(callCountLog.callCountFree, 1U);
+
+	// Parsing and freeing a URI does not reach the backend
+	UriUriA uri;
+	const char * const text = "http://[::1]/a/b/c";
+	ASSERT_EQ(uriParseSingleUriExMmA(&uri, text, text + strlen(text), NULL,
+			memory),
+			URI_SUCCESS);
+	ASSERT_EQ(uriFreeUriMembersMmA(&uri, memory), URI_SUCCESS);
+	ASSERT_EQ(callCountLog.callCountFree, 1U);
+
+	uriReleaseFreelistMemoryManager(memory);
+	const unsigned int callCountFreeReleased = callCountLog.callCountFree;
+	ASSERT_GT(callCountFreeReleased, 1U);
+
+	uriFreeFreelistMemoryManager(memory);
+	ASSERT_EQ(callCountLog.callCountFree, callCountFreeReleased + 1);
+}
+
+
+
 TEST(MemoryManagerTestingSuite, EmulateCalloc) {
 	UriMemoryManager partialEmulationMemoryManager;
 	memcpy(&partialEmulationMemoryManager, &defaultMemoryManager,
@@ -362,6 +416,62 @@ TEST(FailingMemoryManagerSuite, ParseSingleUriExMm) {
 
 
 
+TEST(FailingMemoryManagerSuite, ParseSingleUriExMmHostsWithoutMalloc) {
+	UriUriA uri;
+	FailingMemoryManager failingMemoryManager;
+
+	// Neither a reg-name nor an invalid IPv6 address needs memory
+	const char * const regName = "//example.org";
+	ASSERT_EQ(uriParseSingleUriExMmA(&uri, regName,
+			regName + strlen(regName), NULL, &failingMemoryManager),
+			URI_SUCCESS);
+	ASSERT_EQ(uriFreeUriMembersMmA(&uri, &failingMemoryManager),
+			URI_SUCCESS);
+
+	const char * const badIpSix = "//[1::2::3]";
+	ASSERT_EQ(uriParseSingleUriExMmA(&uri, badIpSix,
+			badIpSix + strlen(badIpSix), NULL, &failingMemoryManager),
+			URI_ERROR_SYNTAX);
+
+	// Actual IP addresses do
+	const char * const ipFour = "//127.0.0.1";
+	ASSERT_EQ(uriParseSingleUriExMmA(&uri, ipFour,
+			ipFour + strlen(ipFour), NULL, &failingMemoryManager),
+			URI_ERROR_MALLOC);
+
+	const char * const ipSix = "//[::1]";
+	ASSERT_EQ(uriParseSingleUriExMmA(&uri, ipSix,
+			ipSix + strlen(ipSix), NULL, &failingMemoryManager),
+			URI_ERROR_MALLOC);
+}
+
+
+
+TEST(FailingMemoryManagerSuite, LoadSuffixListMm) {
+	UriSuffixList * list = NULL;
+	FailingMemoryManager failingMemoryManager;
+	const char * const text = "com\nco.uk\n";
+
+	ASSERT_EQ(uriLoadSuffixListMm(&list, text, text + strlen(text),
+			&failingMemoryManager), URI_ERROR_MALLOC);
+	ASSERT_TRUE(list == NULL);
+	ASSERT_EQ(failingMemoryManager.getCallCountFree(), 0U);
+}
+
+
+
+TEST(FailingMemoryManagerSuite, CreateParserContext) {
+	UriParserContext * context = NULL;
+	FailingMemoryManager failingMemoryManager;
+
+	ASSERT_EQ(uriCreateParserContext(&context, &failingMemoryManager),
+			URI_ERROR_MALLOC);
+	ASSERT_TRUE(context == NULL);
+	ASSERT_EQ(failingMemoryManager.getCallCountFree(), 0U);
+}
+
+
+
 TEST(FailingMemoryManagerSuite, RemoveBaseUriMm) {
 	UriUriA dest;
 	UriUriA absoluteSource = parse("http://example.org/a/b/c/");
@@ -376,3 +486,39 @@ TEST(FailingMemoryManagerSuite, RemoveBaseUriMm) {
 	uriFreeUriMembersA(&absoluteSource);
 	uriFreeUriMembersA(&absoluteBase);
 }
+
+
+
+TEST(FailingMemoryManagerSuite, MaterializePathMm) {
+	const char * const text = "http://example.org/a/b";
+	UriUriA uri;
+	char buffer[32];
+	FailingMemoryManager failingMemoryManager;
+
+	ASSERT_EQ(uriParseSingleUriLazyExMmA(&uri, text, text + strlen(text),
+			NULL, NULL), URI_SUCCESS);
+	ASSERT_EQ(uriMaterializePathMmA(&uri, &failingMemoryManager),
+			URI_ERROR_MALLOC);
+	ASSERT_EQ(failingMemoryManager.getCallCountFree(), 0U);
+
+	// Still intact and lazy
+	ASSERT_TRUE(uri.pathHead == uri.pathTail);
+	ASSERT_EQ(uriToStringA(buffer, &uri, sizeof(buffer), NULL), URI_SUCCESS);
+	ASSERT_STREQ(buffer, text);
+
+	uriFreeUriMembersA(&uri);
+}
+
+
+
+TEST(FailingMemoryManagerSuite, CreatePrecompiledBase) {
+	UriPrecompiledBaseA * base = NULL;
+	UriUriA absoluteBase = parse("http://example.org/a/");
+	FailingMemoryManager failingMemoryManager;
+
+	ASSERT_EQ(uriCreatePrecompiledBaseA(&base, &absoluteBase,
+			&failingMemoryManager), URI_ERROR_MALLOC);
+	ASSERT_TRUE(base == NULL);
+
+	uriFreeUriMembersA(&absoluteBase);
+}
@@ -36,8 +36,16 @@
  * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
  * OF THE POSSIBILITY OF SUCH DAMAGE.
  */
+#if !defined(_WIN32) && !defined(_POSIX_C_SOURCE)
+/* For clock_gettime and CLOCK_MONOTONIC, hidden with strict -std=c89;
+ * POSIX.1-2001 keeps inet_ntop visible as well */
+# define _POSIX_C_SOURCE 200112L
+#endif
+
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <time.h>
 #include <uriparser/Uri.h>
 
 #ifdef _WIN32
@@ -56,9 +64,955 @@ WINSOCK_API_LINKAGE const char WSAAPI inet_ntop(
 
 #define RANGE(x)  (int)((x).afterLast-(x).first), ((x).first)
 
+#if defined(_WIN32) || defined(CLOCK_MONOTONIC)
+# define HAVE_PRECISE_CLOCK  1
+#endif
+
+#define OUTPUT_BUFFER_SIZE  (1 << 16)
+#define BENCH_ROUNDS_DEFAULT  10
+#define BENCH_SAMPLES_MAX  (1 << 20)
+
+#define READ_LINE_END  (-1)
+#define READ_LINE_NO_MEMORY  (-2)
+
+
+typedef enum CommandEnum {
+	COMMAND_PARSE,
+	COMMAND_NORMALIZE,
+	COMMAND_RESOLVE,
+	COMMAND_RELATIVIZE,
+	COMMAND_QUERY,
+	COMMAND_VALIDATE,
+	COMMAND_COUNT
+} Command;
+
+static const char * const commandNames[COMMAND_COUNT] = {
+	"parse", "normalize", "resolve", "relativize", "query", "validate"
+};
+
+typedef enum FieldEnum {
+	FIELD_SCHEME,
+	FIELD_USERINFO,
+	FIELD_HOST,
+	FIELD_PORT,
+	FIELD_PATH,
+	FIELD_QUERY,
+	FIELD_FRAGMENT,
+	FIELD_COUNT
+} Field;
+
+static const char * const fieldNames[FIELD_COUNT] = {
+	"scheme", "userinfo", "host", "port", "path", "query", "fragment"
+};
+
+typedef enum FormatEnum {
+	FORMAT_TSV,
+	FORMAT_JSON
+} Format;
+
+typedef struct BatchOptionsStruct {
+	Command command;
+	Format format;
+	Field fields[FIELD_COUNT];
+	int fieldCount;
+	const char * baseText;
+	int stats;
+	unsigned long benchRounds;  /* 0 for no benchmark */
+} BatchOptions;
+
+typedef struct AllocationStatsStruct {
+	unsigned long allocations;
+	unsigned long frees;
+} AllocationStats;
+
+typedef struct BatchStateStruct {
+	const BatchOptions * options;
+	UriMemoryManager countingMemory;  /* libc, counting calls */
+	AllocationStats allocationStats;  /* behind the context's cache */
+	UriParserContext * context;
+	UriMemoryManager * contextMemory;
+	UriMemoryManager memory;  /* of context, counting calls */
+	AllocationStats libraryStats;  /* calls made by the library */
+	UriUriA base;
+	char * text;  /* recomposed URIs */
+	size_t textCapacity;
+} BatchState;
+
+typedef struct CorpusStruct {
+	char * text;  /* all lines, each terminated */
+	size_t textSize;
+	size_t textCapacity;
+	size_t * lineStarts;  /* plus one for the end */
+	size_t lineCount;
+	size_t lineCapacity;
+} Corpus;
+
 
 void usage() {
 	printf("Usage: uriparse URI [..]\n");
+	printf("       uriparse COMMAND [OPTIONS] [FILE]\n");
+	printf("\n");
+	printf("Commands process one URI per line of FILE (or stdin)\n");
+	printf("and write one line of output per URI:\n");
+	printf("  parse       Split into components (also: --batch)\n");
+	printf("  normalize   Normalize syntax\n");
+	printf("  resolve     Resolve against --base=URI\n");
+	printf("  relativize  Make relative to --base=URI\n");
+	printf("  query       Dissect the query into key/value pairs\n");
+	printf("  validate    Check syntax only\n");
+	printf("\n");
+	printf("Options:\n");
+	printf("  --format=tsv|json  Output format (default: tsv)\n");
+	printf("  --fields=LIST      Components for parse, out of\n");
+	printf("                     scheme,userinfo,host,port,path,query,fragment\n");
+	printf("  --base=URI         Absolute base URI for resolve and relativize\n");
+	printf("  --stats            Report throughput and allocations to stderr\n");
+	printf("  --bench[=ROUNDS]   Run the command over all of FILE ROUNDS times\n");
+	printf("                     (default: %d) and report performance only\n",
+			BENCH_ROUNDS_DEFAULT);
+}
+
+
+static void * countingMalloc(UriMemoryManager * memory, size_t size) {
+	((AllocationStats *)memory->userData)->allocations++;
+	return malloc(size);
+}
+
+
+static void * countingCalloc(UriMemoryManager * memory, size_t nmemb,
+		size_t size) {
+	((AllocationStats *)memory->userData)->allocations++;
+	return calloc(nmemb, size);
+}
+
+
+static void * countingRealloc(UriMemoryManager * memory, void * ptr,
+		size_t size) {
+	((AllocationStats *)memory->userData)->allocations++;
+	return realloc(ptr, size);
+}
+
+
+static void countingFree(UriMemoryManager * memory, void * ptr) {
+	if (ptr != NULL) {
+		((AllocationStats *)memory->userData)->frees++;
+	}
+	free(ptr);
+}
+
+
+/*
+ * Front of the parser context's memory manager, counting
+ * what the library asks for before the context's cache
+ */
+static void * frontMalloc(UriMemoryManager * memory, size_t size) {
+	BatchState * const state = (BatchState *)memory->userData;
+	state->libraryStats.allocations++;
+	return state->contextMemory->malloc(state->contextMemory, size);
+}
+
+
+static void * frontCalloc(UriMemoryManager * memory, size_t nmemb,
+		size_t size) {
+	BatchState * const state = (BatchState *)memory->userData;
+	state->libraryStats.allocations++;
+	return state->contextMemory->calloc(state->contextMemory, nmemb, size);
+}
+
+
+static void * frontRealloc(UriMemoryManager * memory, void * ptr,
+		size_t size) {
+	BatchState * const state = (BatchState *)memory->userData;
+	state->libraryStats.allocations++;
+	return state->contextMemory->realloc(state->contextMemory, ptr, size);
+}
+
+
+static void * frontReallocarray(UriMemoryManager * memory, void * ptr,
+		size_t nmemb, size_t size) {
+	BatchState * const state = (BatchState *)memory->userData;
+	state->libraryStats.allocations++;
+	return state->contextMemory->reallocarray(state->contextMemory, ptr,
+			nmemb, size);
+}
+
+
+static void frontFree(UriMemoryManager * memory, void * ptr) {
+	BatchState * const state = (BatchState *)memory->userData;
+	if (ptr != NULL) {
+		state->libraryStats.frees++;
+	}
+	state->contextMemory->free(state->contextMemory, ptr);
+}
+
+
+/*
+ * Reads a line of any length, without the line break.
+ * Returns the line length, READ_LINE_END at end of input
+ * or READ_LINE_NO_MEMORY if the buffer cannot grow.
+ */
+static long readLine(FILE * input, char ** buffer, size_t * capacity) {
+	size_t len = 0;
+
+	for (;;) {
+		size_t chunkLen;
+		if (*capacity - len < 2) {
+			const size_t newCapacity = (*capacity == 0) ? 256 : *capacity * 2;
+			char * const newBuffer = realloc(*buffer, newCapacity);
+			if (newBuffer == NULL) {
+				return READ_LINE_NO_MEMORY;
+			}
+			*buffer = newBuffer;
+			*capacity = newCapacity;
+		}
+
+		if (fgets(*buffer + len, (int)(*capacity - len), input) == NULL) {
+			if (len == 0) {
+				return READ_LINE_END;
+			}
+			break;
+		}
+		chunkLen = strlen(*buffer + len);
+		len += chunkLen;
+		if ((len > 0) && ((*buffer)[len - 1] == '\n')) {
+			len--;
+			break;
+		}
+	}
+
+	if ((len > 0) && ((*buffer)[len - 1] == '\r')) {
+		len--;
+	}
+	(*buffer)[len] = '\0';
+	return (long)len;
+}
+
+
+static int parseFields(BatchOptions * options, const char * list) {
+	options->fieldCount = 0;
+	while (*list != '\0') {
+		const char * const comma = strchr(list, ',');
+		const size_t len = (comma != NULL) ? (size_t)(comma - list) : strlen(list);
+		int field = 0;
+
+		for (; field < FIELD_COUNT; field++) {
+			if ((strlen(fieldNames[field]) == len)
+					&& (strncmp(fieldNames[field], list, len) == 0)) {
+				break;
+			}
+		}
+		if ((field == FIELD_COUNT) || (options->fieldCount == FIELD_COUNT)) {
+			fprintf(stderr, "uriparse: Unknown field \"%.*s\"\n", (int)len, list);
+			return 0;
+		}
+		options->fields[options->fieldCount++] = (Field)field;
+
+		list += len;
+		if (*list == ',') {
+			list++;
+		}
+	}
+	return 1;
+}
+
+
+static void writePath(FILE * output, const UriUriA * uri) {
+	UriPathIteratorA iterator;
+	const UriTextRangeA * walker;
+	int first = 1;
+
+	if ((uri->absolutePath == URI_TRUE)
+			|| ((uri->hostText.first != NULL) && (uri->pathHead != NULL))) {
+		fputc('/', output);
+	}
+	uriPathIteratorBeginA(&iterator, uri);
+	while ((walker = uriPathIteratorNextA(&iterator)) != NULL) {
+		if (!first) {
+			fputc('/', output);
+		}
+		fwrite(walker->first, 1, walker->afterLast - walker->first, output);
+		first = 0;
+	}
+}
+
+
+static void writeField(FILE * output, const UriUriA * uri, Field field) {
+	const UriTextRangeA * range = NULL;
+
+	switch (field) {
+	case FIELD_SCHEME: range = &(uri->scheme); break;
+	case FIELD_USERINFO: range = &(uri->userInfo); break;
+	case FIELD_HOST: range = &(uri->hostText); break;
+	case FIELD_PORT: range = &(uri->portText); break;
+	case FIELD_QUERY: range = &(uri->query); break;
+	case FIELD_FRAGMENT: range = &(uri->fragment); break;
+	case FIELD_PATH:
+	default:
+		writePath(output, uri);
+		return;
+	}
+
+	if (range->first != NULL) {
+		fwrite(range->first, 1, range->afterLast - range->first, output);
+	}
+}
+
+
+/*
+ * Writes unescaped text, which, unlike URI text,
+ * can contain anything, to either format
+ */
+static void writeText(FILE * output, const char * text, Format format) {
+	for (; *text != '\0'; text++) {
+		const unsigned char c = (unsigned char)*text;
+		switch (c) {
+		case '\t': fputs("\\t", output); break;
+		case '\n': fputs("\\n", output); break;
+		case '\r': fputs("\\r", output); break;
+		case '\\': fputs("\\\\", output); break;
+		case '"':
+			fputs((format == FORMAT_JSON) ? "\\\"" : "\"", output);
+			break;
+		default:
+			if ((c < 0x20) && (format == FORMAT_JSON)) {
+				fprintf(output, "\\u%04x", c);
+			} else {
+				fputc(c, output);
+			}
+			break;
+		}
+	}
+}
+
+
+/*
+ * NOTE: Valid URIs contain neither tabs, line breaks, quotes
+ *       nor backslashes, so fields need no escaping in either format.
+ */
+static void writeRecord(FILE * output, const UriUriA * uri,
+		const BatchOptions * options) {
+	int i = 0;
+
+	if (options->format == FORMAT_JSON) {
+		fputc('{', output);
+		for (; i < options->fieldCount; i++) {
+			fprintf(output, "%s\"%s\":\"", (i > 0) ? "," : "",
+					fieldNames[options->fields[i]]);
+			writeField(output, uri, options->fields[i]);
+			fputc('"', output);
+		}
+		fputs("}\n", output);
+	} else {
+		for (; i < options->fieldCount; i++) {
+			if (i > 0) {
+				fputc('\t', output);
+			}
+			writeField(output, uri, options->fields[i]);
+		}
+		fputc('\n', output);
+	}
+}
+
+
+static int writeUri(FILE * output, BatchState * state, const UriUriA * uri) {
+	int charsRequired;
+	int res = uriToStringCharsRequiredA(uri, &charsRequired);
+	if (res != URI_SUCCESS) {
+		return res;
+	}
+
+	if ((size_t)charsRequired + 1 > state->textCapacity) {
+		char * const text = realloc(state->text, (size_t)charsRequired + 1);
+		if (text == NULL) {
+			return URI_ERROR_MALLOC;
+		}
+		state->text = text;
+		state->textCapacity = (size_t)charsRequired + 1;
+	}
+
+	res = uriToStringA(state->text, uri, charsRequired + 1, NULL);
+	if (res != URI_SUCCESS) {
+		return res;
+	}
+
+	if (output != NULL) {
+		if (state->options->format == FORMAT_JSON) {
+			fprintf(output, "{\"uri\":\"%s\"}\n", state->text);
+		} else {
+			fprintf(output, "%s\n", state->text);
+		}
+	}
+	return URI_SUCCESS;
+}
+
+
+static void writeQuery(FILE * output, const UriQueryListA * queryList,
+		Format format) {
+	if (format == FORMAT_JSON) {
+		fputc('[', output);
+		for (; queryList != NULL; queryList = queryList->next) {
+			fputs("{\"key\":\"", output);
+			writeText(output, queryList->key, format);
+			if (queryList->value != NULL) {
+				fputs("\",\"value\":\"", output);
+				writeText(output, queryList->value, format);
+				fputs("\"}", output);
+			} else {
+				fputs("\",\"value\":null}", output);
+			}
+			if (queryList->next != NULL) {
+				fputc(',', output);
+			}
+		}
+		fputs("]\n", output);
+	} else {
+		for (; queryList != NULL; queryList = queryList->next) {
+			writeText(output, queryList->key, format);
+			if (queryList->value != NULL) {
+				fputc('=', output);
+				writeText(output, queryList->value, format);
+			}
+			if (queryList->next != NULL) {
+				fputc('\t', output);
+			}
+		}
+		fputc('\n', output);
+	}
+}
+
+
+/*
+ * Runs the command on a single URI. Output can be NULL
+ * to only do the work. On syntax errors, errorPos is set.
+ */
+static int processUri(FILE * output, BatchState * state,
+		const char * first, const char * afterLast,
+		const char ** errorPos) {
+	const BatchOptions * const options = state->options;
+	UriUriA uri;
+	int res;
+
+	res = uriParseSingleUriExMmA(&uri, first, afterLast, errorPos,
+			&(state->memory));
+	if (res != URI_SUCCESS) {
+		return res;
+	}
+
+	switch (options->command) {
+	case COMMAND_NORMALIZE:
+		{
+			unsigned int mask = URI_NORMALIZED;
+			res = uriNormalizeSyntaxMaskRequiredExA(&uri, &mask);
+			if ((res == URI_SUCCESS) && (mask != URI_NORMALIZED)) {
+				res = uriNormalizeSyntaxExMmA(&uri, mask, &(state->memory));
+			}
+			if (res == URI_SUCCESS) {
+				res = writeUri(output, state, &uri);
+			}
+		}
+		break;
+
+	case COMMAND_RESOLVE:
+	case COMMAND_RELATIVIZE:
+		{
+			UriUriA dest;
+			if (options->command == COMMAND_RESOLVE) {
+				res = uriAddBaseUriExMmA(&dest, &uri, &(state->base),
+						URI_RESOLVE_STRICTLY, &(state->memory));
+			} else {
+				res = uriRemoveBaseUriMmA(&dest, &uri, &(state->base),
+						URI_FALSE, &(state->memory));
+			}
+			if (res == URI_SUCCESS) {
+				res = writeUri(output, state, &dest);
+				uriFreeUriMembersMmA(&dest, &(state->memory));
+			}
+		}
+		break;
+
+	case COMMAND_QUERY:
+		{
+			UriQueryListA * queryList = NULL;
+			/* No query at all makes an empty record */
+			if (uri.query.first != NULL) {
+				res = uriDissectQueryMallocExMmA(&queryList, NULL,
+						uri.query.first, uri.query.afterLast,
+						URI_TRUE, URI_BR_DONT_TOUCH, &(state->memory));
+			}
+			if ((res == URI_SUCCESS) && (output != NULL)) {
+				writeQuery(output, queryList, options->format);
+			}
+			uriFreeQueryListMmA(queryList, &(state->memory));
+		}
+		break;
+
+	case COMMAND_VALIDATE:
+		if (output != NULL) {
+			fputs((options->format == FORMAT_JSON)
+					? "{\"valid\":true}\n" : "valid\n", output);
+		}
+		break;
+
+	case COMMAND_PARSE:
+	default:
+		if (output != NULL) {
+			writeRecord(output, &uri, options);
+		}
+		break;
+	}
+
+	uriFreeUriMembersMmA(&uri, &(state->memory));
+	return res;
+}
+
+
+static void writeFailure(FILE * output, const BatchOptions * options,
+		unsigned long lineNumber, int errorCode, long column) {
+	if (options->format == FORMAT_JSON) {
+		if (errorCode == URI_ERROR_SYNTAX) {
+			fprintf(output, "{\"%s\":false,\"line\":%lu,\"column\":%ld}\n",
+					(options->command == COMMAND_VALIDATE) ? "valid" : "error",
+					lineNumber, column);
+		} else {
+			fprintf(output, "{\"error\":%d,\"line\":%lu}\n",
+					errorCode, lineNumber);
+		}
+		return;
+	}
+
+	if (options->command == COMMAND_VALIDATE) {
+		fprintf(output, "invalid\t%ld\n", column);
+	} else {
+		int i = 1;
+		if (options->command == COMMAND_PARSE) {
+			for (; i < options->fieldCount; i++) {
+				fputc('\t', output);
+			}
+		}
+		fputc('\n', output);
+	}
+
+	if (errorCode == URI_ERROR_SYNTAX) {
+		fprintf(stderr, "uriparse: Line %lu: Syntax error at column %ld\n",
+				lineNumber, column);
+	} else {
+		fprintf(stderr, "uriparse: Line %lu: Error %d\n",
+				lineNumber, errorCode);
+	}
+}
+
+
+static int initBatchState(BatchState * state, const BatchOptions * options) {
+	state->options = options;
+	state->text = NULL;
+	state->textCapacity = 0;
+	state->allocationStats.allocations = 0;
+	state->allocationStats.frees = 0;
+	state->libraryStats.allocations = 0;
+	state->libraryStats.frees = 0;
+
+	state->countingMemory.malloc = countingMalloc;
+	state->countingMemory.calloc = countingCalloc;
+	state->countingMemory.realloc = countingRealloc;
+	state->countingMemory.reallocarray = uriEmulateReallocarray;
+	state->countingMemory.free = countingFree;
+	state->countingMemory.userData = &(state->allocationStats);
+
+	if (uriCreateParserContext(&(state->context),
+			&(state->countingMemory)) != URI_SUCCESS) {
+		fprintf(stderr, "uriparse: Out of memory\n");
+		return 0;
+	}
+	state->contextMemory = uriGetParserContextMemoryManager(state->context);
+	state->memory.malloc = frontMalloc;
+	state->memory.calloc = frontCalloc;
+	state->memory.realloc = frontRealloc;
+	state->memory.reallocarray = frontReallocarray;
+	state->memory.free = frontFree;
+	state->memory.userData = state;
+
+	if ((options->command == COMMAND_RESOLVE)
+			|| (options->command == COMMAND_RELATIVIZE)) {
+		if (options->baseText == NULL) {
+			fprintf(stderr, "uriparse: Command \"%s\" needs --base=URI\n",
+					commandNames[options->command]);
+			uriFreeParserContext(state->context);
+			return 0;
+		}
+		if ((uriParseSingleUriContextA(&(state->base), options->baseText,
+				NULL, NULL, state->context) != URI_SUCCESS)
+				|| (state->base.scheme.first == NULL)) {
+			fprintf(stderr, "uriparse: Base \"%s\" is not an absolute URI\n",
+					options->baseText);
+			uriFreeUriMembersContextA(&(state->base), state->context);
+			uriFreeParserContext(state->context);
+			return 0;
+		}
+	}
+	return 1;
+}
+
+
+static void freeBatchState(BatchState * state) {
+	const Command command = state->options->command;
+	if ((command == COMMAND_RESOLVE) || (command == COMMAND_RELATIVIZE)) {
+		uriFreeUriMembersContextA(&(state->base), state->context);
+	}
+	uriFreeParserContext(state->context);
+	free(state->text);
+}
+
+
+static int runBatch(FILE * input, const BatchOptions * options) {
+	int retval = EXIT_SUCCESS;
+	BatchState state;
+	char * line = NULL;
+	size_t capacity = 0;
+	unsigned long lineNumber = 0;
+	unsigned long failureCount = 0;
+	double byteCount = 0;
+	double seconds;
+	clock_t start;
+	long len;
+
+	if (! initBatchState(&state, options)) {
+		return EXIT_FAILURE;
+	}
+
+	start = clock();
+	while ((len = readLine(input, &line, &capacity)) >= 0) {
+		const char * errorPos = NULL;
+		int res;
+
+		lineNumber++;
+		byteCount += len + 1;
+		res = processUri(stdout, &state, line, line + len, &errorPos);
+		if (res == URI_ERROR_MALLOC) {
+			fprintf(stderr, "uriparse: Out of memory\n");
+			retval = EXIT_FAILURE;
+			break;
+		} else if (res != URI_SUCCESS) {
+			writeFailure(stdout, options, lineNumber, res,
+					(res == URI_ERROR_SYNTAX) ? (long)(errorPos - line) + 1 : 0);
+			failureCount++;
+			retval = EXIT_FAILURE;
+		}
+	}
+	if (len == READ_LINE_NO_MEMORY) {
+		fprintf(stderr, "uriparse: Out of memory\n");
+		retval = EXIT_FAILURE;
+	}
+
+	if (fflush(stdout) != 0) {
+		retval = EXIT_FAILURE;
+	}
+
+	/* Frees are only complete once the parser context is gone */
+	seconds = (double)(clock() - start) / CLOCKS_PER_SEC;
+	free(line);
+	freeBatchState(&state);
+
+	if (options->stats) {
+		const double divisor = (seconds > 0) ? seconds : 1e-9;
+		fprintf(stderr, "uriparse: %lu lines, %lu failed, %.0f bytes"
+				" in %.3f CPU seconds\n",
+				lineNumber, failureCount, byteCount, seconds);
+		fprintf(stderr, "uriparse: %.0f lines/s, %.2f MB/s\n",
+				lineNumber / divisor, byteCount / divisor / 1e6);
+		fprintf(stderr, "uriparse: Library calls: %lu allocations"
+				" (%.2f per line), %lu frees\n",
+				state.libraryStats.allocations,
+				(lineNumber > 0)
+					? (double)state.libraryStats.allocations / lineNumber
+					: 0.0,
+				state.libraryStats.frees);
+		fprintf(stderr, "uriparse: Reaching libc past the context's cache:"
+				" %lu allocations (%.2f per line), %lu frees\n",
+				state.allocationStats.allocations,
+				(lineNumber > 0)
+					? (double)state.allocationStats.allocations / lineNumber
+					: 0.0,
+				state.allocationStats.frees);
+	}
+
+	return retval;
+}
+
+
+/*
+ * Returns a timestamp in seconds, of the best
+ * resolution available on the platform
+ */
+static double nowSeconds(void) {
+#if defined(_WIN32)
+	LARGE_INTEGER frequency;
+	LARGE_INTEGER counter;
+	QueryPerformanceFrequency(&frequency);
+	QueryPerformanceCounter(&counter);
+	return (double)counter.QuadPart / (double)frequency.QuadPart;
+#elif defined(CLOCK_MONOTONIC)
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (double)now.tv_sec + (double)now.tv_nsec / 1e9;
+#else
+	return (double)clock() / CLOCKS_PER_SEC;
+#endif
+}
+
+
+static int compareDoubles(const void * a, const void * b) {
+	const double left = *(const double *)a;
+	const double right = *(const double *)b;
+	return (left < right) ? -1 : (left > right) ? 1 : 0;
+}
+
+
+static int loadCorpus(FILE * input, Corpus * corpus) {
+	char * line = NULL;
+	size_t capacity = 0;
+	long len;
+	int success = 1;
+
+	corpus->text = NULL;
+	corpus->textSize = 0;
+	corpus->textCapacity = 0;
+	corpus->lineCount = 0;
+	corpus->lineCapacity = 16;
+	corpus->lineStarts = malloc(corpus->lineCapacity * sizeof(size_t));
+	if (corpus->lineStarts == NULL) {
+		return 0;
+	}
+	corpus->lineStarts[0] = 0;
+
+	while (success && ((len = readLine(input, &line, &capacity)) >= 0)) {
+		if (corpus->textSize + len + 1 > corpus->textCapacity) {
+			size_t newCapacity = (corpus->textCapacity == 0)
+					? 4096 : corpus->textCapacity * 2;
+			char * newText;
+			while (corpus->textSize + len + 1 > newCapacity) {
+				newCapacity *= 2;
+			}
+			newText = realloc(corpus->text, newCapacity);
+			if (newText == NULL) {
+				success = 0;
+				break;
+			}
+			corpus->text = newText;
+			corpus->textCapacity = newCapacity;
+		}
+		if (corpus->lineCount + 2 > corpus->lineCapacity) {
+			size_t * const newLineStarts = realloc(corpus->lineStarts,
+					corpus->lineCapacity * 2 * sizeof(size_t));
+			if (newLineStarts == NULL) {
+				success = 0;
+				break;
+			}
+			corpus->lineStarts = newLineStarts;
+			corpus->lineCapacity *= 2;
+		}
+
+		memcpy(corpus->text + corpus->textSize, line, (size_t)len + 1);
+		corpus->textSize += len + 1;
+		corpus->lineStarts[++corpus->lineCount] = corpus->textSize;
+	}
+	if (len == READ_LINE_NO_MEMORY) {
+		success = 0;
+	}
+
+	free(line);
+	return success;
+}
+
+
+static void freeCorpus(Corpus * corpus) {
+	free(corpus->text);
+	free(corpus->lineStarts);
+}
+
+
+/*
+ * Runs the command over the whole corpus, repeatedly. Single
+ * operations are timed for a sample of at most BENCH_SAMPLES_MAX,
+ * spread evenly; throughput is timed over all of them.
+ */
+static int runBench(FILE * input, const BatchOptions * options) {
+	int retval = EXIT_SUCCESS;
+	BatchState state;
+	Corpus corpus;
+	double * samples;
+	double operationCount;
+	unsigned long stride;
+	unsigned long sampleCount = 0;
+	unsigned long failureCount = 0;
+	unsigned long allocationsBefore;
+	unsigned long libraryAllocationsBefore;
+	unsigned long operation = 0;
+	unsigned long round = 0;
+	double seconds;
+	double start;
+
+	if (! loadCorpus(input, &corpus)) {
+		fprintf(stderr, "uriparse: Out of memory\n");
+		freeCorpus(&corpus);
+		return EXIT_FAILURE;
+	}
+	if (corpus.lineCount == 0) {
+		fprintf(stderr, "uriparse: No input to benchmark\n");
+		freeCorpus(&corpus);
+		return EXIT_FAILURE;
+	}
+
+	operationCount = (double)corpus.lineCount * options->benchRounds;
+	stride = (unsigned long)(operationCount / BENCH_SAMPLES_MAX) + 1;
+	samples = malloc((size_t)(operationCount / stride + 1) * sizeof(double));
+	if ((samples == NULL) || ! initBatchState(&state, options)) {
+		free(samples);
+		freeCorpus(&corpus);
+		return EXIT_FAILURE;
+	}
+
+	allocationsBefore = state.allocationStats.allocations;
+	libraryAllocationsBefore = state.libraryStats.allocations;
+	start = nowSeconds();
+	for (; round < options->benchRounds; round++) {
+		size_t i = 0;
+		for (; i < corpus.lineCount; i++, operation++) {
+			const char * const first = corpus.text + corpus.lineStarts[i];
+			const char * const afterLast = corpus.text
+					+ corpus.lineStarts[i + 1] - 1;
+			int res;
+
+			if (operation % stride == 0) {
+				const double operationStart = nowSeconds();
+				res = processUri(NULL, &state, first, afterLast, NULL);
+				samples[sampleCount++] = nowSeconds() - operationStart;
+			} else {
+				res = processUri(NULL, &state, first, afterLast, NULL);
+			}
+
+			if (res == URI_ERROR_MALLOC) {
+				fprintf(stderr, "uriparse: Out of memory\n");
+				retval = EXIT_FAILURE;
+				break;
+			} else if (res != URI_SUCCESS) {
+				failureCount++;
+			}
+		}
+		if (retval != EXIT_SUCCESS) {
+			break;
+		}
+	}
+	seconds = nowSeconds() - start;
+	if (seconds <= 0) {
+		seconds = 1e-9;
+	}
+
+	if (retval == EXIT_SUCCESS) {
+		qsort(samples, sampleCount, sizeof(double), compareDoubles);
+		printf("command:      %s\n", commandNames[options->command]);
+		printf("operations:   %lu (%lu URIs x %lu rounds), %lu failed\n",
+				operation, (unsigned long)corpus.lineCount,
+				options->benchRounds, failureCount);
+		printf("time:         %.3f s\n", seconds);
+		printf("throughput:   %.0f ops/s, %.2f MB/s\n",
+				operation / seconds,
+				(double)corpus.textSize * options->benchRounds / seconds / 1e6);
+#ifdef HAVE_PRECISE_CLOCK
+		printf("ns/op:        p50 %.0f, p90 %.0f, p99 %.0f, max %.0f"
+				" (%lu samples)\n",
+				samples[sampleCount / 2] * 1e9,
+				samples[sampleCount * 9 / 10] * 1e9,
+				samples[sampleCount * 99 / 100] * 1e9,
+				samples[sampleCount - 1] * 1e9,
+				sampleCount);
+#else
+		fprintf(stderr, "uriparse: Warning: Only clock() is available,"
+				" too coarse for ns/op percentiles\n");
+#endif
+		printf("allocations:  %.3f per op (%lu in total) by the library\n",
+				(state.libraryStats.allocations - libraryAllocationsBefore)
+					/ (double)operation,
+				state.libraryStats.allocations - libraryAllocationsBefore);
+		printf("              %.3f per op (%lu in total) reaching libc\n",
+				(state.allocationStats.allocations - allocationsBefore)
+					/ (double)operation,
+				state.allocationStats.allocations - allocationsBefore);
+	}
+
+	free(samples);
+	freeCorpus(&corpus);
+	freeBatchState(&state);
+	return retval;
+}
+
+
+static int mainBatch(Command command, int argc, char *argv[]) {
+	BatchOptions options;
+	const char * fileName = NULL;
+	FILE * input = stdin;
+	int retval;
+	int i = 0;
+
+	options.command = command;
+	options.format = FORMAT_TSV;
+	for (; i < FIELD_COUNT; i++) {
+		options.fields[i] = (Field)i;
+	}
+	options.fieldCount = FIELD_COUNT;
+	options.baseText = NULL;
+	options.stats = 0;
+	options.benchRounds = 0;
+
+	for (i = 2; i < argc; i++) {
+		if (strcmp(argv[i], "--format=tsv") == 0) {
+			options.format = FORMAT_TSV;
+		} else if (strcmp(argv[i], "--format=json") == 0) {
+			options.format = FORMAT_JSON;
+		} else if ((strncmp(argv[i], "--fields=", 9) == 0)
+				&& (command == COMMAND_PARSE)) {
+			if (! parseFields(&options, argv[i] + 9)) {
+				return EXIT_FAILURE;
+			}
+		} else if (strncmp(argv[i], "--base=", 7) == 0) {
+			options.baseText = argv[i] + 7;
+		} else if (strcmp(argv[i], "--stats") == 0) {
+			options.stats = 1;
+		} else if (strcmp(argv[i], "--bench") == 0) {
+			options.benchRounds = BENCH_ROUNDS_DEFAULT;
+		} else if (strncmp(argv[i], "--bench=", 8) == 0) {
+			options.benchRounds = strtoul(argv[i] + 8, NULL, 10);
+			if (options.benchRounds == 0) {
+				usage();
+				return EXIT_FAILURE;
+			}
+		} else if ((fileName == NULL) && ((argv[i][0] != '-')
+				|| (strcmp(argv[i], "-") == 0))) {
+			fileName = argv[i];
+		} else {
+			usage();
+			return EXIT_FAILURE;
+		}
+	}
+
+	if ((fileName != NULL) && (strcmp(fileName, "-") != 0)) {
+		input = fopen(fileName, "r");
+		if (input == NULL) {
+			fprintf(stderr, "uriparse: Cannot open \"%s\"\n", fileName);
+			return EXIT_FAILURE;
+		}
+	}
+
+	if (options.benchRounds > 0) {
+		retval = runBench(input, &options);
+	} else {
+		setvbuf(stdout, NULL, _IOFBF, OUTPUT_BUFFER_SIZE);
+		retval = runBatch(input, &options);
+	}
+
+	if (input != stdin) {
+		fclose(input);
+	}
+	return retval;
 }
 
 
@@ -71,7 +1025,16 @@ int main(int argc, char *argv[]) {
 		exit(1);
 	}
 
-	for (; i < argc; i++) {
+	if (strcmp(argv[1], "--batch") == 0) {
+		return mainBatch(COMMAND_PARSE, argc, argv);
+	}
+	for (i = 0; i < COMMAND_COUNT; i++) {
+		if (strcmp(argv[1], commandNames[i]) == 0) {
+			return mainBatch((Command)i, argc, argv);
+		}
+	}
+
+	for (i = 1; i < argc; i++) {
 		UriParserStateA state;
 		UriUriA uri;
 		char ipstr[INET6_ADDRSTRLEN];
@@ -111,9 +1074,11 @@ int main(int argc, char *argv[]) {
 				printf("portText:     %.*s\n", RANGE(uri.portText));
 			}
 			if (uri.pathHead) {
-				const UriPathSegmentA * p = uri.pathHead;
-				for (; p; p = p->next) {
-					printf(" .. pathSeg:  %.*s\n", RANGE(p->text));
+				UriPathIteratorA iterator;
+				const UriTextRangeA * p;
+				uriPathIteratorBeginA(&iterator, &uri);
+				while ((p = uriPathIteratorNextA(&iterator)) != NULL) {
+					printf(" .. pathSeg:  %.*s\n", RANGE(*p));
 				}
 			}
 			if (uri.query.first) {